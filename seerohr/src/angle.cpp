@@ -3,16 +3,11 @@
 
 // c++ headers ------------------------------------------
 #include <cmath>
-#include <cstdarg>
 
 #include <numbers>
 
-// project headers --------------------------------------
-#include "raylib_widgets.h"
-#include "widgets.h"
-
 Angle Angle::FromDeg(float deg) {
-  return Angle(deg * DEG2RAD);
+  return Angle(deg * (std::numbers::pi_v<float> / 180.0f));
 }
 Angle Angle::RightAngle() {
   return Angle(std::numbers::pi_v<float> *0.5f);
@@ -36,31 +31,9 @@ Angle Angle::WrapAround() const {
 }
 
 float Angle::ToDeg() const {
-  return rad_ * RAD2DEG;
+  return rad_ * (180.0f / std::numbers::pi_v<float>);
 }
 
 float Angle::Sin() const { return std::sin(rad_); }
 float Angle::Cos() const { return std::cos(rad_); }
 float Angle::Tan() const { return std::tan(rad_); }
-
-bool Angle::ImGuiSliderDeg(char const* label, float min_deg, float max_deg, char const* format) {
-  float deg = this->ToDeg();
-  if (ImGui::SliderFloat(label, &deg, min_deg, max_deg, format)) {
-    rad_ = deg * DEG2RAD;
-    return true;
-  }
-  return false;
-}
-
-bool Angle::ImGuiSliderDegWithId(char const* str_id, float min_deg, float max_deg, char const* value_format, char const* label_format, ...) {
-  va_list args;
-  va_start(args, label_format);
-
-  float deg = this->ToDeg();
-  bool changed = SliderFloatWithIdV(str_id, &deg, min_deg, max_deg, value_format, ImGuiSliderFlags_None, label_format, args);
-  if (changed) {
-    rad_ = deg * DEG2RAD;
-  }
-  va_end(args);
-  return changed;
-}
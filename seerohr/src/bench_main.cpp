@@ -0,0 +1,1609 @@
+// c++ headers ------------------------------------------
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <limits>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// project headers --------------------------------------
+#include "job_system.h"
+#include "numerical.h"
+#include "tdc2_async.h"
+#include "tdc2_batch.h"
+#include "tdc2_convoy.h"
+#include "tdc2_epf.h"
+#include "tdc2_fleet.h"
+#include "tdc2_graph.h"
+#include "tdc2_kernels.h"
+#include "tdc2_kinematics.h"
+#include "tdc2_planner.h"
+#include "tdc2_sim.h"
+#include "tdc2_solver.h"
+#include "tdc2_spatial.h"
+#include "tdc2_targets.h"
+#include "tool_options.h"
+
+// Micro-benchmarks of the solver kernels.
+//
+// Every kernel runs over the same fixed, seeded scenario corpora, one per regime: a general one, and ones concentrating
+// on the edge cases of the solvers. Results are written as JSON for comparison across runs, and summarized on stderr.
+//
+// Per kernel and regime:
+// - `ns_per_op`, `ops_per_s`: From timing whole passes over the corpus; the median pass counts.
+// - `p50_ns`, `p99_ns`: From timing every operation on its own, less the overhead of reading the clock.
+// - `solved`: Operations that produced a solution.
+// - `iterations_mean`, `iterations_max`: Solver iterations, or function evaluations for root finding; omitted for
+//   kernels that do not iterate.
+// - `agreement`: For the parallax engines, how their final gyro angles compare to those of `parallax_geometry`.
+//   Along with the timings this shows which engine to keep for which regime.
+// - `max_rel_error`: For the torpedo triangle in float and in mixed precision, the largest relative error of the torpedo
+//   run distance against double precision.
+//
+// `torpedo_kinematics_step` times a step of the torpedoes of every solved scenario, each set to its parallax solution.
+// The torpedoes are then run to their targets, and the equivalent point of fire and impact position they imply are
+// checked against the closed-form model of the parallax correction; the largest errors go to stderr.
+//
+// `triangle_block_*` and `parallax_block_*` time blocks of 64 scenarios through the scalar solvers and through the batch
+// solvers, with and without the equivalent point of fire curve; an operation is a block. The speedup goes to stderr.
+//
+// Before any kernel runs, the parallax run distance at AoB exactly 0 and 180° is checked against AoB 0.001° off, for
+// every engine, scalar and batched, with and without the equivalent point of fire curve. The largest relative
+// differences go to stderr, and the benchmark fails if they are not small.
+//
+// Then, per regime, every lane of the batch solvers is checked against the scalar solvers, with and without the curve.
+// Mismatched lanes and the largest difference in ULP go to stderr, and the benchmark fails on any mismatch.
+//
+// `tdc_targets_solve` times a tick of the multi-target TDC: Solving a `TargetTable` of up to 1000 of the scenarios,
+// their bearings drifting a little from tick to tick; `tdc_targets_solve_jobs` the same on a `JobSystem` of all
+// hardware threads. `fleet_matrix_solve` times a tick of 50 ownships against 500 of the scenarios as contacts, moving
+// at their speeds, on a `JobSystem` of all hardware threads. `firing_plan` times a plan of 4096 launch times over 10
+// minutes against each of the first 64 scenarios, the ownship making 6 kn, on the same. `course_sweep` times a sweep of
+// 3600 ownship courses against each of the first 64 scenarios; `course_sweep_drift` times sweeps against the first
+// scenario's target as it moves on, each starting from the last.
+//
+// `convoy_solve` runs on generated convoys rather than the corpus, in regimes `convoy_1` to `convoy_100000` by ship
+// count. It times a tick of the multi-target TDC with every ship of the convoy as a target, observed afresh as the convoy
+// zig-zags; the time to generate the convoy and the memory held per target go to stderr. `spatial_grid_update` and
+// `spatial_grid_rebuild` time keeping a `SpatialGrid` over the convoy as it moves, and building one from scratch;
+// `spatial_grid_pick` times finding the ship nearest to a point.
+
+namespace {
+
+constexpr float kDegToRad = std::numbers::pi_v<float> / 180.0f;
+
+using Clock = std::chrono::steady_clock;
+
+struct Options final {
+  char const* output_path = nullptr; // Null: stdout.
+  uint32_t seed = 1;
+  uint32_t sample_count = 4096;      // Scenarios per regime.
+  uint32_t repeat_count = 16;        // Timed passes per kernel and regime, for each of the two timings.
+  char const* kernel_filter = nullptr;
+  char const* regime_filter = nullptr;
+  tdc2::TorpedoSpec torpedo_spec = tdc2::GetTorpedoPresetSpec(tdc2::TorpedoPreset::kG7e);
+};
+
+void PrintUsage() {
+  std::fprintf(
+    stderr,
+    "Usage: seerohr_bench [options]\n"
+    "\n"
+    "Options:\n"
+    "  --out <path>           JSON output file. Default: stdout\n"
+    "  --seed <n>             Corpus seed. Default: 1\n"
+    "  --samples <n>          Scenarios per regime. Default: 4096\n"
+    "  --repeats <n>          Timed passes per kernel and regime. Default: 16\n"
+    "  --kernel <substring>   Only run kernels whose name contains <substring>.\n"
+    "  --regime <substring>   Only run regimes whose name contains <substring>.\n"
+    "  --torpedo <g7a|g7e>    Torpedo preset. Default: g7e\n"
+  );
+}
+
+std::optional<Options> ParseOptions(int argc, char** argv) {
+  Options options;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string_view const arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      return std::nullopt;
+    }
+    if (i + 1 >= argc) {
+      std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+      return std::nullopt;
+    }
+    char const* value = argv[++i];
+    std::string_view const value_sv = value;
+
+    bool ok = true;
+    if (arg == "--out") {
+      options.output_path = value;
+    }
+    else if (arg == "--seed" || arg == "--samples" || arg == "--repeats") {
+      std::optional<uint32_t> const parsed = tool_options::ParseUInt32(value_sv);
+      ok = parsed.has_value() && (arg == "--seed" || parsed.value() > 0);
+      if (ok) {
+        uint32_t& field = (arg == "--seed") ? options.seed : (arg == "--samples") ? options.sample_count : options.repeat_count;
+        field = parsed.value();
+      }
+    }
+    else if (arg == "--kernel") {
+      options.kernel_filter = value;
+    }
+    else if (arg == "--regime") {
+      options.regime_filter = value;
+    }
+    else if (arg == "--torpedo") {
+      std::optional<tdc2::TorpedoSpec> const torpedo_spec = tool_options::ParseTorpedoPreset(value_sv);
+      ok = torpedo_spec.has_value();
+      if (ok) {
+        options.torpedo_spec = torpedo_spec.value();
+      }
+    }
+    else {
+      std::fprintf(stderr, "Unknown option: %s\n", argv[i - 1]);
+      return std::nullopt;
+    }
+
+    if (!ok) {
+      std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], value);
+      return std::nullopt;
+    }
+  }
+
+  return options;
+}
+
+//
+// Corpora.
+//
+
+/// Scenarios of one regime. Everything downstream of the torpedo triangle only covers scenarios the triangle solves.
+struct Corpus final {
+  char const* regime = nullptr;
+
+  std::vector<tdc2::TorpedoTriangle> triangles;
+  std::vector<tdc2::TorpedoTriangleIntermediate> interms;
+  std::vector<Angle> ownship_courses;
+
+  // Scenarios with a triangle solution.
+  std::vector<tdc2::TorpedoTriangle> solved_triangles;
+  std::vector<float> solved_ownship_courses;
+  std::vector<float> pseudo_gyro_angles;
+};
+
+enum class Regime {
+  kGeneral,
+  kAngleOnBowNear0Or180,
+  kSinLeadAngleNear1,
+  kLargeGyroAngle,
+};
+
+char const* GetRegimeName(Regime regime) {
+  switch (regime) {
+  case Regime::kGeneral:              return "general";
+  case Regime::kAngleOnBowNear0Or180: return "aob_near_0_180";
+  case Regime::kSinLeadAngleNear1:    return "sin_lead_near_1";
+  case Regime::kLargeGyroAngle:       return "large_gyro";
+  }
+  return "";
+}
+
+/// Uniform in [`min`, `max`). Unlike `std::uniform_real_distribution`, gives the same sequence with every standard library.
+float GetUniform(std::mt19937& rng, float min, float max) {
+  return min + (max - min) * (static_cast<float>(rng() >> 8) * 0x1p-24f);
+}
+
+tdc2::TorpedoTriangle MakeScenario(Regime regime, float torpedo_speed_kn, std::mt19937& rng) {
+  auto uniform = [&rng](float min, float max) { return GetUniform(rng, min, max); };
+  auto random_sign = [&rng]() { return (rng() & 1) ? 1.0f : -1.0f; };
+
+  float bearing_deg = uniform(-180.0f, 180.0f);
+  float range_m = uniform(300.0f, 4000.0f);
+  float target_speed_kn = uniform(0.0f, 30.0f);
+  float aob_deg = uniform(-180.0f, 180.0f);
+
+  switch (regime) {
+  case Regime::kGeneral:
+    break;
+  case Regime::kAngleOnBowNear0Or180:
+    // Exactly 0/180° for the dedicated branch of the solver a quarter of the time; within a degree of them otherwise.
+    target_speed_kn = uniform(0.0f, torpedo_speed_kn * 0.9f);
+    switch (rng() % 4) {
+    case 0:  aob_deg = (rng() & 1) ? 0.0f : 180.0f; break;
+    case 1:  aob_deg = random_sign() * uniform(0.0f, 1.0f); break;
+    default: aob_deg = random_sign() * uniform(179.0f, 180.0f); break;
+    }
+    break;
+  case Regime::kSinLeadAngleNear1:
+    // sin(lead angle) = target speed / torpedo speed * sin|AoB| in [0.98, 1].
+    {
+      float const abs_aob_deg = uniform(45.0f, 135.0f);
+      aob_deg = random_sign() * abs_aob_deg;
+      target_speed_kn = torpedo_speed_kn * uniform(0.98f, 1.0f) / std::sin(abs_aob_deg * kDegToRad);
+    }
+    break;
+  case Regime::kLargeGyroAngle:
+    // Targets abaft the beam at short range.
+    bearing_deg = random_sign() * uniform(100.0f, 180.0f);
+    range_m = uniform(300.0f, 1500.0f);
+    target_speed_kn = uniform(0.0f, torpedo_speed_kn * 0.8f);
+    break;
+  }
+
+  return tdc2::TorpedoTriangle {
+    .torpedo_speed_kn = torpedo_speed_kn,
+    .target_bearing = Angle(bearing_deg * kDegToRad),
+    .target_range_m = range_m,
+    .target_speed_kn = target_speed_kn,
+    .angle_on_bow = Angle(aob_deg * kDegToRad),
+  };
+}
+
+Corpus MakeCorpus(Regime regime, Options const& options) {
+  // Seed every regime differently, but independently of which regimes are selected.
+  std::mt19937 rng(options.seed * 7919u + static_cast<uint32_t>(regime));
+
+  Corpus corpus;
+  corpus.regime = GetRegimeName(regime);
+
+  Vec2 const aiming_device_position = { 0.0f, 0.0f };
+  for (uint32_t i = 0; i < options.sample_count; ++i) {
+    tdc2::TorpedoTriangle const triangle = MakeScenario(regime, options.torpedo_spec.speed_kn, rng);
+    Angle const ownship_course = Angle(GetUniform(rng, 0.0f, 2.0f * std::numbers::pi_v<float>));
+    tdc2::TorpedoTriangleIntermediate const interm = triangle.PrepareSolve(ownship_course);
+
+    corpus.triangles.push_back(triangle);
+    corpus.interms.push_back(interm);
+    corpus.ownship_courses.push_back(ownship_course);
+
+    if (std::optional<tdc2::TorpedoTriangleSolution> const solution = triangle.Solve(interm, aiming_device_position); solution.has_value()) {
+      corpus.solved_triangles.push_back(triangle);
+      corpus.solved_ownship_courses.push_back(ownship_course.AsRad());
+      corpus.pseudo_gyro_angles.push_back(solution->pseudo_torpedo_gyro_angle.AsRad());
+    }
+  }
+
+  return corpus;
+}
+
+/// Check the parallax run distance where the triangle seen from the equivalent point of fire is collinear, at AoB
+/// exactly 0 and 180°, against AoB `kNearOffsetDeg` off either way. Returns whether every engine agrees.
+bool CheckCollinearRunDistance(Options const& options) {
+  constexpr float kNearOffsetDeg = 0.001f;
+  constexpr double kMaxRelDiff = 1e-4;
+
+  tdc2::TorpedoSpec const& torpedo_spec = options.torpedo_spec;
+  tdc2::EquivalentPointOfFireCurveCache epf_curve_cache;
+  tdc2::EquivalentPointOfFireCurve const* const epf_curve = &epf_curve_cache.Get(torpedo_spec);
+  Vec2 const aiming_device_position = { 0.0f, 0.0f };
+  Angle const ownship_course = Angle::FromDeg(30.0f);
+
+  // Pairs of an exact scenario, then one off it.
+  std::vector<tdc2::TorpedoTriangle> triangles;
+  for (float const bearing_deg : { 0.0f, 20.0f, -45.0f }) {
+    for (float const range_m : { 500.0f, 1000.0f, 3000.0f }) {
+      for (float const target_speed_kn : { 0.0f, 8.0f, 0.6f * torpedo_spec.speed_kn }) {
+        for (auto const& [aob_deg, near_aob_deg] : {
+          std::pair { 0.0f, kNearOffsetDeg }, std::pair { 0.0f, -kNearOffsetDeg },
+          std::pair { 180.0f, 180.0f - kNearOffsetDeg }, std::pair { 180.0f, kNearOffsetDeg - 180.0f },
+        }) {
+          for (float const angle_on_bow_deg : { aob_deg, near_aob_deg }) {
+            triangles.push_back(tdc2::TorpedoTriangle {
+              .torpedo_speed_kn = torpedo_spec.speed_kn,
+              .target_bearing = Angle::FromDeg(bearing_deg),
+              .target_range_m = range_m,
+              .target_speed_kn = target_speed_kn,
+              .angle_on_bow = Angle::FromDeg(angle_on_bow_deg),
+            });
+          }
+        }
+      }
+    }
+  }
+
+  bool ok = true;
+  auto check = [&](char const* engine, bool with_curve, auto&& solve_run_distance) {
+    double max_rel_diff = 0.0;
+    std::size_t mismatch_count = 0; // Pairs of which only one solved.
+    for (std::size_t i = 0; i < triangles.size(); i += 2) {
+      std::optional<float> const exact = solve_run_distance(i);
+      std::optional<float> const near = solve_run_distance(i + 1);
+      if (exact.has_value() != near.has_value()) {
+        ++mismatch_count;
+        continue;
+      }
+      if (exact.has_value()) {
+        double const rel_diff = std::abs(static_cast<double>(exact.value()) - near.value()) / std::max(std::abs(static_cast<double>(near.value())), 1.0);
+        max_rel_diff = std::max(max_rel_diff, std::isfinite(rel_diff) ? rel_diff : std::numeric_limits<double>::infinity());
+      }
+    }
+    bool const passed = mismatch_count == 0 && max_rel_diff <= kMaxRelDiff;
+    std::fprintf(
+      stderr, "collinear run distance: %-18s %-8s max relative difference %.2e, mismatches %zu%s\n",
+      engine, with_curve ? "curve" : "no curve", max_rel_diff, mismatch_count, passed ? "" : "  FAILED"
+    );
+    ok = ok && passed;
+  };
+
+  for (bool const with_curve : { false, true }) {
+    tdc2::EquivalentPointOfFireCurve const* const curve = with_curve ? epf_curve : nullptr;
+
+    for (auto const& [engine, method] : {
+      std::pair { "parallax_geometry", tdc2::ParallaxSolveMethod::kGeometry },
+      std::pair { "parallax_newton", tdc2::ParallaxSolveMethod::kNewton },
+      std::pair { "parallax_siemens", tdc2::ParallaxSolveMethod::kSiemens },
+    }) {
+      check(engine, with_curve, [&](std::size_t i) -> std::optional<float> {
+        tdc2::TorpedoTriangle const& triangle = triangles[i];
+        std::optional<tdc2::TorpedoTriangleSolution> const tri_solution = triangle.Solve(triangle.PrepareSolve(ownship_course), aiming_device_position);
+        tdc2::ParallaxCorrectionSolution solution;
+        if (!tri_solution.has_value() || !tdc2::ParallaxCorrectionSolver::Solve(
+          method, torpedo_spec, triangle, tri_solution->pseudo_torpedo_gyro_angle.AsRad(), aiming_device_position,
+          ownship_course.AsRad(), solution, curve
+        )) {
+          return std::nullopt;
+        }
+        return solution.torpedo_run_distance_m;
+      });
+    }
+
+    tdc2::TorpedoTriangleBatchInput input;
+    tdc2::TorpedoTriangleBatchOutput tri_output;
+    tdc2::ParallaxCorrectionBatchOutput pc_output;
+    input.Resize(triangles.size());
+    tri_output.Resize(triangles.size());
+    pc_output.Resize(triangles.size());
+    for (std::size_t i = 0; i < triangles.size(); ++i) {
+      input.Set(i, triangles[i], ownship_course, aiming_device_position);
+    }
+    tdc2::SolveTorpedoTriangleBatch(torpedo_spec.speed_kn, input, tri_output);
+    tdc2::SolveParallaxCorrectionBatch(torpedo_spec, input, tri_output, pc_output, curve);
+    check("parallax_batch", with_curve, [&](std::size_t i) -> std::optional<float> {
+      if (pc_output.valid[i] == 0) {
+        return std::nullopt;
+      }
+      return pc_output.torpedo_run_distance_m[i];
+    });
+  }
+  return ok;
+}
+
+/// Floats between `a` and `b`, for finite floats of the same sign; the largest value otherwise, unless both are equal.
+uint32_t GetUlpDistance(float a, float b) {
+  if (a == b) {
+    return 0;
+  }
+  if (!std::isfinite(a) || !std::isfinite(b) || std::signbit(a) != std::signbit(b)) {
+    return std::numeric_limits<uint32_t>::max();
+  }
+  uint32_t const a_bits = std::bit_cast<uint32_t>(a);
+  uint32_t const b_bits = std::bit_cast<uint32_t>(b);
+  return (a_bits < b_bits) ? (b_bits - a_bits) : (a_bits - b_bits);
+}
+
+/// Check every lane of the batch solvers against the scalar solvers, over the scenarios of `corpus`, with and without
+/// the equivalent point of fire curve. Returns whether all of them are bit-identical.
+bool CheckBatchAgreement(Corpus const& corpus, Options const& options) {
+  tdc2::TorpedoSpec const& torpedo_spec = options.torpedo_spec;
+  Vec2 const aiming_device_position = { 0.0f, 0.0f };
+  std::size_t const count = corpus.triangles.size();
+
+  tdc2::TorpedoTriangleBatchInput input;
+  tdc2::TorpedoTriangleBatchOutput tri_output;
+  tdc2::ParallaxCorrectionBatchOutput pc_output;
+  input.Resize(count);
+  tri_output.Resize(count);
+  pc_output.Resize(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    input.Set(i, corpus.triangles[i], corpus.ownship_courses[i], aiming_device_position);
+  }
+  tdc2::SolveTorpedoTriangleBatch(torpedo_spec.speed_kn, input, tri_output);
+
+  bool ok = true;
+  auto report = [&](char const* solver, bool with_curve, std::size_t mismatch_count, uint32_t max_ulp) {
+    bool const passed = mismatch_count == 0;
+    std::fprintf(
+      stderr, "batch agreement: %-16s %-18s %-8s mismatched lanes %zu/%zu, max %u ULP%s\n",
+      corpus.regime, solver, with_curve ? "curve" : "no curve", mismatch_count, count, max_ulp, passed ? "" : "  FAILED"
+    );
+    ok = ok && passed;
+  };
+
+  {
+    std::size_t mismatch_count = 0;
+    uint32_t max_ulp = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      tdc2::TorpedoTriangle const& triangle = corpus.triangles[i];
+      std::optional<tdc2::TorpedoTriangleSolution> const expected = triangle.Solve(corpus.interms[i], aiming_device_position);
+      std::optional<tdc2::TorpedoTriangleSolution> const actual = tri_output.Get(i);
+      if (expected.has_value() != actual.has_value()) {
+        ++mismatch_count;
+        continue;
+      }
+      if (!expected.has_value()) {
+        continue;
+      }
+      uint32_t ulp = 0;
+      for (auto const& [e, a] : {
+        std::pair { expected->target_course.AsRad(), actual->target_course.AsRad() },
+        std::pair { expected->lead_angle.AsRad(), actual->lead_angle.AsRad() },
+        std::pair { expected->intercept_angle.AsRad(), actual->intercept_angle.AsRad() },
+        std::pair { expected->torpedo_time_to_target_s, actual->torpedo_time_to_target_s },
+        std::pair { expected->pseudo_torpedo_gyro_angle.AsRad(), actual->pseudo_torpedo_gyro_angle.AsRad() },
+        std::pair { expected->impact_position.x, actual->impact_position.x },
+        std::pair { expected->impact_position.y, actual->impact_position.y },
+      }) {
+        ulp = std::max(ulp, GetUlpDistance(e, a));
+      }
+      mismatch_count += (ulp != 0) ? 1 : 0;
+      max_ulp = std::max(max_ulp, ulp);
+    }
+    report("triangle", false, mismatch_count, max_ulp);
+  }
+
+  tdc2::EquivalentPointOfFireCurveCache epf_curve_cache;
+  for (bool const with_curve : { false, true }) {
+    tdc2::EquivalentPointOfFireCurve const* const curve = with_curve ? &epf_curve_cache.Get(torpedo_spec) : nullptr;
+    tdc2::SolveParallaxCorrectionBatch(torpedo_spec, input, tri_output, pc_output, curve);
+
+    std::size_t mismatch_count = 0;
+    uint32_t max_ulp = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+      if (tri_output.valid[i] == 0) {
+        continue;
+      }
+      tdc2::ParallaxCorrectionSolution expected;
+      bool const solved = tdc2::ParallaxCorrectionSolver::SolveByGeometry(
+        torpedo_spec, corpus.triangles[i], tri_output.pseudo_torpedo_gyro_angle[i], aiming_device_position,
+        corpus.ownship_courses[i].AsRad(), expected, curve
+      );
+      std::optional<tdc2::ParallaxCorrectionSolution> const actual = pc_output.Get(i);
+      if (solved != actual.has_value() || (solved && expected.iterations != actual->iterations)) {
+        ++mismatch_count;
+        continue;
+      }
+      if (!solved) {
+        continue;
+      }
+      uint32_t ulp = 0;
+      for (auto const& [e, a] : {
+        std::pair { expected.delta, actual->delta },
+        std::pair { expected.rho, actual->rho },
+        std::pair { expected.gamma, actual->gamma },
+        std::pair { expected.beta, actual->beta },
+        std::pair { expected.epf_offset.x, actual->epf_offset.x },
+        std::pair { expected.epf_offset.y, actual->epf_offset.y },
+        std::pair { expected.torpedo_run_distance_m, actual->torpedo_run_distance_m },
+        std::pair { expected.torpedo_time_to_target_s, actual->torpedo_time_to_target_s },
+        std::pair { expected.impact_position.x, actual->impact_position.x },
+        std::pair { expected.impact_position.y, actual->impact_position.y },
+      }) {
+        ulp = std::max(ulp, GetUlpDistance(e, a));
+      }
+      mismatch_count += (ulp != 0) ? 1 : 0;
+      max_ulp = std::max(max_ulp, ulp);
+    }
+    report("parallax_geometry", with_curve, mismatch_count, max_ulp);
+  }
+
+  return ok;
+}
+
+//
+// Measurement.
+//
+
+/// Outcome of one operation of a kernel.
+struct OpResult final {
+  bool solved = false;
+  uint32_t iterations = 0;
+  float value = 0.0f; // Folded into `g_sink` so the operation cannot be optimized away.
+};
+
+volatile float g_sink = 0.0f;
+
+struct KernelResult final {
+  char const* kernel = nullptr;
+  char const* regime = nullptr;
+  bool has_iterations = false;
+
+  uint64_t op_count = 0;
+  double ns_per_op = 0.0;
+  double p50_ns = 0.0;
+  double p99_ns = 0.0;
+  uint64_t solved_count = 0;
+  double iterations_mean = 0.0;
+  uint32_t iterations_max = 0;
+
+  bool has_agreement = false;
+  uint64_t agree_count = 0;          // Both solved, final gyro angles within `kAgreementToleranceRad`.
+  uint64_t disagree_count = 0;       // Both solved, on different solutions.
+  uint64_t only_reference_count = 0; // Only the reference solved.
+  uint64_t only_kernel_count = 0;    // Only this kernel solved.
+  double max_agreeing_diff_rad = 0.0;
+
+  bool has_accuracy = false;
+  double max_rel_error = 0.0;
+};
+
+/// Largest difference of final gyro angles for two parallax engines to count as agreeing, in radians.
+constexpr float kAgreementToleranceRad = 1e-4f;
+/// Largest share of the reference solutions a parallax engine may miss or differ on and still be recommended. Near final
+/// gyro angles of ±180° both turn directions can solve the triangle, and engines may settle on either.
+constexpr double kMaxDisagreementRate = 0.01;
+
+double ToNs(Clock::duration duration) {
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+
+/// Smallest observed time between two consecutive clock reads.
+double MeasureTimerOverheadNs() {
+  Clock::duration min_duration = Clock::duration::max();
+  for (int i = 0; i < 10000; ++i) {
+    Clock::time_point const t0 = Clock::now();
+    Clock::time_point const t1 = Clock::now();
+    min_duration = std::min(min_duration, t1 - t0);
+  }
+  return ToNs(min_duration);
+}
+
+double GetPercentile(std::vector<double>& sorted_values, double percentile) {
+  std::size_t const index = static_cast<std::size_t>(percentile * static_cast<double>(sorted_values.size() - 1) + 0.5);
+  return sorted_values[index];
+}
+
+/// Time `op(i)` for i in [0, `count`).
+template <typename Op>
+KernelResult RunKernel(
+  char const* kernel,
+  char const* regime,
+  bool has_iterations,
+  std::size_t count,
+  Options const& options,
+  double timer_overhead_ns,
+  Op&& op
+) {
+  KernelResult result {
+    .kernel = kernel,
+    .regime = regime,
+    .has_iterations = has_iterations,
+    .op_count = count,
+  };
+  if (count == 0) {
+    return result;
+  }
+
+  // Warm up, and gather the outcome statistics once.
+  {
+    uint64_t iteration_sum = 0;
+    float sink = 0.0f;
+    for (std::size_t i = 0; i < count; ++i) {
+      OpResult const op_result = op(i);
+      result.solved_count += op_result.solved ? 1 : 0;
+      iteration_sum += op_result.iterations;
+      result.iterations_max = std::max(result.iterations_max, op_result.iterations);
+      sink += op_result.value;
+    }
+    result.iterations_mean = static_cast<double>(iteration_sum) / static_cast<double>(count);
+    g_sink = sink;
+  }
+
+  // Throughput: Whole passes.
+  {
+    std::vector<double> pass_ns_per_op;
+    for (uint32_t pass = 0; pass < options.repeat_count; ++pass) {
+      float sink = 0.0f;
+      Clock::time_point const t0 = Clock::now();
+      for (std::size_t i = 0; i < count; ++i) {
+        sink += op(i).value;
+      }
+      Clock::time_point const t1 = Clock::now();
+      g_sink = sink;
+      pass_ns_per_op.push_back(ToNs(t1 - t0) / static_cast<double>(count));
+    }
+    std::sort(pass_ns_per_op.begin(), pass_ns_per_op.end());
+    result.ns_per_op = GetPercentile(pass_ns_per_op, 0.5);
+  }
+
+  // Latency: Every operation on its own.
+  {
+    std::vector<double> latencies_ns;
+    latencies_ns.reserve(count * options.repeat_count);
+    for (uint32_t pass = 0; pass < options.repeat_count; ++pass) {
+      float sink = 0.0f;
+      for (std::size_t i = 0; i < count; ++i) {
+        Clock::time_point const t0 = Clock::now();
+        sink += op(i).value;
+        Clock::time_point const t1 = Clock::now();
+        latencies_ns.push_back(std::max(0.0, ToNs(t1 - t0) - timer_overhead_ns));
+      }
+      g_sink = sink;
+    }
+    std::sort(latencies_ns.begin(), latencies_ns.end());
+    result.p50_ns = GetPercentile(latencies_ns, 0.50);
+    result.p99_ns = GetPercentile(latencies_ns, 0.99);
+  }
+
+  return result;
+}
+
+bool Matches(char const* name, char const* filter) {
+  return filter == nullptr || std::string_view(name).find(filter) != std::string_view::npos;
+}
+
+//
+// Kernels.
+//
+
+/// H(Δ) of `ParallaxCorrectionSolver::SolveSiemens`, the function the root finder is meant for.
+std::optional<float> EvaluateSiemensResidual(tdc2::TorpedoSpec const& torpedo_spec, tdc2::TorpedoTriangle const& triangle, float delta) {
+  float const omega = triangle.target_bearing.AsRad();
+  float const gamma = triangle.angle_on_bow.AsRad() - delta;
+
+  float const sin_beta = (triangle.target_speed_kn / torpedo_spec.speed_kn) * std::sin(gamma);
+  if (sin_beta < -1.0f || 1.0f < sin_beta) {
+    return std::nullopt;
+  }
+  float const beta = std::asin(sin_beta);
+
+  float const rho = std::remainder(omega - delta + beta, 2.0f * std::numbers::pi_v<float>);
+  Vec2 const epf_offset = torpedo_spec.ComputeEquivalentPointOfFireOffset(rho);
+
+  float const f = epf_offset.Length() / triangle.target_range_m;
+  float const g = std::atan2(epf_offset.y, epf_offset.x) - omega;
+  return std::sin(delta) - f * std::sin(delta + g);
+}
+
+/// `EvaluateSiemensResidual` at every `deltas[i]`, NaN where undefined; written as a flat loop for the compiler to vectorize.
+void EvaluateSiemensResidualBatch(
+  tdc2::TorpedoSpec const& torpedo_spec,
+  tdc2::TorpedoTriangle const& triangle,
+  std::span<float const> deltas,
+  std::span<float> residuals
+) {
+  for (std::size_t i = 0; i < deltas.size(); ++i) {
+    residuals[i] = EvaluateSiemensResidual(torpedo_spec, triangle, deltas[i]).value_or(std::numeric_limits<float>::quiet_NaN());
+  }
+}
+
+void RunCorpus(Corpus const& corpus, Options const& options, double timer_overhead_ns, std::vector<KernelResult>& results) {
+  tdc2::TorpedoSpec const& torpedo_spec = options.torpedo_spec;
+  Vec2 const aiming_device_position = { 0.0f, 0.0f };
+
+  auto run = [&](char const* kernel, bool has_iterations, std::size_t count, auto&& op) {
+    if (!Matches(kernel, options.kernel_filter)) {
+      return;
+    }
+    results.push_back(RunKernel(kernel, corpus.regime, has_iterations, count, options, timer_overhead_ns, op));
+
+    KernelResult const& result = results.back();
+    std::fprintf(
+      stderr,
+      "%-26s %-16s %8.1f ns/op  p50 %8.1f ns  p99 %8.1f ns  solved %6llu/%-6llu",
+      result.kernel, result.regime, result.ns_per_op, result.p50_ns, result.p99_ns,
+      static_cast<unsigned long long>(result.solved_count), static_cast<unsigned long long>(result.op_count)
+    );
+    if (result.has_iterations) {
+      std::fprintf(stderr, "  iterations mean %.2f max %u", result.iterations_mean, result.iterations_max);
+    }
+    std::fputc('\n', stderr);
+  };
+
+  run("triangle_solve", false, corpus.triangles.size(), [&](std::size_t i) {
+    std::optional<tdc2::TorpedoTriangleSolution> const solution = corpus.triangles[i].Solve(corpus.interms[i], aiming_device_position);
+    return OpResult {
+      .solved = solution.has_value(),
+      .value = solution.has_value() ? solution->pseudo_torpedo_gyro_angle.AsRad() : 0.0f,
+    };
+  });
+
+  // The general branch of the triangle in float, and in mixed precision as `TorpedoTriangle::Solve` does it, against double.
+  {
+    // Scenarios with AoB exactly 0 or 180° take the dedicated branch of the solver instead.
+    std::vector<tdc2::TorpedoTriangle> general_triangles;
+    for (tdc2::TorpedoTriangle const& triangle : corpus.triangles) {
+      float const aob = triangle.angle_on_bow.AsRad();
+      if (aob != 0.0f && std::abs(aob) != std::numbers::pi_v<float>) {
+        general_triangles.push_back(triangle);
+      }
+    }
+
+    auto solve_core_double = [&](std::size_t i) {
+      tdc2::TorpedoTriangle const& triangle = general_triangles[i];
+      return tdc2::SolveTorpedoTriangleCore<double>(
+        triangle.torpedo_speed_kn, triangle.target_speed_kn, triangle.target_range_m, triangle.angle_on_bow.Abs().AsRad()
+      );
+    };
+    auto solve_core_float = [&](std::size_t i) {
+      tdc2::TorpedoTriangle const& triangle = general_triangles[i];
+      return tdc2::SolveTorpedoTriangleCore<float>(
+        triangle.torpedo_speed_kn, triangle.target_speed_kn, triangle.target_range_m, triangle.angle_on_bow.Abs().AsRad()
+      );
+    };
+    auto solve_core_mixed = [&](std::size_t i) {
+      tdc2::TorpedoTriangleCore<float> core = solve_core_float(i);
+      if (tdc2::IsTorpedoTriangleIllConditioned(core.sin_abs_angle_on_bow, core.sin_lead_angle, core.sin_intercept_angle)) {
+        tdc2::TorpedoTriangleCore<double> const refined = solve_core_double(i);
+        core.valid = refined.valid;
+        core.torpedo_run_distance_m = static_cast<float>(refined.torpedo_run_distance_m);
+      }
+      return core;
+    };
+
+    auto run_core = [&](char const* kernel, auto&& solve_core) {
+      std::size_t const result_count = results.size();
+      run(kernel, false, general_triangles.size(), [&](std::size_t i) {
+        tdc2::TorpedoTriangleCore<float> const core = solve_core(i);
+        return OpResult { .solved = core.valid, .value = core.torpedo_run_distance_m };
+      });
+      if (results.size() == result_count) {
+        return;
+      }
+
+      KernelResult& result = results.back();
+      result.has_accuracy = true;
+      for (std::size_t i = 0; i < general_triangles.size(); ++i) {
+        tdc2::TorpedoTriangleCore<float> const core = solve_core(i);
+        tdc2::TorpedoTriangleCore<double> const reference = solve_core_double(i);
+        if (core.valid && reference.valid && reference.torpedo_run_distance_m > 0.0) {
+          double const rel_error = std::abs(static_cast<double>(core.torpedo_run_distance_m) - reference.torpedo_run_distance_m) / reference.torpedo_run_distance_m;
+          result.max_rel_error = std::max(result.max_rel_error, rel_error);
+        }
+      }
+      std::fprintf(stderr, "%-26s %-16s max relative run distance error %.2e\n", "", "", result.max_rel_error);
+    };
+    run_core("triangle_core_float", solve_core_float);
+    run_core("triangle_core_mixed", solve_core_mixed);
+  }
+
+  struct ParallaxKernel final {
+    char const* name;
+    tdc2::ParallaxSolveMethod method;
+  };
+  auto solve_parallax = [&](tdc2::ParallaxSolveMethod method, std::size_t i, tdc2::ParallaxCorrectionSolution& solution) {
+    return tdc2::ParallaxCorrectionSolver::Solve(
+      method,
+      torpedo_spec,
+      corpus.solved_triangles[i],
+      corpus.pseudo_gyro_angles[i],
+      aiming_device_position,
+      corpus.solved_ownship_courses[i],
+      solution
+    );
+  };
+
+  // Reference solutions for the agreement of the other engines.
+  std::vector<std::optional<float>> reference_rhos(corpus.solved_triangles.size());
+  for (std::size_t i = 0; i < reference_rhos.size(); ++i) {
+    tdc2::ParallaxCorrectionSolution solution;
+    if (solve_parallax(tdc2::ParallaxSolveMethod::kGeometry, i, solution)) {
+      reference_rhos[i] = solution.rho;
+    }
+  }
+
+  std::optional<std::size_t> fastest_agreeing_parallax; // Index into `results`.
+  for (ParallaxKernel const& kernel : {
+    ParallaxKernel { "parallax_geometry", tdc2::ParallaxSolveMethod::kGeometry },
+    ParallaxKernel { "parallax_newton", tdc2::ParallaxSolveMethod::kNewton },
+    ParallaxKernel { "parallax_siemens", tdc2::ParallaxSolveMethod::kSiemens },
+  }) {
+    std::size_t const result_count = results.size();
+    run(kernel.name, true, corpus.solved_triangles.size(), [&](std::size_t i) {
+      tdc2::ParallaxCorrectionSolution solution;
+      bool const solved = solve_parallax(kernel.method, i, solution);
+      return OpResult { .solved = solved, .iterations = solution.iterations, .value = solution.rho };
+    });
+    if (results.size() == result_count) {
+      continue;
+    }
+
+    KernelResult& result = results.back();
+    result.has_agreement = true;
+    for (std::size_t i = 0; i < reference_rhos.size(); ++i) {
+      tdc2::ParallaxCorrectionSolution solution;
+      bool const solved = solve_parallax(kernel.method, i, solution);
+      if (!reference_rhos[i].has_value()) {
+        result.only_kernel_count += solved ? 1 : 0;
+        continue;
+      }
+      if (!solved) {
+        ++result.only_reference_count;
+        continue;
+      }
+      double const diff = std::abs(std::remainder(static_cast<double>(solution.rho) - reference_rhos[i].value(), 2.0 * std::numbers::pi));
+      if (diff < kAgreementToleranceRad) {
+        ++result.agree_count;
+        result.max_agreeing_diff_rad = std::max(result.max_agreeing_diff_rad, diff);
+      }
+      else {
+        ++result.disagree_count;
+      }
+    }
+    std::fprintf(
+      stderr,
+      "%-26s %-16s agree %6llu  disagree %6llu  only reference %6llu  only this %6llu  max diff %.2e rad\n",
+      "", "",
+      static_cast<unsigned long long>(result.agree_count), static_cast<unsigned long long>(result.disagree_count),
+      static_cast<unsigned long long>(result.only_reference_count), static_cast<unsigned long long>(result.only_kernel_count),
+      result.max_agreeing_diff_rad
+    );
+
+    // Engines that miss or change solutions of the reference are not candidates, however fast.
+    uint64_t const reference_count = result.agree_count + result.disagree_count + result.only_reference_count;
+    uint64_t const differing_count = result.disagree_count + result.only_reference_count;
+    if (static_cast<double>(differing_count) <= kMaxDisagreementRate * static_cast<double>(reference_count)) {
+      if (!fastest_agreeing_parallax.has_value() || result.ns_per_op < results[fastest_agreeing_parallax.value()].ns_per_op) {
+        fastest_agreeing_parallax = results.size() - 1;
+      }
+    }
+  }
+  if (fastest_agreeing_parallax.has_value()) {
+    std::fprintf(stderr, "%-26s %-16s fastest agreeing parallax engine: %s\n", "", corpus.regime, results[fastest_agreeing_parallax.value()].kernel);
+  }
+
+  // Blocks of scenarios through the scalar solvers and through the batch solvers, for the speedup of the lanes.
+  {
+    constexpr std::size_t kBlockSize = 64;
+    std::size_t const block_count = corpus.triangles.size() / kBlockSize;
+
+    tdc2::TorpedoTriangleBatchInput input;
+    tdc2::TorpedoTriangleBatchOutput tri_output;
+    tdc2::ParallaxCorrectionBatchOutput pc_output;
+    input.Resize(corpus.triangles.size());
+    tri_output.Resize(corpus.triangles.size());
+    pc_output.Resize(corpus.triangles.size());
+    for (std::size_t i = 0; i < corpus.triangles.size(); ++i) {
+      input.Set(i, corpus.triangles[i], corpus.ownship_courses[i], aiming_device_position);
+    }
+    tdc2::SolveTorpedoTriangleBatch(torpedo_spec.speed_kn, input, tri_output);
+
+    auto run_pair = [&](char const* scalar_kernel, char const* batch_kernel, bool has_iterations, auto&& solve_scalar, auto&& solve_batch) {
+      std::size_t const first_result = results.size();
+      run(scalar_kernel, has_iterations, block_count, solve_scalar);
+      run(batch_kernel, has_iterations, block_count, solve_batch);
+      if (results.size() == first_result + 2) {
+        std::fprintf(
+          stderr, "%-26s %-16s batch speedup %.2fx\n",
+          "", "", results[first_result].ns_per_op / results[first_result + 1].ns_per_op
+        );
+      }
+    };
+
+    run_pair(
+      "triangle_block_scalar", "triangle_block_batch", false,
+      [&](std::size_t block) {
+        OpResult result;
+        for (std::size_t i = block * kBlockSize; i < (block + 1) * kBlockSize; ++i) {
+          tdc2::TorpedoTriangle const& triangle = corpus.triangles[i];
+          std::optional<tdc2::TorpedoTriangleSolution> const solution = triangle.Solve(triangle.PrepareSolve(corpus.ownship_courses[i]), aiming_device_position);
+          if (solution.has_value()) {
+            result.solved = true;
+            result.value += solution->pseudo_torpedo_gyro_angle.AsRad();
+          }
+        }
+        return result;
+      },
+      [&](std::size_t block) {
+        tdc2::SolveTorpedoTriangleBatch(torpedo_spec.speed_kn, input, tri_output, block * kBlockSize, kBlockSize);
+        OpResult result;
+        for (std::size_t i = block * kBlockSize; i < (block + 1) * kBlockSize; ++i) {
+          result.solved = result.solved || tri_output.valid[i] != 0;
+          result.value += tri_output.pseudo_torpedo_gyro_angle[i];
+        }
+        return result;
+      }
+    );
+
+    tdc2::EquivalentPointOfFireCurveCache epf_curve_cache;
+    for (bool const with_curve : { false, true }) {
+      tdc2::EquivalentPointOfFireCurve const* const curve = with_curve ? &epf_curve_cache.Get(torpedo_spec) : nullptr;
+
+      run_pair(
+        with_curve ? "parallax_block_scalar_curve" : "parallax_block_scalar",
+        with_curve ? "parallax_block_batch_curve" : "parallax_block_batch",
+        true,
+        [&](std::size_t block) {
+          OpResult result;
+          for (std::size_t i = block * kBlockSize; i < (block + 1) * kBlockSize; ++i) {
+            if (tri_output.valid[i] == 0) {
+              continue;
+            }
+            tdc2::ParallaxCorrectionSolution solution;
+            if (tdc2::ParallaxCorrectionSolver::SolveByGeometry(
+              torpedo_spec, corpus.triangles[i], tri_output.pseudo_torpedo_gyro_angle[i], aiming_device_position,
+              corpus.ownship_courses[i].AsRad(), solution, curve
+            )) {
+              result.solved = true;
+              result.iterations += solution.iterations;
+              result.value += solution.rho;
+            }
+          }
+          return result;
+        },
+        [&](std::size_t block) {
+          tdc2::SolveParallaxCorrectionBatch(torpedo_spec, input, tri_output, pc_output, block * kBlockSize, kBlockSize, curve);
+          OpResult result;
+          for (std::size_t i = block * kBlockSize; i < (block + 1) * kBlockSize; ++i) {
+            // Failed lanes still record their iterations, which the scalar solver does not report; count solved lanes only.
+            if (pc_output.valid[i] != 0) {
+              result.solved = true;
+              result.iterations += pc_output.iterations[i];
+              result.value += pc_output.rho[i];
+            }
+          }
+          return result;
+        }
+      );
+    }
+  }
+
+  run("epf_offset", false, corpus.pseudo_gyro_angles.size(), [&](std::size_t i) {
+    Vec2 const offset = torpedo_spec.ComputeEquivalentPointOfFireOffset(corpus.pseudo_gyro_angles[i]);
+    return OpResult { .solved = true, .value = offset.x + offset.y };
+  });
+
+  // The generic runtime spec against the preset baked in at compile time, which `SolveByGeometry` picks for presets.
+  tdc2::VisitTorpedoSpec(torpedo_spec, [&](auto const& preset_spec) {
+    if constexpr (!std::is_same_v<std::decay_t<decltype(preset_spec)>, tdc2::TorpedoSpec>) {
+      run("epf_offset_runtime_spec", false, corpus.pseudo_gyro_angles.size(), [&](std::size_t i) {
+        Vec2 const offset = tdc2::ComputeEquivalentPointOfFireOffset(torpedo_spec, corpus.pseudo_gyro_angles[i]);
+        return OpResult { .solved = true, .value = offset.x + offset.y };
+      });
+      run("epf_offset_preset", false, corpus.pseudo_gyro_angles.size(), [&](std::size_t i) {
+        Vec2 const offset = tdc2::ComputeEquivalentPointOfFireOffset(preset_spec, corpus.pseudo_gyro_angles[i]);
+        return OpResult { .solved = true, .value = offset.x + offset.y };
+      });
+
+      auto run_geometry = [&](char const* kernel, auto const& spec) {
+        run(kernel, true, corpus.solved_triangles.size(), [&](std::size_t i) {
+          tdc2::ParallaxCorrectionSolution solution;
+          bool const solved = tdc2::ParallaxCorrectionSolver::SolveByGeometryWith(
+            spec,
+            corpus.solved_triangles[i],
+            corpus.pseudo_gyro_angles[i],
+            aiming_device_position,
+            corpus.solved_ownship_courses[i],
+            solution
+          );
+          return OpResult { .solved = solved, .iterations = solution.iterations, .value = solution.rho };
+        });
+      };
+      run_geometry("parallax_geometry_runtime_spec", torpedo_spec);
+      run_geometry("parallax_geometry_preset", preset_spec);
+    }
+  });
+
+  tdc2::EquivalentPointOfFireCurveCache epf_curve_cache;
+  tdc2::EquivalentPointOfFireCurve const& epf_curve = epf_curve_cache.Get(torpedo_spec);
+  run("epf_curve_evaluate", false, corpus.pseudo_gyro_angles.size(), [&](std::size_t i) {
+    Vec2 const offset = epf_curve.Evaluate(corpus.pseudo_gyro_angles[i]);
+    return OpResult { .solved = true, .value = offset.x + offset.y };
+  });
+
+  // Torpedo kinematics, at the step of the simulation, against the closed-form track and parallax correction.
+  if (Matches("torpedo_kinematics_step", options.kernel_filter)) {
+    constexpr std::size_t kStepCount = 256;
+    constexpr std::size_t kMaxCheckedShotCount = 256; // Run to their targets, for checking against the model.
+
+    struct Shot final {
+      tdc2::ParallaxCorrectionSolution solution;
+      float ownship_course_rad = 0.0f;
+      Vec2 tube_position = { 0.0f, 0.0f };
+    };
+    std::vector<Shot> shots;
+    for (std::size_t i = 0; i < corpus.solved_triangles.size(); ++i) {
+      Shot shot;
+      shot.ownship_course_rad = corpus.solved_ownship_courses[i];
+      if (tdc2::ParallaxCorrectionSolver::SolveByGeometry(
+        torpedo_spec, corpus.solved_triangles[i], corpus.pseudo_gyro_angles[i], aiming_device_position, shot.ownship_course_rad, shot.solution
+      )) {
+        shot.tube_position = aiming_device_position + tdc2::ComputeCourseDirection(Angle(shot.ownship_course_rad)) * torpedo_spec.distance_to_tube;
+        shots.push_back(shot);
+      }
+    }
+
+    auto launch = [&](tdc2::TorpedoKinematics& kinematics, std::size_t shot_count) {
+      for (std::size_t i = 0; i < shot_count; ++i) {
+        kinematics.Launch(torpedo_spec, shots[i].tube_position, Angle(shots[i].ownship_course_rad), shots[i].solution.rho);
+      }
+    };
+
+    {
+      tdc2::TorpedoKinematics kinematics(tdc2::Simulation::kStepS);
+      launch(kinematics, shots.size());
+      run("torpedo_kinematics_step", false, shots.empty() ? 0 : kStepCount, [&](std::size_t) {
+        kinematics.Step();
+        return OpResult { .solved = true, .value = static_cast<float>(kinematics.GetRunDistance(0)) };
+      });
+      if (!shots.empty()) {
+        std::fprintf(stderr, "%-26s %-16s %.2f ns per torpedo step\n", "", corpus.regime, results.back().ns_per_op / static_cast<double>(shots.size()));
+      }
+    }
+
+    // Torpedoes that hit during the turn are not on the final course the parallax correction assumes.
+    float max_epf_error_m = 0.0f;
+    float max_impact_error_m = 0.0f;
+    float max_track_error_m = 0.0f;
+    std::size_t checked_count = 0;
+    std::size_t const shot_count = std::min(shots.size(), kMaxCheckedShotCount);
+    {
+      tdc2::TorpedoKinematics kinematics(tdc2::Simulation::kStepS);
+      launch(kinematics, shot_count);
+      std::vector<bool> checked(shot_count, false);
+      for (std::size_t remaining_count = shot_count; remaining_count > 0; ) {
+        kinematics.Step();
+        for (std::size_t i = 0; i < shot_count; ++i) {
+          Shot const& shot = shots[i];
+          double const run_distance_m = kinematics.GetRunDistance(i);
+          if (checked[i] || run_distance_m < shot.solution.torpedo_run_distance_m) {
+            continue;
+          }
+          checked[i] = true;
+          --remaining_count;
+
+          Vec2 const position = kinematics.GetPosition(i);
+          Angle const heading = kinematics.GetHeading(i);
+          Vec2 const track_position = tdc2::ComputeTorpedoTrackPosition(
+            torpedo_spec, shot.tube_position, Angle(shot.ownship_course_rad), shot.solution.rho, static_cast<float>(run_distance_m)
+          );
+          max_track_error_m = std::max(max_track_error_m, (position - track_position).Length());
+          if (kinematics.GetPhase(i) != tdc2::TorpedoPhase::kStraight) {
+            continue;
+          }
+
+          Vec2 const model_epf = aiming_device_position + shot.solution.epf_offset.Rotate(shot.ownship_course_rad - std::numbers::pi_v<float> / 2.0f);
+          max_epf_error_m = std::max(max_epf_error_m, (kinematics.ComputeEquivalentPointOfFire(i) - model_epf).Length());
+
+          // Back to the run distance of the solution, from up to a step past it.
+          float const overshoot_m = static_cast<float>(run_distance_m) - shot.solution.torpedo_run_distance_m;
+          Vec2 const impact_position = position - tdc2::ComputeCourseDirection(heading) * overshoot_m;
+          max_impact_error_m = std::max(max_impact_error_m, (impact_position - shot.solution.impact_position).Length());
+          ++checked_count;
+        }
+      }
+    }
+    std::fprintf(
+      stderr, "%-26s %-16s kinematics vs model (%zu of %zu torpedoes): max error EPF %.3f m, impact %.3f m, track %.3f m\n",
+      "", corpus.regime, checked_count, shot_count, max_epf_error_m, max_impact_error_m, max_track_error_m
+    );
+  }
+
+  // The dataflow graph of the TDC, once with new inputs for every update and once with unchanged ones.
+  auto make_tdc_inputs = [&](std::size_t i) {
+    tdc2::TorpedoTriangle const& triangle = corpus.triangles[i];
+    return tdc2::TdcInputs {
+      .torpedo_spec = torpedo_spec,
+      .target_bearing = triangle.target_bearing,
+      .target_range_m = triangle.target_range_m,
+      .target_speed_kn = triangle.target_speed_kn,
+      .angle_on_bow = triangle.angle_on_bow,
+      .ownship_course = corpus.ownship_courses[i],
+      .aiming_device_position = aiming_device_position,
+    };
+  };
+  auto get_tdc_result = [](tdc2::TdcGraph const& graph) {
+    std::optional<tdc2::ParallaxCorrectionSolution> const& pc_solution = graph.GetParallaxSolution();
+    return OpResult { .solved = pc_solution.has_value(), .value = pc_solution.has_value() ? pc_solution->rho : 0.0f };
+  };
+  {
+    tdc2::TdcGraph graph;
+    run("tdc_update_changed", false, corpus.triangles.size(), [&](std::size_t i) {
+      graph.Update(make_tdc_inputs(i));
+      return get_tdc_result(graph);
+    });
+  }
+  {
+    tdc2::TdcGraph graph;
+    tdc2::TdcInputs const steady_inputs = corpus.triangles.empty() ? tdc2::TdcInputs {} : make_tdc_inputs(0);
+    run("tdc_update_unchanged", false, corpus.triangles.size(), [&](std::size_t) {
+      graph.Update(steady_inputs);
+      return get_tdc_result(graph);
+    });
+  }
+  // What the UI thread pays per frame with the solve on the worker: The results lag, so `solved` counts stale ones too.
+  {
+    tdc2::AsyncTdcSolver solver;
+    run("tdc_async_submit", false, corpus.triangles.size(), [&](std::size_t i) {
+      solver.Submit(make_tdc_inputs(i), nullptr);
+      solver.Poll();
+      std::optional<tdc2::ParallaxCorrectionSolution> const& pc_solution = solver.GetResult().parallax_solution;
+      return OpResult { .solved = pc_solution.has_value(), .value = pc_solution.has_value() ? pc_solution->rho : 0.0f };
+    });
+  }
+
+  // Every tracked target solved together, once per tick.
+  {
+    constexpr std::size_t kTargetCount = 1000;
+    constexpr std::size_t kTickCount = 64;
+    constexpr float kTickDriftRad = 0.05f * kDegToRad;
+
+    std::vector<tdc2::TargetData> initial_targets;
+    for (std::size_t i = 0; i < std::min(corpus.triangles.size(), kTargetCount); ++i) {
+      tdc2::TorpedoTriangle const& triangle = corpus.triangles[i];
+      initial_targets.push_back(tdc2::TargetData {
+        .target_bearing = triangle.target_bearing,
+        .target_range_m = triangle.target_range_m,
+        .target_speed_kn = triangle.target_speed_kn,
+        .angle_on_bow = triangle.angle_on_bow,
+      });
+    }
+    JobSystem job_system;
+    for (JobSystem* const tick_job_system : { static_cast<JobSystem*>(nullptr), &job_system }) {
+      tdc2::TargetTable targets;
+      for (tdc2::TargetData const& target : initial_targets) {
+        targets.Add(target);
+      }
+
+      uint64_t iteration_sum = 0;
+      uint64_t lane_count = 0;
+      std::size_t const result_count = results.size();
+      char const* const kernel = (tick_job_system == nullptr) ? "tdc_targets_solve" : "tdc_targets_solve_jobs";
+      run(kernel, false, targets.GetCount() == 0 ? 0 : kTickCount, [&](std::size_t i) {
+        for (std::size_t j = 0; j < initial_targets.size(); ++j) {
+          tdc2::TargetData target = initial_targets[j];
+          target.target_bearing += Angle(kTickDriftRad * static_cast<float>(i));
+          targets.SetTarget(j, target);
+        }
+        targets.Solve(torpedo_spec, corpus.ownship_courses[0], aiming_device_position, &epf_curve, tick_job_system);
+
+        std::vector<uint8_t> const& iterations = targets.GetParallaxOutputs().iterations;
+        for (uint8_t const lane_iterations : iterations) {
+          iteration_sum += lane_iterations;
+        }
+        lane_count += iterations.size();
+
+        std::optional<tdc2::ParallaxCorrectionSolution> const pc_solution = targets.GetParallaxSolution(0);
+        return OpResult { .solved = pc_solution.has_value(), .value = pc_solution.has_value() ? pc_solution->rho : 0.0f };
+      });
+      if (results.size() != result_count) {
+        std::fprintf(
+          stderr, "%-26s %-16s %.1f us per tick of %zu targets, parallax iterations mean %.2f\n", "", corpus.regime,
+          results.back().ns_per_op / 1000.0, targets.GetCount(), static_cast<double>(iteration_sum) / static_cast<double>(lane_count)
+        );
+      }
+    }
+  }
+
+  // Every ownship of a fleet against every contact, once per tick.
+  {
+    constexpr std::size_t kOwnshipCount = 50;
+    constexpr std::size_t kContactCount = 500;
+    constexpr std::size_t kTickCount = 64;
+    constexpr float kTickS = 1.0f / 60.0f;
+    constexpr float kOwnshipSpacingM = 300.0f;
+
+    std::vector<tdc2::FleetOwnship> ownships;
+    for (std::size_t i = 0; i < kOwnshipCount; ++i) {
+      ownships.push_back(tdc2::FleetOwnship {
+        .position = { kOwnshipSpacingM * (static_cast<float>(i) - static_cast<float>(kOwnshipCount - 1) * 0.5f), 0.0f },
+        .course = Angle::FromDeg(0.0f),
+        .distance_to_aiming_device = 20.0f + static_cast<float>(i % 5),
+        .torpedo_spec = tdc2::GetTorpedoPresetSpec((i % 2 == 0) ? tdc2::TorpedoPreset::kG7a : tdc2::TorpedoPreset::kG7e),
+      });
+    }
+    std::vector<tdc2::FleetContact> initial_contacts;
+    for (std::size_t i = 0; i < std::min(corpus.triangles.size(), kContactCount); ++i) {
+      tdc2::TorpedoTriangle const& triangle = corpus.triangles[i];
+      Angle const ownship_course = corpus.ownship_courses[i];
+      initial_contacts.push_back(tdc2::FleetContact {
+        .position = tdc2::ComputeTargetPosition(aiming_device_position, ownship_course, triangle.target_bearing, triangle.target_range_m),
+        .course = tdc2::ComputeAbsoluteTargetBearing(ownship_course, triangle.target_bearing) + Angle::Pi() - triangle.angle_on_bow,
+        .speed_kn = triangle.target_speed_kn,
+      });
+    }
+
+    JobSystem job_system;
+    tdc2::EngagementMatrix matrix;
+    std::vector<tdc2::FleetContact> contacts = initial_contacts;
+    std::size_t const result_count = results.size();
+    run("fleet_matrix_solve", false, contacts.empty() ? 0 : kTickCount, [&](std::size_t i) {
+      for (std::size_t j = 0; j < contacts.size(); ++j) {
+        tdc2::FleetContact const& contact = initial_contacts[j];
+        float const distance_m = contact.speed_kn * 1852.0f / 3600.0f * kTickS * static_cast<float>(i);
+        contacts[j].position = contact.position + tdc2::ComputeCourseDirection(contact.course) * distance_m;
+      }
+      matrix.Solve(ownships, contacts, &job_system);
+
+      std::vector<uint8_t> const& valid = matrix.GetParallaxOutputs().valid;
+      return OpResult {
+        .solved = std::find(valid.begin(), valid.end(), uint8_t(1)) != valid.end(),
+        .value = matrix.GetParallaxOutputs().rho[0],
+      };
+    });
+    if (results.size() != result_count) {
+      std::size_t const engagement_count = ownships.size() * contacts.size();
+      std::fprintf(
+        stderr, "%-26s %-16s %.2f ms per tick of %zux%zu engagements on %u threads, %.1f ns per engagement\n", "", corpus.regime,
+        results.back().ns_per_op / 1e6, ownships.size(), contacts.size(), job_system.GetThreadCount(),
+        results.back().ns_per_op / static_cast<double>(engagement_count)
+      );
+    }
+  }
+
+  // A firing plan per scenario. Consecutive scenarios are unrelated, so the planner's warm start helps little here.
+  {
+    constexpr std::size_t kPlanScenarioCount = 64;
+    constexpr float kOwnshipSpeedKn = 6.0f;
+
+    JobSystem job_system;
+    tdc2::FiringPlanner planner;
+    tdc2::FiringPlanOptions const plan_options {};
+    run("firing_plan", false, std::min(corpus.triangles.size(), kPlanScenarioCount), [&](std::size_t i) {
+      tdc2::TorpedoTriangle const& triangle = corpus.triangles[i];
+      Angle const ownship_course = corpus.ownship_courses[i];
+      tdc2::SimShip const ownship {
+        .position = aiming_device_position,
+        .course = ownship_course,
+        .speed_kn = kOwnshipSpeedKn,
+      };
+      tdc2::SimShip const target {
+        .position = tdc2::ComputeTargetPosition(aiming_device_position, ownship_course, triangle.target_bearing, triangle.target_range_m),
+        .course = tdc2::ComputeAbsoluteTargetBearing(ownship_course, triangle.target_bearing) + Angle::Pi() - triangle.angle_on_bow,
+        .speed_kn = triangle.target_speed_kn,
+        .length_m = 134.0f,
+        .beam_m = 17.3f,
+      };
+      planner.Plan(torpedo_spec, ownship, target, plan_options, &job_system);
+
+      std::optional<std::size_t> const best = planner.GetBestIndex();
+      return OpResult {
+        .solved = best.has_value(),
+        .value = best.has_value() ? planner.GetCandidates()[best.value()].time_s : 0.0f,
+      };
+    });
+  }
+
+  // Course sweeps: Against a new target each time, then against one target from tick to tick.
+  {
+    constexpr std::size_t kSweepScenarioCount = 64;
+    constexpr std::size_t kDriftTickCount = 64;
+    constexpr float kDriftTickS = 1.0f;
+    constexpr uint32_t kCourseCount = 3600;
+
+    JobSystem job_system;
+    tdc2::SimShip const ownship {
+      .position = aiming_device_position,
+    };
+    auto make_target = [&](std::size_t i) {
+      tdc2::TorpedoTriangle const& triangle = corpus.triangles[i];
+      Angle const ownship_course = corpus.ownship_courses[i];
+      return tdc2::SimShip {
+        .position = tdc2::ComputeTargetPosition(aiming_device_position, ownship_course, triangle.target_bearing, triangle.target_range_m),
+        .course = tdc2::ComputeAbsoluteTargetBearing(ownship_course, triangle.target_bearing) + Angle::Pi() - triangle.angle_on_bow,
+        .speed_kn = triangle.target_speed_kn,
+      };
+    };
+    auto get_sweep_result = [](tdc2::CourseSweep const& sweep) {
+      std::optional<std::size_t> const best = sweep.GetMinGyroAngleIndex();
+      return OpResult {
+        .solved = best.has_value(),
+        .value = best.has_value() ? sweep.GetSamples()[best.value()].course : 0.0f,
+      };
+    };
+
+    tdc2::CourseSweep sweep;
+    run("course_sweep", false, std::min(corpus.triangles.size(), kSweepScenarioCount), [&](std::size_t i) {
+      sweep.Sweep(torpedo_spec, ownship, make_target(i), kCourseCount, &job_system);
+      return get_sweep_result(sweep);
+    });
+
+    tdc2::CourseSweep drift_sweep;
+    run("course_sweep_drift", false, corpus.triangles.empty() ? 0 : kDriftTickCount, [&](std::size_t i) {
+      tdc2::SimShip target = make_target(0);
+      float const distance_m = target.speed_kn * 1852.0f / 3600.0f * kDriftTickS * static_cast<float>(i + 1);
+      target.position += tdc2::ComputeCourseDirection(target.course) * distance_m;
+      drift_sweep.Sweep(torpedo_spec, ownship, target, kCourseCount, &job_system);
+      return get_sweep_result(drift_sweep);
+    });
+  }
+
+  // Dial drags: Every scenario is followed by small steps of the target bearing, as when turning the bearing dial, to
+  // compare the parallax iterations with and without warm start.
+  {
+    constexpr std::size_t kDragScenarioCount = 512;
+    constexpr std::size_t kDragStepCount = 16;
+    constexpr float kDragStepRad = 0.1f * kDegToRad;
+
+    std::size_t const drag_count = std::min(corpus.triangles.size(), kDragScenarioCount) * kDragStepCount;
+    auto make_drag_inputs = [&](std::size_t i, bool warm_start) {
+      tdc2::TdcInputs inputs = make_tdc_inputs(i / kDragStepCount);
+      inputs.target_bearing += Angle(kDragStepRad * static_cast<float>(i % kDragStepCount));
+      inputs.warm_start = warm_start;
+      return inputs;
+    };
+
+    double mean_iterations[2] = {};
+    for (bool const warm_start : { false, true }) {
+      std::size_t const result_count = results.size();
+      tdc2::TdcGraph graph;
+      run(warm_start ? "tdc_drag_warm" : "tdc_drag_cold", true, drag_count, [&](std::size_t i) {
+        bool const recomputed = graph.Update(make_drag_inputs(i, warm_start));
+        std::optional<tdc2::ParallaxCorrectionSolution> const& pc_solution = graph.GetParallaxSolution();
+        OpResult result = get_tdc_result(graph);
+        result.iterations = (recomputed && pc_solution.has_value()) ? pc_solution->iterations : 0;
+        return result;
+      });
+      if (results.size() != result_count) {
+        mean_iterations[warm_start ? 1 : 0] = results.back().iterations_mean;
+      }
+    }
+    if (mean_iterations[0] > 0.0 && mean_iterations[1] > 0.0) {
+      std::fprintf(
+        stderr, "%-26s %-16s warm start: iterations mean %.2f -> %.2f (-%.0f%%)\n", "", corpus.regime,
+        mean_iterations[0], mean_iterations[1], 100.0 * (1.0 - mean_iterations[1] / mean_iterations[0])
+      );
+    }
+  }
+
+  struct RootFindingKernel final {
+    char const* name;
+    RootFindingMethod method;
+    bool batched;
+  };
+  for (RootFindingKernel const& kernel : {
+    RootFindingKernel { "find_roots_bisection", RootFindingMethod::kBisection, false },
+    RootFindingKernel { "find_roots_brent", RootFindingMethod::kBrent, false },
+    RootFindingKernel { "find_roots_illinois", RootFindingMethod::kIllinois, false },
+    RootFindingKernel { "find_roots_brent_batched", RootFindingMethod::kBrent, true },
+  }) {
+    RootFindingOptions const root_finding_options {
+      .method = kernel.method,
+      .tolerance = 1e-6f,
+      .max_iterations = 100,
+    };
+
+    run(kernel.name, true, corpus.solved_triangles.size(), [&](std::size_t i) {
+      uint32_t evaluation_count = 0;
+      tdc2::TorpedoTriangle const& triangle = corpus.solved_triangles[i];
+      auto evaluate = [&](float delta) {
+        ++evaluation_count;
+        return EvaluateSiemensResidual(torpedo_spec, triangle, delta);
+      };
+      auto evaluate_batch = [&](std::span<float const> deltas, std::span<float> residuals) {
+        evaluation_count += static_cast<uint32_t>(deltas.size());
+        EvaluateSiemensResidualBatch(torpedo_spec, triangle, deltas, residuals);
+      };
+
+      RootSet<8> const roots = kernel.batched ?
+        FindRootsBatched<8>(evaluate, evaluate_batch, -std::numbers::pi_v<float>, std::numbers::pi_v<float>, root_finding_options) :
+        FindRoots<8>(evaluate, -std::numbers::pi_v<float>, std::numbers::pi_v<float>, root_finding_options);
+      std::optional<float> const root = roots.FindNearest(0.0f);
+      return OpResult { .solved = root.has_value(), .iterations = evaluation_count, .value = root.value_or(0.0f) };
+    });
+  }
+}
+
+void RunConvoyScaling(Options const& options, double timer_overhead_ns, std::vector<KernelResult>& results) {
+  struct ConvoyRegime final {
+    char const* name;
+    std::size_t ship_count;
+  };
+  constexpr ConvoyRegime kRegimes[] = {
+    { "convoy_1", 1 }, { "convoy_10", 10 }, { "convoy_100", 100 },
+    { "convoy_1000", 1'000 }, { "convoy_10000", 10'000 }, { "convoy_100000", 100'000 },
+  };
+  // Ticks per pass: Fewer for the larger convoys, which would otherwise dominate the run.
+  constexpr std::size_t kTickShipCount = 100'000;
+  constexpr std::size_t kMaxTickCount = 64;
+  constexpr std::size_t kMinTickCount = 4;
+  constexpr double kTickS = 1.0;
+
+  tdc2::TorpedoSpec const& torpedo_spec = options.torpedo_spec;
+  tdc2::EquivalentPointOfFireCurveCache epf_curve_cache;
+  tdc2::EquivalentPointOfFireCurve const& epf_curve = epf_curve_cache.Get(torpedo_spec);
+  Vec2 const aiming_device_position = { 0.0f, 0.0f };
+  Angle const ownship_course = Angle::FromDeg(0.0f);
+
+  for (ConvoyRegime const& regime : kRegimes) {
+    if (!Matches(regime.name, options.regime_filter)) {
+      continue;
+    }
+
+    // Crossing ahead from port to starboard, its nearest escort 4 km off.
+    tdc2::ConvoySpec spec = tdc2::ConvoySpec::ForShipCount(regime.ship_count, options.seed);
+    spec.base_course = Angle::RightAngle();
+    spec.center = { 0.0f, -(0.5f * static_cast<float>(spec.column_count - 1) * spec.column_spacing_m + spec.screen_distance_m + 4000.0f) };
+
+    Clock::time_point const t0 = Clock::now();
+    std::vector<tdc2::ConvoyShip> const ships = tdc2::GenerateConvoy(spec);
+    double const generate_ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+
+    tdc2::TargetTable targets;
+    for (tdc2::ConvoyShip const& ship : ships) {
+      targets.Add(tdc2::ComputeTargetData(aiming_device_position, ownship_course, ship.position, ship.course, ship.speed_kn));
+    }
+
+    std::size_t const tick_count = std::clamp(kTickShipCount / regime.ship_count, kMinTickCount, kMaxTickCount);
+    if (Matches("convoy_solve", options.kernel_filter)) {
+      results.push_back(RunKernel("convoy_solve", regime.name, false, tick_count, options, timer_overhead_ns, [&](std::size_t i) {
+        double const time_s = kTickS * static_cast<double>(i);
+        for (std::size_t j = 0; j < ships.size(); ++j) {
+          tdc2::ConvoyShip const ship = tdc2::AdvanceConvoyShip(spec, ships[j], time_s);
+          targets.SetTarget(j, tdc2::ComputeTargetData(aiming_device_position, ownship_course, ship.position, ship.course, ship.speed_kn));
+        }
+        targets.Solve(torpedo_spec, ownship_course, aiming_device_position, &epf_curve);
+
+        std::optional<tdc2::ParallaxCorrectionSolution> const pc_solution = targets.GetParallaxSolution(0);
+        return OpResult { .solved = pc_solution.has_value(), .value = pc_solution.has_value() ? pc_solution->rho : 0.0f };
+      }));
+
+      KernelResult const& result = results.back();
+      std::fprintf(
+        stderr, "%-26s %-16s %10.1f us per tick of %zu targets, %.1f ns per target, %zu B per target, generated in %.2f ms\n",
+        result.kernel, result.regime, result.ns_per_op / 1000.0, targets.GetCount(),
+        result.ns_per_op / static_cast<double>(targets.GetCount()), targets.GetMemoryUsage() / targets.GetCount(), generate_ms
+      );
+    }
+
+    // The grid the TDC keeps over its targets, with the convoy moving on by a tick of its zig-zag each time.
+    constexpr float kGridCellM = 500.0f;
+    std::vector<std::vector<Vec2>> tick_positions(tick_count);
+    for (std::size_t i = 0; i < tick_count; ++i) {
+      tick_positions[i].reserve(ships.size());
+      for (tdc2::ConvoyShip const& ship : ships) {
+        tick_positions[i].push_back(tdc2::AdvanceConvoyShip(spec, ship, kTickS * static_cast<double>(i)).position);
+      }
+    }
+
+    auto report_grid = [&](std::size_t result_count) {
+      if (results.size() == result_count) {
+        return;
+      }
+      KernelResult const& result = results.back();
+      std::fprintf(
+        stderr, "%-26s %-16s %10.1f us per %zu points, %.1f ns per point\n", result.kernel, result.regime,
+        result.ns_per_op / 1000.0, ships.size(), result.ns_per_op / static_cast<double>(ships.size())
+      );
+    };
+
+    {
+      tdc2::SpatialGrid grid(kGridCellM);
+      std::size_t const result_count = results.size();
+      if (Matches("spatial_grid_update", options.kernel_filter)) {
+        results.push_back(RunKernel("spatial_grid_update", regime.name, false, tick_count, options, timer_overhead_ns, [&](std::size_t i) {
+          grid.Update(tick_positions[i]);
+          return OpResult { .solved = true, .value = grid.GetPosition(0).x };
+        }));
+      }
+      report_grid(result_count);
+    }
+    {
+      tdc2::SpatialGrid grid(kGridCellM);
+      std::size_t const result_count = results.size();
+      if (Matches("spatial_grid_rebuild", options.kernel_filter)) {
+        results.push_back(RunKernel("spatial_grid_rebuild", regime.name, false, tick_count, options, timer_overhead_ns, [&](std::size_t i) {
+          grid.Clear();
+          grid.Update(tick_positions[i]);
+          return OpResult { .solved = true, .value = grid.GetPosition(0).x };
+        }));
+      }
+      report_grid(result_count);
+    }
+    // Picking with a radius of half a ship length, at each ship in turn, a little off.
+    {
+      constexpr float kPickRadiusM = 67.0f;
+      constexpr Vec2 kPickOffset = { 20.0f, -20.0f };
+
+      tdc2::SpatialGrid grid(kGridCellM);
+      grid.Update(tick_positions[0]);
+      if (Matches("spatial_grid_pick", options.kernel_filter)) {
+        results.push_back(RunKernel("spatial_grid_pick", regime.name, false, ships.size(), options, timer_overhead_ns, [&](std::size_t i) {
+          std::optional<uint32_t> const nearest = grid.FindNearest(tick_positions[0][i] + kPickOffset, kPickRadiusM);
+          return OpResult { .solved = nearest.has_value(), .value = static_cast<float>(nearest.value_or(0)) };
+        }));
+
+        KernelResult const& result = results.back();
+        std::fprintf(
+          stderr, "%-26s %-16s %10.1f ns per pick among %zu points, found %llu/%llu\n", result.kernel, result.regime,
+          result.ns_per_op, ships.size(),
+          static_cast<unsigned long long>(result.solved_count), static_cast<unsigned long long>(result.op_count)
+        );
+      }
+    }
+  }
+}
+
+//
+// Output.
+//
+
+void WriteJson(std::FILE* out, Options const& options, double timer_overhead_ns, std::vector<KernelResult> const& results) {
+  tdc2::TorpedoSpec const& spec = options.torpedo_spec;
+
+  std::fprintf(out, "{\n");
+  std::fprintf(out, "  \"schema\": \"seerohr_bench/1\",\n");
+  std::fprintf(
+    out,
+    "  \"config\": {\"seed\": %u, \"samples\": %u, \"repeats\": %u, "
+    "\"torpedo\": {\"distance_to_tube_m\": %g, \"reach_m\": %g, \"turn_radius_m\": %g, \"speed_kn\": %g}},\n",
+    options.seed, options.sample_count, options.repeat_count,
+    spec.distance_to_tube, spec.reach, spec.turn_radius, spec.speed_kn
+  );
+  std::fprintf(out, "  \"timer_overhead_ns\": %.1f,\n", timer_overhead_ns);
+  std::fprintf(out, "  \"results\": [");
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    KernelResult const& result = results[i];
+    double const ops_per_s = (result.ns_per_op > 0.0) ? 1e9 / result.ns_per_op : 0.0;
+    std::fprintf(
+      out,
+      "%s\n    {\"kernel\": \"%s\", \"regime\": \"%s\", \"ops\": %llu, \"ns_per_op\": %.2f, \"ops_per_s\": %.0f, "
+      "\"p50_ns\": %.1f, \"p99_ns\": %.1f, \"solved\": %llu",
+      (i == 0) ? "" : ",",
+      result.kernel, result.regime, static_cast<unsigned long long>(result.op_count), result.ns_per_op, ops_per_s,
+      result.p50_ns, result.p99_ns, static_cast<unsigned long long>(result.solved_count)
+    );
+    if (result.has_iterations) {
+      std::fprintf(out, ", \"iterations_mean\": %.3f, \"iterations_max\": %u", result.iterations_mean, result.iterations_max);
+    }
+    if (result.has_accuracy) {
+      std::fprintf(out, ", \"max_rel_error\": %.3e", result.max_rel_error);
+    }
+    if (result.has_agreement) {
+      std::fprintf(
+        out,
+        ", \"agreement\": {\"reference\": \"parallax_geometry\", \"tolerance_rad\": %g, \"agree\": %llu, \"disagree\": %llu, "
+        "\"only_reference\": %llu, \"only_kernel\": %llu, \"max_diff_rad\": %.3e}",
+        kAgreementToleranceRad,
+        static_cast<unsigned long long>(result.agree_count), static_cast<unsigned long long>(result.disagree_count),
+        static_cast<unsigned long long>(result.only_reference_count), static_cast<unsigned long long>(result.only_kernel_count),
+        result.max_agreeing_diff_rad
+      );
+    }
+    std::fprintf(out, "}");
+  }
+  std::fprintf(out, "\n  ]\n}\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::optional<Options> const parsed_options = ParseOptions(argc, argv);
+  if (!parsed_options) {
+    PrintUsage();
+    return EXIT_FAILURE;
+  }
+  Options const& options = parsed_options.value();
+
+  bool const collinear_ok = CheckCollinearRunDistance(options);
+
+  double const timer_overhead_ns = MeasureTimerOverheadNs();
+
+  bool batch_ok = true;
+  std::vector<KernelResult> results;
+  for (Regime regime : { Regime::kGeneral, Regime::kAngleOnBowNear0Or180, Regime::kSinLeadAngleNear1, Regime::kLargeGyroAngle }) {
+    if (!Matches(GetRegimeName(regime), options.regime_filter)) {
+      continue;
+    }
+    Corpus const corpus = MakeCorpus(regime, options);
+    batch_ok = CheckBatchAgreement(corpus, options) && batch_ok;
+    RunCorpus(corpus, options, timer_overhead_ns, results);
+  }
+  RunConvoyScaling(options, timer_overhead_ns, results);
+
+  std::FILE* out = stdout;
+  if (options.output_path != nullptr) {
+    out = std::fopen(options.output_path, "w");
+    if (out == nullptr) {
+      std::fprintf(stderr, "Failed to open %s for writing\n", options.output_path);
+      return EXIT_FAILURE;
+    }
+  }
+  WriteJson(out, options, timer_overhead_ns, results);
+  if (out != stdout) {
+    std::fclose(out);
+  }
+
+  return (collinear_ok && batch_ok) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
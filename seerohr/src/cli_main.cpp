@@ -0,0 +1,697 @@
+// c++ headers ------------------------------------------
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <numbers>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// project headers --------------------------------------
+#include "mbase/public/platform.h"
+
+#include "job_system.h"
+#include "mapped_file.h"
+#include "tdc2_batch.h"
+#include "tdc2_epf.h"
+#include "tdc2_solver.h"
+#include "tool_options.h"
+
+// conditional c++ headers ------------------------------
+#if MBASE_PLATFORM_WINDOWS
+# include <fcntl.h>
+# include <io.h>
+#endif
+
+// Headless batch solver.
+//
+// Reads one scenario per line as comma separated values:
+//
+//   bearing_deg,range_m,target_speed_kn,aob_deg,ownship_course_deg[,distance_to_tube_m,reach_m,turn_radius_m,torpedo_speed_kn]
+//
+// Bearing and AoB are relative and signed: Positive is starboard, negative is port; a bearing in [180, 360) is taken as
+// port. The optional trailing fields override the torpedo given on the command line for that line. Empty lines, lines
+// starting with '#' and header lines (starting with a letter) are skipped.
+//
+// Writes one solution per scenario, in input order, as CSV, JSON lines or packed `SolutionRecord`s.
+//
+// Files are mapped into memory; stdin is read in large blocks. Either way the input is cut into chunks at line
+// boundaries which are parsed, solved and formatted in parallel on a `JobSystem`, and written in order through large buffers.
+
+namespace {
+
+constexpr float kDegToRad = std::numbers::pi_v<float> / 180.0f;
+constexpr float kRadToDeg = 180.0f / std::numbers::pi_v<float>;
+
+// Input bytes per chunk; one chunk is parsed, solved and formatted by one thread at a time.
+constexpr std::size_t kChunkByteCount = 1 << 20;
+// Bytes read from stdin at a time.
+constexpr std::size_t kReadBlockByteCount = 16 << 20;
+
+enum class OutputFormat {
+  kCsv,
+  kJsonLines,
+  kBinary,
+};
+
+enum SolutionFlags : uint32_t {
+  kSolutionTriangleSolved = 1u << 0,
+  kSolutionParallaxSolved = 1u << 1,
+};
+
+/// Record of `--format binary`: Host byte order (little-endian on every supported platform), no padding, one per scenario
+/// in input order.
+///
+/// Fields that belong to an unsolved stage are zero; see `flags`.
+struct SolutionRecord final {
+  uint64_t line = 0;                   // 1-based line number in the input.
+  uint32_t flags = 0;                  // `SolutionFlags`.
+  uint32_t iterations = 0;             // Parallax correction iterations.
+  float target_course_deg = 0.0f;
+  float lead_angle_deg = 0.0f;
+  float pseudo_gyro_angle_deg = 0.0f;  // Signed: Positive is starboard, negative is port.
+  float triangle_run_time_s = 0.0f;    // Without parallax correction.
+  float gyro_angle_deg = 0.0f;         // Signed: Positive is starboard, negative is port.
+  float parallax_correction_deg = 0.0f;
+  float run_distance_m = 0.0f;
+  float run_time_s = 0.0f;
+};
+static_assert(sizeof(SolutionRecord) == 48);
+
+struct Options final {
+  char const* input_path = nullptr;  // Null: stdin.
+  char const* output_path = nullptr; // Null: stdout.
+  OutputFormat format = OutputFormat::kCsv;
+
+  tdc2::TorpedoSpec torpedo_spec = tdc2::GetTorpedoPresetSpec(tdc2::TorpedoPreset::kG7e);
+  tdc2::ParallaxSolveMethod method = tdc2::ParallaxSolveMethod::kGeometry;
+
+  uint32_t thread_count = 0; // 0: One per hardware thread.
+};
+
+struct Scenario final {
+  uint64_t line = 0;
+  tdc2::TorpedoTriangle triangle;
+  float ownship_course_rad = 0.0f;
+  std::optional<tdc2::TorpedoSpec> torpedo_spec; // Overrides `Options::torpedo_spec`.
+};
+
+/// A run of complete input lines, and everything derived from them.
+struct Chunk final {
+  std::string_view text;
+  uint64_t first_line = 0;
+
+  std::vector<Scenario> scenarios;
+  std::vector<SolutionRecord> records;
+  std::vector<uint64_t> malformed_lines;
+  std::string output;
+};
+
+void PrintUsage() {
+  std::fprintf(
+    stderr,
+    "Usage: seerohr_cli [options]\n"
+    "\n"
+    "Reads scenarios as 'bearing_deg,range_m,target_speed_kn,aob_deg,ownship_course_deg' lines,\n"
+    "optionally followed by ',distance_to_tube_m,reach_m,turn_radius_m,torpedo_speed_kn'.\n"
+    "\n"
+    "Options:\n"
+    "  --input <path>               Input file, memory mapped. Default: stdin\n"
+    "  --output <path>              Output file. Default: stdout\n"
+    "  --format <csv|jsonl|binary>  Output format. Default: csv\n"
+    "  --torpedo <g7a|g7e>          Torpedo preset. Default: g7e\n"
+    "  --distance-to-tube <m>       Override the distance from the aiming device to the tube.\n"
+    "  --reach <m>                  Override the initial straight run.\n"
+    "  --turn-radius <m>            Override the turn radius.\n"
+    "  --method <name>              Parallax solver: geometry, newton or siemens. Default: geometry\n"
+    "  --threads <n>                Worker threads. Default: hardware concurrency\n"
+  );
+}
+
+std::optional<Options> ParseOptions(int argc, char** argv) {
+  Options options;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string_view const arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      return std::nullopt;
+    }
+    if (i + 1 >= argc) {
+      std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+      return std::nullopt;
+    }
+    char const* value = argv[++i];
+    std::string_view const value_sv = value;
+
+    bool ok = true;
+    if (arg == "--input") {
+      options.input_path = (value_sv == "-") ? nullptr : value;
+    }
+    else if (arg == "--output") {
+      options.output_path = (value_sv == "-") ? nullptr : value;
+    }
+    else if (arg == "--format") {
+      if (value_sv == "csv") {
+        options.format = OutputFormat::kCsv;
+      }
+      else if (value_sv == "jsonl") {
+        options.format = OutputFormat::kJsonLines;
+      }
+      else if (value_sv == "binary") {
+        options.format = OutputFormat::kBinary;
+      }
+      else {
+        ok = false;
+      }
+    }
+    else if (arg == "--torpedo") {
+      std::optional<tdc2::TorpedoSpec> const torpedo_spec = tool_options::ParseTorpedoPreset(value_sv);
+      ok = torpedo_spec.has_value();
+      if (ok) {
+        options.torpedo_spec = torpedo_spec.value();
+      }
+    }
+    else if (arg == "--distance-to-tube" || arg == "--reach" || arg == "--turn-radius") {
+      std::optional<float> const parsed = tool_options::ParseFloat(value_sv);
+      ok = parsed.has_value() && parsed.value() >= 0.0f;
+      if (ok) {
+        float& field = (arg == "--distance-to-tube") ? options.torpedo_spec.distance_to_tube :
+                       (arg == "--reach") ? options.torpedo_spec.reach : options.torpedo_spec.turn_radius;
+        field = parsed.value();
+      }
+    }
+    else if (arg == "--method") {
+      std::optional<tdc2::ParallaxSolveMethod> const method = tool_options::ParseSolveMethod(value_sv);
+      ok = method.has_value();
+      if (ok) {
+        options.method = method.value();
+      }
+    }
+    else if (arg == "--threads") {
+      std::optional<uint32_t> const parsed = tool_options::ParseUInt32(value_sv);
+      ok = parsed.has_value();
+      if (ok) {
+        options.thread_count = parsed.value();
+      }
+    }
+    else {
+      std::fprintf(stderr, "Unknown option: %s\n", argv[i - 1]);
+      return std::nullopt;
+    }
+
+    if (!ok) {
+      std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], value);
+      return std::nullopt;
+    }
+  }
+
+  return options;
+}
+
+//
+// Parsing.
+//
+
+/// Parse one input line. Returns `std::nullopt` for malformed lines; `skip` is set for lines that carry no scenario.
+std::optional<Scenario> ParseScenario(std::string_view line, bool& skip) {
+  skip = false;
+
+  std::size_t const first = line.find_first_not_of(" \t\r");
+  if (first == std::string_view::npos || line[first] == '#' ||
+      ('a' <= (line[first] | 0x20) && (line[first] | 0x20) <= 'z')) {
+    skip = true;
+    return std::nullopt;
+  }
+
+  float fields[9] = {};
+  uint32_t field_count = 0;
+  for (;;) {
+    std::size_t const comma = line.find(',');
+    if (field_count == 9) {
+      return std::nullopt;
+    }
+    std::optional<float> const value = tool_options::ParseFloat(line.substr(0, comma));
+    if (!value) {
+      return std::nullopt;
+    }
+    fields[field_count++] = value.value();
+    if (comma == std::string_view::npos) {
+      break;
+    }
+    line.remove_prefix(comma + 1);
+  }
+
+  if (field_count != 5 && field_count != 9) {
+    return std::nullopt;
+  }
+
+  // Expect full circle [0, 360) degrees or signed degrees for the target bearing, as the TDC does.
+  float bearing_deg = fields[0];
+  if (180.0f <= bearing_deg) {
+    bearing_deg -= 360.0f;
+  }
+
+  float const range_m = fields[1];
+  float const target_speed_kn = fields[2];
+  float const aob_deg = fields[3];
+  if (!(-180.0f <= bearing_deg && bearing_deg <= 180.0f) || !(0.0f < range_m) || !(0.0f <= target_speed_kn) ||
+      !(-180.0f <= aob_deg && aob_deg <= 180.0f)) {
+    return std::nullopt;
+  }
+
+  Scenario scenario;
+  scenario.triangle = tdc2::TorpedoTriangle {
+    .torpedo_speed_kn = 0.0f, // Filled in by the solve.
+    .target_bearing = Angle(bearing_deg * kDegToRad),
+    .target_range_m = range_m,
+    .target_speed_kn = target_speed_kn,
+    .angle_on_bow = Angle(aob_deg * kDegToRad),
+  };
+  scenario.ownship_course_rad = fields[4] * kDegToRad;
+
+  if (field_count == 9) {
+    if (!(0.0f <= fields[5] && 0.0f <= fields[6] && 0.0f <= fields[7] && 0.0f < fields[8])) {
+      return std::nullopt;
+    }
+    scenario.torpedo_spec = tdc2::TorpedoSpec {
+      .distance_to_tube = fields[5],
+      .reach = fields[6],
+      .turn_radius = fields[7],
+      .speed_kn = fields[8],
+    };
+  }
+
+  return scenario;
+}
+
+void ParseChunk(Chunk& chunk) {
+  std::string_view text = chunk.text;
+  uint64_t line = chunk.first_line;
+
+  while (!text.empty()) {
+    std::size_t const newline = text.find('\n');
+    std::string_view const line_text = text.substr(0, newline);
+    text.remove_prefix((newline == std::string_view::npos) ? text.size() : newline + 1);
+
+    bool skip = false;
+    if (std::optional<Scenario> scenario = ParseScenario(line_text, skip); scenario.has_value()) {
+      scenario->line = line;
+      chunk.scenarios.push_back(scenario.value());
+    }
+    else if (!skip) {
+      chunk.malformed_lines.push_back(line);
+    }
+    ++line;
+  }
+}
+
+//
+// Solving.
+//
+
+SolutionRecord MakeRecord(
+  uint64_t line,
+  std::optional<tdc2::TorpedoTriangleSolution> const& tri_solution,
+  std::optional<tdc2::ParallaxCorrectionSolution> const& pc_solution
+) {
+  SolutionRecord record;
+  record.line = line;
+
+  if (tri_solution) {
+    record.flags |= kSolutionTriangleSolved;
+    record.target_course_deg = tri_solution->target_course.ToDeg();
+    record.lead_angle_deg = tri_solution->lead_angle.ToDeg();
+    record.pseudo_gyro_angle_deg = tri_solution->pseudo_torpedo_gyro_angle.ToDeg();
+    record.triangle_run_time_s = tri_solution->torpedo_time_to_target_s;
+  }
+  if (pc_solution) {
+    record.flags |= kSolutionParallaxSolved;
+    record.iterations = pc_solution->iterations;
+    record.gyro_angle_deg = pc_solution->rho * kRadToDeg;
+    record.parallax_correction_deg = pc_solution->delta * kRadToDeg;
+    record.run_distance_m = pc_solution->torpedo_run_distance_m;
+    record.run_time_s = pc_solution->torpedo_time_to_target_s;
+  }
+  return record;
+}
+
+void SolveChunk(Options const& options, Chunk& chunk) {
+  std::vector<Scenario> const& scenarios = chunk.scenarios;
+  chunk.records.resize(scenarios.size());
+
+  // The aiming device is at the origin; solutions are relative to it.
+  Vec2 const aiming_device_position = { 0.0f, 0.0f };
+
+  // Lines with the default torpedo go through the batch solver if it implements the method; the rest one by one.
+  std::vector<std::size_t> batch_indices;
+  std::vector<std::size_t> scalar_indices;
+  for (std::size_t i = 0; i < scenarios.size(); ++i) {
+    bool const batch = !scenarios[i].torpedo_spec.has_value() && options.method == tdc2::ParallaxSolveMethod::kGeometry;
+    (batch ? batch_indices : scalar_indices).push_back(i);
+  }
+
+  tdc2::EquivalentPointOfFireCurveCache epf_curve_cache;
+
+  if (!batch_indices.empty()) {
+    tdc2::TorpedoSpec const& torpedo_spec = options.torpedo_spec;
+
+    tdc2::TorpedoTriangleBatchInput input;
+    input.Resize(batch_indices.size());
+    for (std::size_t i = 0; i < batch_indices.size(); ++i) {
+      Scenario const& scenario = scenarios[batch_indices[i]];
+      input.Set(i, scenario.triangle, Angle(scenario.ownship_course_rad), aiming_device_position);
+    }
+
+    tdc2::TorpedoTriangleBatchOutput tri_output;
+    tri_output.Resize(input.Size());
+    tdc2::SolveTorpedoTriangleBatch(torpedo_spec.speed_kn, input, tri_output);
+
+    tdc2::ParallaxCorrectionBatchOutput pc_output;
+    pc_output.Resize(input.Size());
+    tdc2::SolveParallaxCorrectionBatch(
+      torpedo_spec, input, tri_output, pc_output,
+      &epf_curve_cache.Get(torpedo_spec)
+    );
+
+    for (std::size_t i = 0; i < batch_indices.size(); ++i) {
+      std::size_t const index = batch_indices[i];
+      chunk.records[index] = MakeRecord(scenarios[index].line, tri_output.Get(i), pc_output.Get(i));
+    }
+  }
+
+  for (std::size_t index : scalar_indices) {
+    Scenario const& scenario = scenarios[index];
+    tdc2::TorpedoSpec const& torpedo_spec = scenario.torpedo_spec.value_or(options.torpedo_spec);
+
+    tdc2::TorpedoTriangle triangle = scenario.triangle;
+    triangle.torpedo_speed_kn = torpedo_spec.speed_kn;
+
+    Angle const ownship_course = Angle(scenario.ownship_course_rad);
+    std::optional<tdc2::TorpedoTriangleSolution> const tri_solution = triangle.Solve(triangle.PrepareSolve(ownship_course), aiming_device_position);
+
+    std::optional<tdc2::ParallaxCorrectionSolution> pc_solution;
+    if (tri_solution) {
+      tdc2::ParallaxCorrectionSolution solution;
+      bool const result = tdc2::ParallaxCorrectionSolver::Solve(
+        options.method,
+        torpedo_spec,
+        triangle,
+        tri_solution->pseudo_torpedo_gyro_angle.AsRad(),
+        aiming_device_position,
+        ownship_course.AsRad(),
+        solution,
+        &epf_curve_cache.Get(torpedo_spec)
+      );
+      if (result) {
+        pc_solution = solution;
+      }
+    }
+
+    chunk.records[index] = MakeRecord(scenario.line, tri_solution, pc_solution);
+  }
+}
+
+//
+// Formatting.
+//
+
+void AppendUInt(std::string& out, uint64_t value) {
+  char buffer[24];
+  auto const [end, ec] = std::to_chars(std::begin(buffer), std::end(buffer), value);
+  out.append(buffer, end);
+}
+
+void AppendFloat(std::string& out, float value, int precision) {
+  char buffer[48];
+  auto const [end, ec] = std::to_chars(std::begin(buffer), std::end(buffer), value, std::chars_format::fixed, precision);
+  if (ec != std::errc()) {
+    // Only for magnitudes beyond any sensible run time; fall back to the shortest representation.
+    auto const [general_end, general_ec] = std::to_chars(std::begin(buffer), std::end(buffer), value);
+    out.append(buffer, general_end);
+    return;
+  }
+  out.append(buffer, end);
+}
+
+constexpr char const* kCsvHeader =
+  "line,triangle,parallax,target_course_deg,lead_angle_deg,pseudo_gyro_angle_deg,triangle_run_time_s,"
+  "gyro_angle_deg,parallax_correction_deg,run_distance_m,run_time_s,iterations\n";
+
+void FormatCsv(SolutionRecord const& record, std::string& out) {
+  bool const triangle = (record.flags & kSolutionTriangleSolved) != 0;
+  bool const parallax = (record.flags & kSolutionParallaxSolved) != 0;
+
+  AppendUInt(out, record.line);
+  out += triangle ? ",1" : ",0";
+  out += parallax ? ",1" : ",0";
+
+  out += ',';
+  if (triangle) {
+    AppendFloat(out, record.target_course_deg, 3);
+    out += ',';
+    AppendFloat(out, record.lead_angle_deg, 3);
+    out += ',';
+    AppendFloat(out, record.pseudo_gyro_angle_deg, 3);
+    out += ',';
+    AppendFloat(out, record.triangle_run_time_s, 2);
+  }
+  else {
+    out += ",,,";
+  }
+
+  out += ',';
+  if (parallax) {
+    AppendFloat(out, record.gyro_angle_deg, 3);
+    out += ',';
+    AppendFloat(out, record.parallax_correction_deg, 3);
+    out += ',';
+    AppendFloat(out, record.run_distance_m, 1);
+    out += ',';
+    AppendFloat(out, record.run_time_s, 2);
+    out += ',';
+    AppendUInt(out, record.iterations);
+  }
+  else {
+    out += ",,,,";
+  }
+  out += '\n';
+}
+
+void FormatJsonLine(SolutionRecord const& record, std::string& out) {
+  bool const triangle = (record.flags & kSolutionTriangleSolved) != 0;
+  bool const parallax = (record.flags & kSolutionParallaxSolved) != 0;
+
+  auto append_field = [&out](char const* name, float value, int precision, bool present) {
+    out += ",\"";
+    out += name;
+    out += "\":";
+    if (present) {
+      AppendFloat(out, value, precision);
+    }
+    else {
+      out += "null";
+    }
+  };
+
+  out += "{\"line\":";
+  AppendUInt(out, record.line);
+  out += triangle ? ",\"triangle\":true" : ",\"triangle\":false";
+  out += parallax ? ",\"parallax\":true" : ",\"parallax\":false";
+  append_field("target_course_deg", record.target_course_deg, 3, triangle);
+  append_field("lead_angle_deg", record.lead_angle_deg, 3, triangle);
+  append_field("pseudo_gyro_angle_deg", record.pseudo_gyro_angle_deg, 3, triangle);
+  append_field("triangle_run_time_s", record.triangle_run_time_s, 2, triangle);
+  append_field("gyro_angle_deg", record.gyro_angle_deg, 3, parallax);
+  append_field("parallax_correction_deg", record.parallax_correction_deg, 3, parallax);
+  append_field("run_distance_m", record.run_distance_m, 1, parallax);
+  append_field("run_time_s", record.run_time_s, 2, parallax);
+  out += ",\"iterations\":";
+  AppendUInt(out, record.iterations);
+  out += "}\n";
+}
+
+void FormatChunk(OutputFormat format, Chunk& chunk) {
+  std::string& out = chunk.output;
+  switch (format) {
+  case OutputFormat::kCsv:
+    out.reserve(chunk.records.size() * 96);
+    for (SolutionRecord const& record : chunk.records) {
+      FormatCsv(record, out);
+    }
+    break;
+  case OutputFormat::kJsonLines:
+    out.reserve(chunk.records.size() * 320);
+    for (SolutionRecord const& record : chunk.records) {
+      FormatJsonLine(record, out);
+    }
+    break;
+  case OutputFormat::kBinary:
+    out.assign(reinterpret_cast<char const*>(chunk.records.data()), chunk.records.size() * sizeof(SolutionRecord));
+    break;
+  }
+}
+
+//
+// Driver.
+//
+
+class Pipeline final {
+public:
+  Pipeline(Options const& options, std::FILE* output, JobSystem& job_system)
+    : options_(options), output_(output), job_system_(job_system) {}
+
+  /// Process `text`, which must consist of complete lines, the first of which is line `first_line`.
+  /// Returns the number of lines in `text`.
+  uint64_t Process(std::string_view text, uint64_t first_line) {
+    // Cut into chunks at line boundaries, then process them a batch of one chunk per thread at a time to bound memory.
+    uint64_t line = first_line;
+    while (!text.empty()) {
+      std::vector<Chunk> chunks;
+      while (!text.empty() && chunks.size() < job_system_.GetThreadCount()) {
+        std::size_t size = std::min(kChunkByteCount, text.size());
+        if (size < text.size()) {
+          std::size_t const newline = text.find('\n', size - 1);
+          size = (newline == std::string_view::npos) ? text.size() : newline + 1;
+        }
+
+        Chunk& chunk = chunks.emplace_back();
+        chunk.text = text.substr(0, size);
+        chunk.first_line = line;
+        line += static_cast<uint64_t>(std::count(chunk.text.begin(), chunk.text.end(), '\n'));
+        if (!chunk.text.empty() && chunk.text.back() != '\n') {
+          ++line; // Last line without a line break.
+        }
+        text.remove_prefix(size);
+      }
+
+      this->RunChunks(chunks);
+
+      for (Chunk const& chunk : chunks) {
+        for (uint64_t malformed_line : chunk.malformed_lines) {
+          std::fprintf(stderr, "Line %llu: Malformed scenario, skipped.\n", static_cast<unsigned long long>(malformed_line));
+        }
+        malformed_count_ += chunk.malformed_lines.size();
+        scenario_count_ += chunk.records.size();
+        std::fwrite(chunk.output.data(), 1, chunk.output.size(), output_);
+      }
+    }
+    return line - first_line;
+  }
+
+  uint64_t GetScenarioCount() const { return scenario_count_; }
+  uint64_t GetMalformedCount() const { return malformed_count_; }
+
+private:
+  void RunChunks(std::vector<Chunk>& chunks) {
+    auto process = [this](Chunk& chunk) {
+      ParseChunk(chunk);
+      SolveChunk(options_, chunk);
+      FormatChunk(options_.format, chunk);
+    };
+
+    job_system_.ParallelFor(chunks.size(), [&](uint64_t first, uint64_t count) {
+      for (uint64_t i = first; i < first + count; ++i) {
+        process(chunks[i]);
+      }
+    });
+  }
+
+  Options const& options_;
+  std::FILE* output_ = nullptr;
+  JobSystem& job_system_;
+
+  uint64_t scenario_count_ = 0;
+  uint64_t malformed_count_ = 0;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::optional<Options> const parsed_options = ParseOptions(argc, argv);
+  if (!parsed_options) {
+    PrintUsage();
+    return EXIT_FAILURE;
+  }
+  Options const& options = parsed_options.value();
+
+  std::FILE* output = stdout;
+  if (options.output_path != nullptr) {
+    output = std::fopen(options.output_path, "wb");
+    if (output == nullptr) {
+      std::fprintf(stderr, "Failed to open %s for writing\n", options.output_path);
+      return EXIT_FAILURE;
+    }
+  }
+#if MBASE_PLATFORM_WINDOWS
+  else {
+    _setmode(_fileno(stdout), _O_BINARY);
+  }
+#endif
+  // Chunks are written whole; a large buffer keeps that to few writes for small chunks too.
+  std::setvbuf(output, nullptr, _IOFBF, 1 << 20);
+
+  if (options.format == OutputFormat::kCsv) {
+    std::fputs(kCsvHeader, output);
+  }
+
+  JobSystem job_system(options.thread_count);
+  Pipeline pipeline(options, output, job_system);
+
+  if (options.input_path != nullptr) {
+    std::optional<MappedFile> const input = MappedFile::Open(options.input_path);
+    if (!input) {
+      std::fprintf(stderr, "Failed to open %s (missing or empty)\n", options.input_path);
+      return EXIT_FAILURE;
+    }
+    std::span<std::byte const> const data = input->GetData();
+    pipeline.Process(std::string_view(reinterpret_cast<char const*>(data.data()), data.size()), 1);
+  }
+  else {
+    // Read large blocks and process the complete lines in them, carrying the incomplete last line over.
+    std::vector<char> buffer(kReadBlockByteCount);
+    std::size_t carried = 0;
+    uint64_t line = 1;
+    for (;;) {
+      if (carried == buffer.size()) {
+        buffer.resize(buffer.size() * 2); // A single line longer than the buffer.
+      }
+      std::size_t const read = std::fread(buffer.data() + carried, 1, buffer.size() - carried, stdin);
+      std::size_t const filled = carried + read;
+      if (read == 0) {
+        line += pipeline.Process(std::string_view(buffer.data(), filled), line);
+        break;
+      }
+
+      std::string_view const text(buffer.data(), filled);
+      std::size_t const last_newline = text.rfind('\n');
+      std::size_t const complete = (last_newline == std::string_view::npos) ? 0 : last_newline + 1;
+      line += pipeline.Process(text.substr(0, complete), line);
+
+      carried = filled - complete;
+      std::memmove(buffer.data(), buffer.data() + complete, carried);
+    }
+  }
+
+  std::fflush(output);
+  bool const write_failed = std::ferror(output) != 0;
+  if (output != stdout) {
+    std::fclose(output);
+  }
+  if (write_failed) {
+    std::fprintf(stderr, "Failed to write the output\n");
+    return EXIT_FAILURE;
+  }
+
+  std::fprintf(
+    stderr,
+    "Solved %llu scenarios; %llu malformed lines skipped.\n",
+    static_cast<unsigned long long>(pipeline.GetScenarioCount()),
+    static_cast<unsigned long long>(pipeline.GetMalformedCount())
+  );
+
+  return (pipeline.GetMalformedCount() == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,286 @@
+// TU header --------------------------------------------
+#include "job_system.h"
+
+// c++ headers ------------------------------------------
+#include <algorithm>
+#include <cassert>
+#include <optional>
+
+// public project headers --------------------------------
+#include "mbase/public/platform.h"
+
+namespace {
+
+// The queue of the calling thread, for the `JobSystem` it works for.
+thread_local JobSystem const* tls_job_system = nullptr;
+thread_local uint32_t tls_queue_index = 0;
+
+struct ParallelForContext final {
+  ParallelForContext(
+    std::function<void(uint64_t first, uint64_t count)> const& body,
+    uint64_t item_count,
+    uint64_t chunk_size,
+    CancellationToken const* cancellation,
+    JobProgressCallback const& progress
+  ) : body(body), item_count(item_count), chunk_size(chunk_size), cancellation(cancellation), progress(progress) {}
+
+  std::function<void(uint64_t first, uint64_t count)> const& body;
+  uint64_t item_count = 0;
+  uint64_t chunk_size = 1;
+  CancellationToken const* cancellation = nullptr;
+  JobProgressCallback const& progress;
+
+  std::mutex progress_mutex;
+  uint64_t reported_count = 0; // Guarded by `progress_mutex`.
+
+  std::atomic<uint64_t> remaining_chunk_count = 0;
+
+  /// Run chunk `chunk_index`, or skip it if cancelled.
+  void RunChunk(uint64_t chunk_index) {
+    uint64_t const first = chunk_index * chunk_size;
+    uint64_t const count = std::min(chunk_size, item_count - first);
+
+    if (cancellation == nullptr || !cancellation->IsCancelled()) {
+      body(first, count);
+    }
+
+    if (progress) {
+      std::scoped_lock lock(progress_mutex);
+      reported_count += count;
+      progress(reported_count, item_count);
+    }
+  }
+};
+
+} // namespace
+
+//
+// TaskGraph
+//
+
+TaskGraph::TaskId TaskGraph::Add(std::function<void()> function, std::initializer_list<TaskId> dependencies) {
+  TaskId const id = static_cast<TaskId>(tasks_.size());
+  for (TaskId dependency : dependencies) {
+    assert(dependency < id);
+    tasks_[dependency].dependents.push_back(id);
+  }
+  tasks_.push_back(Task {
+    .function = std::move(function),
+    .dependents = {},
+    .dependency_count = static_cast<uint32_t>(dependencies.size()),
+  });
+  return id;
+}
+
+//
+// JobSystem
+//
+
+JobSystem::JobSystem(uint32_t thread_count) {
+#if MBASE_PLATFORM_WEB
+  // No threads on the web; everything runs inline.
+  thread_count = 1;
+#else
+  if (thread_count == 0) {
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  }
+#endif
+
+  queues_.resize(thread_count);
+  for (std::unique_ptr<Queue>& queue : queues_) {
+    queue = std::make_unique<Queue>();
+  }
+
+  workers_.reserve(thread_count - 1);
+  for (uint32_t i = 1; i < thread_count; ++i) {
+    workers_.emplace_back(&JobSystem::RunWorker, this, i);
+  }
+}
+
+JobSystem::~JobSystem() {
+  {
+    std::scoped_lock lock(sleep_mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+}
+
+bool JobSystem::ParallelFor(
+  uint64_t item_count,
+  std::function<void(uint64_t first, uint64_t count)> const& body,
+  ParallelForOptions const& options
+) {
+  uint64_t const chunk_size = std::max<uint64_t>(options.chunk_size, 1);
+  uint64_t const chunk_count = (item_count + chunk_size - 1) / chunk_size;
+
+  ParallelForContext context(body, item_count, chunk_size, options.cancellation, options.progress);
+
+  if (workers_.empty() || chunk_count <= 1) {
+    for (uint64_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index) {
+      context.RunChunk(chunk_index);
+    }
+  }
+  else {
+    context.remaining_chunk_count.store(chunk_count, std::memory_order_relaxed);
+
+    // Queued in reverse, so that the owner, popping from the back, starts with the first chunk and thieves with the last.
+    std::vector<Job> jobs(chunk_count);
+    for (uint64_t chunk_index = 0; chunk_index < chunk_count; ++chunk_index) {
+      jobs[chunk_count - 1 - chunk_index] = Job {
+        .function = [](void* context, uint64_t chunk_index) {
+          ParallelForContext& for_context = *static_cast<ParallelForContext*>(context);
+          for_context.RunChunk(chunk_index);
+          for_context.remaining_chunk_count.fetch_sub(1, std::memory_order_acq_rel);
+        },
+        .context = &context,
+        .index = chunk_index,
+      };
+    }
+    this->Push(jobs);
+    this->HelpUntilDone(context.remaining_chunk_count);
+  }
+
+  return options.cancellation == nullptr || !options.cancellation->IsCancelled();
+}
+
+bool JobSystem::Run(TaskGraph const& graph, CancellationToken const* cancellation) {
+  std::size_t const task_count = graph.tasks_.size();
+
+  struct RunContext final {
+    JobSystem* job_system = nullptr;
+    TaskGraph const* graph = nullptr;
+    CancellationToken const* cancellation = nullptr;
+    void (*run_task)(void* context, uint64_t task_index) = nullptr;
+    std::unique_ptr<std::atomic<uint32_t>[]> pending_dependency_counts;
+    std::atomic<uint64_t> remaining_task_count = 0;
+  };
+
+  // Skipped tasks still release their dependents, so that the accounting completes either way.
+  auto const run_task = [](void* context, uint64_t task_index) {
+    RunContext& run_context = *static_cast<RunContext*>(context);
+    TaskGraph::Task const& task = run_context.graph->tasks_[task_index];
+
+    if (run_context.cancellation == nullptr || !run_context.cancellation->IsCancelled()) {
+      task.function();
+    }
+
+    std::vector<Job> released_jobs;
+    for (TaskGraph::TaskId dependent : task.dependents) {
+      if (run_context.pending_dependency_counts[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        released_jobs.push_back(Job { .function = run_context.run_task, .context = context, .index = dependent });
+      }
+    }
+    if (!released_jobs.empty()) {
+      run_context.job_system->Push(released_jobs);
+    }
+
+    run_context.remaining_task_count.fetch_sub(1, std::memory_order_acq_rel);
+  };
+
+  RunContext context {
+    .job_system = this,
+    .graph = &graph,
+    .cancellation = cancellation,
+    .run_task = run_task,
+    .pending_dependency_counts = std::make_unique<std::atomic<uint32_t>[]>(task_count),
+  };
+  context.remaining_task_count.store(task_count, std::memory_order_relaxed);
+
+  std::vector<Job> ready_jobs;
+  for (std::size_t i = 0; i < task_count; ++i) {
+    uint32_t const dependency_count = graph.tasks_[i].dependency_count;
+    context.pending_dependency_counts[i].store(dependency_count, std::memory_order_relaxed);
+    if (dependency_count == 0) {
+      ready_jobs.push_back(Job { .function = run_task, .context = &context, .index = i });
+    }
+  }
+
+  if (task_count != 0) {
+    this->Push(ready_jobs);
+    this->HelpUntilDone(context.remaining_task_count);
+  }
+
+  return cancellation == nullptr || !cancellation->IsCancelled();
+}
+
+void JobSystem::Push(std::span<Job const> jobs) {
+  Queue& queue = *queues_[this->GetQueueIndex()];
+  {
+    std::scoped_lock lock(queue.mutex);
+    queue.jobs.insert(queue.jobs.end(), jobs.begin(), jobs.end());
+  }
+  queued_count_.fetch_add(jobs.size(), std::memory_order_release);
+
+  // Taking the lock orders this after a worker that is about to sleep has checked `queued_count_`.
+  {
+    std::scoped_lock lock(sleep_mutex_);
+  }
+  if (jobs.size() == 1) {
+    wake_.notify_one();
+  }
+  else {
+    wake_.notify_all();
+  }
+}
+
+bool JobSystem::TryRunOne() {
+  uint32_t const own_index = this->GetQueueIndex();
+  uint32_t const queue_count = static_cast<uint32_t>(queues_.size());
+
+  std::optional<Job> job;
+  for (uint32_t i = 0; i < queue_count && !job; ++i) {
+    Queue& queue = *queues_[(own_index + i) % queue_count];
+    std::scoped_lock lock(queue.mutex);
+    if (queue.jobs.empty()) {
+      continue;
+    }
+    if (i == 0) {
+      job = queue.jobs.back();
+      queue.jobs.pop_back();
+    }
+    else {
+      job = queue.jobs.front();
+      queue.jobs.pop_front();
+    }
+  }
+  if (!job) {
+    return false;
+  }
+
+  queued_count_.fetch_sub(1, std::memory_order_relaxed);
+  job->function(job->context, job->index);
+  return true;
+}
+
+void JobSystem::HelpUntilDone(std::atomic<uint64_t> const& remaining) {
+  while (remaining.load(std::memory_order_acquire) != 0) {
+    if (!this->TryRunOne()) {
+      // The last jobs are running on other threads.
+      std::this_thread::yield();
+    }
+  }
+}
+
+void JobSystem::RunWorker(uint32_t queue_index) {
+  tls_job_system = this;
+  tls_queue_index = queue_index;
+
+  for (;;) {
+    if (this->TryRunOne()) {
+      continue;
+    }
+
+    std::unique_lock lock(sleep_mutex_);
+    wake_.wait(lock, [this] { return stopping_ || queued_count_.load(std::memory_order_acquire) != 0; });
+    if (stopping_) {
+      break;
+    }
+  }
+}
+
+uint32_t JobSystem::GetQueueIndex() const {
+  return (tls_job_system == this) ? tls_queue_index : 0;
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+/// Cooperative cancellation of work submitted to a `JobSystem`.
+///
+/// Copies share their state, so a copy kept by the UI can cancel work that was started with another one.
+/// Work already running finishes; work not yet started is skipped.
+class CancellationToken final {
+public:
+  CancellationToken() : cancelled_(std::make_shared<std::atomic<bool>>(false)) {}
+
+  void Cancel() const { cancelled_->store(true, std::memory_order_relaxed); }
+  bool IsCancelled() const { return cancelled_->load(std::memory_order_relaxed); }
+
+private:
+  std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+/// Called as work completes with the number of items done so far and the total.
+///
+/// Calls are serialized and see non-decreasing counts, but come from whichever thread finished the work, so the UI
+/// should only store the counts here and display them on its own thread.
+using JobProgressCallback = std::function<void(uint64_t done_count, uint64_t total_count)>;
+
+struct ParallelForOptions final {
+  /// Items per chunk, the unit of work and of progress reports.
+  uint64_t chunk_size = 1;
+  CancellationToken const* cancellation = nullptr;
+  JobProgressCallback progress;
+};
+
+/// Tasks with dependencies, run by `JobSystem::Run`.
+///
+/// A task can only depend on tasks added before it, so the graph is acyclic by construction.
+/// A graph can be run any number of times.
+class TaskGraph final {
+public:
+  using TaskId = uint32_t;
+
+  TaskId Add(std::function<void()> function, std::initializer_list<TaskId> dependencies = {});
+
+  std::size_t GetTaskCount() const { return tasks_.size(); }
+
+private:
+  friend class JobSystem;
+
+  struct Task final {
+    std::function<void()> function;
+    std::vector<TaskId> dependents;
+    uint32_t dependency_count = 0;
+  };
+
+  std::vector<Task> tasks_;
+};
+
+/// Work-stealing thread pool shared by all batch computations.
+///
+/// Each worker owns a queue it pops from the back of, and steals from the front of the other queues when its own is
+/// empty. Threads that block on work, including workers running nested work, run queued jobs while they wait, so
+/// nesting does not deadlock.
+///
+/// ## Determinism
+/// Work is split at fixed boundaries that depend on the item count and the chunk size only, never on the thread count or
+/// the scheduling. Bodies that write per-item results, or per-chunk partial results combined in chunk order afterwards,
+/// produce bitwise identical results on any number of threads.
+///
+/// ## Web
+/// Without threads on the web, there are no workers and all work runs inline on the calling thread, in order.
+class JobSystem final {
+public:
+  /// `thread_count` includes the calling thread, so `1` runs everything inline. `0` picks the hardware concurrency.
+  explicit JobSystem(uint32_t thread_count = 0);
+  ~JobSystem();
+
+  JobSystem(JobSystem const&) = delete;
+  JobSystem& operator=(JobSystem const&) = delete;
+
+  /// Number of threads that run work, including the calling thread.
+  uint32_t GetThreadCount() const { return static_cast<uint32_t>(workers_.size()) + 1; }
+
+  /// Run `body(first, count)` over the chunks of [0, `item_count`) and wait for all of them.
+  ///
+  /// Chunks run concurrently and in no particular order; see Determinism.
+  ///
+  /// ## Returns
+  /// `false` if `options.cancellation` was cancelled; some chunks may then have been skipped.
+  bool ParallelFor(
+    uint64_t item_count,
+    std::function<void(uint64_t first, uint64_t count)> const& body,
+    ParallelForOptions const& options = {}
+  );
+
+  /// Run the tasks of `graph`, each once all of its dependencies are done, and wait for all of them.
+  ///
+  /// ## Returns
+  /// `false` if `cancellation` was cancelled; some tasks may then have been skipped.
+  bool Run(TaskGraph const& graph, CancellationToken const* cancellation = nullptr);
+
+private:
+  struct Job final {
+    void (*function)(void* context, uint64_t index) = nullptr;
+    void* context = nullptr;
+    uint64_t index = 0;
+  };
+
+  struct Queue final {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  /// Queue the jobs to the queue of the calling thread.
+  void Push(std::span<Job const> jobs);
+  /// Run one queued job, preferring the queue of the calling thread.
+  bool TryRunOne();
+  /// Run queued jobs until `remaining` drops to zero.
+  void HelpUntilDone(std::atomic<uint64_t> const& remaining);
+  void RunWorker(uint32_t queue_index);
+  uint32_t GetQueueIndex() const;
+
+  // Queue 0 is shared by threads that are not workers; worker `i` owns queue `i + 1`.
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+
+  std::atomic<uint64_t> queued_count_ = 0;
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false; // Guarded by `sleep_mutex_`.
+};
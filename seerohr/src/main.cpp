@@ -1,4 +1,14 @@
-﻿// external headers -------------------------------------
+﻿// c++ headers ------------------------------------------
+#include <cmath>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <optional>
+#include <span>
+#include <vector>
+
+// external headers -------------------------------------
 #include "raylib.h"
 #include "raylib-cpp.hpp"
 
@@ -20,7 +30,14 @@
 #include "asset.h"
 #include "text.h"
 #include "angle.h"
+#include "job_system.h"
+#include "raylib_widgets.h"
 #include "tdc2.h"
+#include "tdc2_convoy.h"
+#include "tdc2_fleet.h"
+#include "tdc2_planner.h"
+#include "tdc2_sim.h"
+#include "tdc2_spatial.h"
 #include "widgets.h"
 
 #if defined(_MSC_VER)
@@ -226,6 +243,26 @@ public:
       ownship_.speed_kn = 0.0f;                // Stationary
     }
 
+    {
+      tdc2::SimShip& sim_ownship = sim_.GetOwnship();
+      sim_ownship.length_m = kOwnshipLength;
+      sim_ownship.beam_m = kOwnshipBeam;
+      sim_ownship.distance_to_aiming_device = ownship_.distance_to_aiming_device;
+
+      sim_.AddTarget(tdc2::SimShip {
+        .length_m = kTargetLength,
+        .beam_m = kTargetBeam,
+      });
+      sim_.SetTrackedTarget(0);
+    }
+
+#if !MBASE_PLATFORM_WEB
+    // Answer from a firing table made by seerohr_tablegen where it covers the scenario, if there is one.
+    if (std::optional<tdc2::FiringTable> firing_table = tdc2::FiringTable::Open("firing_table.bin"); firing_table.has_value()) {
+      tdc_.SetFiringTable(std::make_shared<tdc2::FiringTable const>(std::move(firing_table.value())));
+    }
+#endif
+
     im_font_ = im_font;
 
     // Setup custom ImGui style for a cleaner look
@@ -313,12 +350,54 @@ public:
       show_tdc_panel_ = !show_tdc_panel_;
     }
 
+    // While the simulation runs, the ownship moves with it and the TDC takes the target as observed there. Otherwise the
+    // simulated target follows the TDC inputs, ready to play forward from them.
+    {
+      tdc2::SimShip& sim_ownship = sim_.GetOwnship();
+      sim_ownship.course = ownship_.course;
+      sim_ownship.speed_kn = ownship_.speed_kn;
+
+      if (sim_running_) {
+        sim_.Advance(GetFrameTime(), time_compression_, kMaxSimStepsPerFrame);
+        ownship_.position = ToRaylib(sim_ownship.position);
+        tdc_.SetTargetInputs(sim_.ObserveTarget(0));
+      }
+      else {
+        sim_ownship.position = ToVec2(ownship_.position);
+        sim_.PlaceTarget(0, tdc_.GetInputs(ownship_.course, ownship_.GetAimingDevicePosition()));
+      }
+      sim_.SetTdcSettings(tdc_.GetInputs(ownship_.course, ownship_.GetAimingDevicePosition()));
+    }
+
+    if (scaling_benchmark_.has_value()) {
+      this->StepScalingBenchmark();
+    }
+
 #if 1
-    tdc_.Update(ownship_.course, ownship_.GetAimingDevicePosition());
+    {
+      auto const start_time = std::chrono::steady_clock::now();
+      tdc_.Update(ownship_.course, ownship_.GetAimingDevicePosition(), &job_system_);
+      tdc_solve_ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+    }
 #endif
+
+    if (fleet_mode_) {
+      this->UpdateFleet();
+    }
+
+    if (planner_enabled_) {
+      this->UpdateFiringPlan();
+    }
+    if (course_sweep_enabled_) {
+      this->UpdateCourseSweep();
+    }
+
+    this->UpdateHover();
   }
 
   void Draw() {
+    tdc_.AcquireSolution();
+
     BeginDrawing();
 
     ClearBackground(RAYWHITE);
@@ -333,8 +412,6 @@ public:
       rlPopMatrix();
 
       // Ownship - U-boat silhouette
-      constexpr float kOwnshipBeam = 6.21f;
-      constexpr float kOwnshipLength = 72.39f;
       constexpr float kMinScreenLength = 80.0f;  // Minimum 80 pixels on screen
       DrawUBoatSilhouette(
         ownship_.position,
@@ -346,23 +423,51 @@ public:
         kMinScreenLength
       );
 
+      if (fleet_mode_) {
+        this->DrawFleet(kMinScreenLength);
+      }
+
+      if (course_sweep_enabled_) {
+        if (std::optional<std::size_t> const best = course_sweep_.GetMinGyroAngleIndex(); best.has_value()) {
+          Vec2 const direction = tdc2::ComputeCourseDirection(Angle(course_sweep_.GetSamples()[best.value()].course));
+          DrawLineEx(ownship_.position, ToRaylib(ToVec2(ownship_.position) + direction * (4.0f * kOwnshipLength)), 2.0f, Fade(ORANGE, 0.8f));
+        }
+      }
+
+      if (planner_enabled_ && planner_firing_position_.has_value()) {
+        DrawCircleLinesV(ToRaylib(planner_firing_position_.value()), kOwnshipLength, Fade(DARKGREEN, 0.8f));
+      }
+
+      if (hovered_target_id_.has_value()) {
+        tdc2::TargetTable const& targets = tdc_.GetTargets();
+        if (std::optional<std::size_t> const index = targets.FindIndex(hovered_target_id_.value()); index.has_value()) {
+          if (std::optional<Vec2> const position = targets.GetPosition(index.value()); position.has_value()) {
+            DrawCircleLinesV(ToRaylib(position.value()), 0.6f * kTargetLength, Fade(ORANGE, 0.8f));
+          }
+        }
+      }
+
       EndMode2D();
     }
 
-    constexpr float kTargetBeam = 17.3f;
-    constexpr float kTargetLength = 134.0f;
-
 #if 1
-    tdc_.DrawVisualization(
-      camera_,
-      ownship_.position,
-      ownship_.GetAimingDevicePosition(),
-      ownship_.course,
-      kTargetBeam,
-      kTargetLength
-    );
+    {
+      // Includes handing the batch to the GPU, as drawing ends with `EndMode2D`; not the GPU's own time.
+      auto const start_time = std::chrono::steady_clock::now();
+      tdc_.DrawVisualization(
+        camera_,
+        ownship_.position,
+        ownship_.GetAimingDevicePosition(),
+        ownship_.course,
+        kTargetBeam,
+        kTargetLength
+      );
+      tdc_draw_ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+    }
 #endif
 
+    DrawTorpedoes();
+
     {
       raylib::Vector2 const mouse_pos = raylib::Mouse::GetPosition();
       raylib::Vector2 const mouse_world_pos = GetScreenToWorld2D(mouse_pos, camera_);
@@ -401,6 +506,8 @@ public:
       // Top-left overlay panel (no window decorations)
       DrawOverlayPanel();
 
+      this->DrawHoverTooltip();
+
       // Bottom TDC panel (fixed, no window decorations)
       if (show_tdc_panel_) {
         DrawTdcBottomPanel();
@@ -416,6 +523,418 @@ public:
   }
 
 private:
+  static constexpr float kOwnshipBeam = 6.21f;
+  static constexpr float kOwnshipLength = 72.39f;
+  static constexpr float kTargetBeam = 17.3f;
+  static constexpr float kTargetLength = 134.0f;
+
+  /// Simulated time beyond this many steps per frame is dropped, slowing the simulation down rather than the frame rate.
+  static constexpr uint32_t kMaxSimStepsPerFrame = 4096;
+
+  static constexpr int kMaxWingmanCount = 49;
+  static constexpr float kWingmanSpacingM = 400.0f;
+  static constexpr float kFleetGridCellM = 1000.0f;
+
+  /// Least distance on screen within which the mouse picks a boat or a target, however small it is drawn.
+  static constexpr float kPickRadiusPx = 12.0f;
+
+  static constexpr int kMaxConvoyShipCount = 100'000;
+  /// Between the ownship and the nearest escort of a generated convoy.
+  static constexpr float kConvoyStandOffM = 4000.0f;
+
+  static constexpr int kMinPlannerCandidateCount = 64;
+  static constexpr int kMaxPlannerCandidateCount = 16'384;
+  /// Ownship courses of a course sweep: Every 0.1 degrees.
+  static constexpr uint32_t kCourseSweepCount = 3600;
+
+  static constexpr std::array<std::size_t, 6> kScalingBenchmarkShipCounts = { 1, 10, 100, 1'000, 10'000, 100'000 };
+  /// Frames measured per convoy, after the first, whose solve starts cold.
+  static constexpr uint32_t kScalingBenchmarkFrameCount = 30;
+
+  struct ScalingBenchmarkResult final {
+    std::size_t ship_count = 0;
+    double solve_ms = 0.0;  // Mean per frame.
+    double draw_ms = 0.0;   // Mean per frame.
+    std::size_t bytes_per_contact = 0;
+  };
+
+  /// Progress of a scaling benchmark, which runs over many frames so that drawing is measured as it is presented.
+  struct ScalingBenchmark final {
+    std::size_t step = 0;   // Into `kScalingBenchmarkShipCounts`.
+    uint32_t frame = 0;     // Since the convoy of `step` was loaded.
+    double solve_ms_sum = 0.0;
+    double draw_ms_sum = 0.0;
+    std::vector<tdc2::TargetData> saved_targets; // Restored when done.
+  };
+
+  /// A convoy of `ship_count` ships crossing ahead of the ownship from port to starboard, as TDC targets.
+  std::vector<tdc2::TargetData> GenerateConvoyTargets(std::size_t ship_count, uint32_t seed) const {
+    tdc2::ConvoySpec spec = tdc2::ConvoySpec::ForShipCount(ship_count, seed);
+    spec.base_course = (ownship_.course + Angle::RightAngle()).WrapAround();
+
+    // The columns run across the ownship's course; the screen lies beyond the outermost of them.
+    float const half_width_m = 0.5f * static_cast<float>(spec.column_count - 1) * spec.column_spacing_m;
+    spec.center = ToVec2(ownship_.position) + tdc2::ComputeCourseDirection(ownship_.course) * (half_width_m + spec.screen_distance_m + kConvoyStandOffM);
+
+    Vec2 const aiming_device_position = ToVec2(ownship_.GetAimingDevicePosition());
+    std::vector<tdc2::TargetData> targets;
+    targets.reserve(spec.GetShipCount());
+    for (tdc2::ConvoyShip const& ship : tdc2::GenerateConvoy(spec)) {
+      targets.push_back(tdc2::ComputeTargetData(aiming_device_position, ownship_.course, ship.position, ship.course, ship.speed_kn));
+    }
+    return targets;
+  }
+
+  void StartScalingBenchmark() {
+    tdc2::TargetTable const& targets = tdc_.GetTargets();
+    std::vector<tdc2::TargetData> saved_targets(targets.GetCount());
+    for (std::size_t i = 0; i < saved_targets.size(); ++i) {
+      saved_targets[i] = targets.GetTarget(i);
+    }
+
+    scaling_benchmark_results_.clear();
+    scaling_benchmark_ = ScalingBenchmark { .saved_targets = std::move(saved_targets) };
+  }
+
+  /// Once per frame before the TDC solves: Loads the next convoy, or takes in the times of the last frame.
+  void StepScalingBenchmark() {
+    ScalingBenchmark& benchmark = scaling_benchmark_.value();
+    std::size_t const ship_count = kScalingBenchmarkShipCounts[benchmark.step];
+
+    if (benchmark.frame == 0) {
+      tdc_.SetTargets(this->GenerateConvoyTargets(ship_count, static_cast<uint32_t>(convoy_seed_)));
+    }
+    else if (benchmark.frame >= 2) {
+      benchmark.solve_ms_sum += tdc_solve_ms_;
+      benchmark.draw_ms_sum += tdc_draw_ms_;
+    }
+
+    if (benchmark.frame < kScalingBenchmarkFrameCount + 1) {
+      ++benchmark.frame;
+      return;
+    }
+
+    ScalingBenchmarkResult const result {
+      .ship_count = ship_count,
+      .solve_ms = benchmark.solve_ms_sum / kScalingBenchmarkFrameCount,
+      .draw_ms = benchmark.draw_ms_sum / kScalingBenchmarkFrameCount,
+      .bytes_per_contact = tdc_.GetTargets().GetMemoryUsage() / ship_count,
+    };
+    scaling_benchmark_results_.push_back(result);
+
+    benchmark.step += 1;
+    benchmark.frame = 0;
+    benchmark.solve_ms_sum = 0.0;
+    benchmark.draw_ms_sum = 0.0;
+    if (benchmark.step == kScalingBenchmarkShipCounts.size()) {
+      tdc_.SetTargets(benchmark.saved_targets);
+      scaling_benchmark_.reset();
+    }
+  }
+
+  /// The ownship leads the fleet with the TDC's torpedoes; the other boats keep station in line abreast, alternately to
+  /// starboard and to port, with alternating torpedo presets. Every boat engages every target of the TDC.
+  void UpdateFleet() {
+    fleet_.resize(static_cast<std::size_t>(wingman_count_) + 1);
+    Vec2 const ownship_position = ToVec2(ownship_.position);
+    Vec2 const starboard = { ownship_.course.Cos(), ownship_.course.Sin() };
+    for (std::size_t i = 0; i < fleet_.size(); ++i) {
+      float const station = static_cast<float>((i + 1) / 2) * ((i % 2 == 1) ? 1.0f : -1.0f);
+      fleet_[i] = tdc2::FleetOwnship {
+        .position = ownship_position + starboard * (station * kWingmanSpacingM),
+        .course = ownship_.course,
+        .distance_to_aiming_device = ownship_.distance_to_aiming_device,
+        .torpedo_spec = (i == 0)
+          ? tdc_.GetTorpedoSpec()
+          : tdc2::GetTorpedoPresetSpec((i % 4 < 2) ? tdc2::TorpedoPreset::kG7a : tdc2::TorpedoPreset::kG7e),
+      };
+    }
+
+    tdc2::TargetTable const& targets = tdc_.GetTargets();
+    Vec2 const aiming_device_position = ToVec2(ownship_.GetAimingDevicePosition());
+    contacts_.resize(targets.GetCount());
+    for (std::size_t i = 0; i < targets.GetCount(); ++i) {
+      tdc2::TargetData const target = targets.GetTarget(i);
+      contacts_[i] = tdc2::FleetContact {
+        .position = tdc2::ComputeTargetPosition(aiming_device_position, ownship_.course, target.target_bearing, target.target_range_m),
+        .course = tdc2::ComputeAbsoluteTargetBearing(ownship_.course, target.target_bearing) + Angle::Pi() - target.angle_on_bow,
+        .speed_kn = target.target_speed_kn,
+      };
+    }
+
+    auto const start_time = std::chrono::steady_clock::now();
+    engagements_.Solve(fleet_, contacts_, &job_system_);
+    engagement_solve_ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+
+    fleet_positions_.resize(fleet_.size());
+    for (std::size_t i = 0; i < fleet_.size(); ++i) {
+      fleet_positions_[i] = fleet_[i].position;
+    }
+    fleet_grid_.Update(fleet_positions_);
+  }
+
+  tdc2::SimShip GetOwnshipAsSimShip() const {
+    return tdc2::SimShip {
+      .position = ToVec2(ownship_.position),
+      .course = ownship_.course,
+      .speed_kn = ownship_.speed_kn,
+      .length_m = kOwnshipLength,
+      .beam_m = kOwnshipBeam,
+      .distance_to_aiming_device = ownship_.distance_to_aiming_device,
+    };
+  }
+
+  /// The active target, where the TDC inputs `inputs` put it in the world.
+  tdc2::SimShip GetActiveTargetAsSimShip(tdc2::TdcInputs const& inputs) const {
+    return tdc2::SimShip {
+      .position = tdc2::ComputeTargetPosition(inputs.aiming_device_position, ownship_.course, inputs.target_bearing, inputs.target_range_m),
+      .course = tdc2::ComputeAbsoluteTargetBearing(ownship_.course, inputs.target_bearing) + Angle::Pi() - inputs.angle_on_bow,
+      .speed_kn = inputs.target_speed_kn,
+      .length_m = kTargetLength,
+      .beam_m = kTargetBeam,
+    };
+  }
+
+  /// A vertical line over the last plot, at `index` of its `count` values.
+  static void DrawPlotMarker(float index, std::size_t count, ImU32 color) {
+    if (count < 2) {
+      return;
+    }
+    ImVec2 const min = ImGui::GetItemRectMin();
+    ImVec2 const max = ImGui::GetItemRectMax();
+    ImVec2 const padding = ImGui::GetStyle().FramePadding;
+    float const x = min.x + padding.x + index / static_cast<float>(count - 1) * (max.x - min.x - 2.0f * padding.x);
+    ImGui::GetWindowDrawList()->AddLine(ImVec2(x, min.y + padding.y), ImVec2(x, max.y - padding.y), color, 2.0f);
+  }
+
+  /// When to fire at the active target within the horizon, with both ships holding course and speed.
+  void UpdateFiringPlan() {
+    tdc2::TdcInputs const inputs = tdc_.GetInputs(ownship_.course, ownship_.GetAimingDevicePosition());
+    tdc2::SimShip const ownship = this->GetOwnshipAsSimShip();
+    tdc2::SimShip const target = this->GetActiveTargetAsSimShip(inputs);
+    tdc2::FiringPlanOptions const options {
+      .horizon_s = planner_horizon_min_ * 60.0f,
+      .candidate_count = static_cast<uint32_t>(planner_candidate_count_),
+    };
+
+    auto const start_time = std::chrono::steady_clock::now();
+    planner_.Plan(inputs.torpedo_spec, ownship, target, options, &job_system_);
+    planner_solve_ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+
+    std::span<tdc2::FiringPlanCandidate const> const candidates = planner_.GetCandidates();
+    planner_quality_.resize(candidates.size());
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+      planner_quality_[i] = 1.0f - candidates[i].score;
+    }
+
+    planner_firing_position_.reset();
+    if (std::optional<std::size_t> const best = planner_.GetBestIndex(); best.has_value()) {
+      float const distance_m = ownship.speed_kn * 1852.0f / 3600.0f * candidates[best.value()].time_s;
+      planner_firing_position_ = ownship.position + tdc2::ComputeCourseDirection(ownship.course) * distance_m;
+    }
+  }
+
+  /// Quality, 1 - score, over the horizon, with the best time marked.
+  void DrawFiringPlan() const {
+    std::optional<std::size_t> const best = planner_.GetBestIndex();
+    if (planner_quality_.empty()) {
+      return;
+    }
+
+    ImGui::PlotLines(
+      "##firing_plan", planner_quality_.data(), static_cast<int>(planner_quality_.size()), 0, nullptr, 0.0f, 1.0f, ImVec2(0.0f, 80.0f)
+    );
+    if (best.has_value()) {
+      DrawPlotMarker(static_cast<float>(best.value()), planner_quality_.size(), IM_COL32(255, 161, 0, 255));
+    }
+
+    if (best.has_value()) {
+      tdc2::FiringPlanCandidate const& candidate = planner_.GetCandidates()[best.value()];
+      ImGui::Text(
+        "%s: +%.0f s  %.1f deg  %.0f m  %.2f deg", GetText(TextId::kBestTime), candidate.time_s,
+        Angle(candidate.gyro_angle).ToDeg(), candidate.run_distance_m, Angle(candidate.hit_window).ToDeg()
+      );
+    }
+    else {
+      ImGui::TextDisabled("%s", GetText(TextId::kNoSolution));
+    }
+    ImGui::Text("%s: %.2f", GetText(TextId::kSolveMs), planner_solve_ms_);
+  }
+
+  /// Every course of the ownship against the active target, which keeps its place in the world. Solved only when either
+  /// has moved, or the TDC inputs have changed.
+  void UpdateCourseSweep() {
+    tdc2::TdcInputs const inputs = tdc_.GetInputs(ownship_.course, ownship_.GetAimingDevicePosition());
+
+    auto const start_time = std::chrono::steady_clock::now();
+    if (!course_sweep_.Sweep(inputs.torpedo_spec, this->GetOwnshipAsSimShip(), this->GetActiveTargetAsSimShip(inputs), kCourseSweepCount, &job_system_)) {
+      return;
+    }
+    course_sweep_solve_ms_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+
+    std::span<tdc2::CourseSweepSample const> const samples = course_sweep_.GetSamples();
+    course_sweep_gyro_deg_.resize(samples.size());
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+      course_sweep_gyro_deg_[i] = samples[i].valid ? std::abs(Angle(samples[i].gyro_angle).ToDeg()) : 180.0f;
+    }
+  }
+
+  /// Gyro angle magnitude over the ownship course, with the current course and the best ones marked.
+  void DrawCourseSweep() const {
+    if (course_sweep_gyro_deg_.empty()) {
+      return;
+    }
+
+    std::span<tdc2::CourseSweepSample const> const samples = course_sweep_.GetSamples();
+    std::size_t const count = course_sweep_gyro_deg_.size();
+    ImGui::PlotLines("##course_sweep", course_sweep_gyro_deg_.data(), static_cast<int>(count), 0, nullptr, 0.0f, 180.0f, ImVec2(0.0f, 80.0f));
+    float const course_index = ownship_.course.WrapAround().AsRad() / (2.0f * Angle::Pi().AsRad()) * static_cast<float>(count);
+    DrawPlotMarker(course_index, count, IM_COL32(230, 235, 240, 255));
+
+    struct BestCourse final {
+      TextId label;
+      std::optional<std::size_t> index;
+      ImVec4 color;
+    };
+    for (BestCourse const& best : {
+      BestCourse { TextId::kMinGyroAngle, course_sweep_.GetMinGyroAngleIndex(), ImVec4(1.0f, 0.63f, 0.0f, 1.0f) },
+      BestCourse { TextId::kMinParallax, course_sweep_.GetMinParallaxDeltaIndex(), ImVec4(0.4f, 0.7f, 1.0f, 1.0f) },
+    }) {
+      if (!best.index.has_value()) {
+        ImGui::TextDisabled("%s: %s", GetText(best.label), GetText(TextId::kNoSolution));
+        continue;
+      }
+      tdc2::CourseSweepSample const& sample = samples[best.index.value()];
+      DrawPlotMarker(static_cast<float>(best.index.value()), count, ImGui::ColorConvertFloat4ToU32(best.color));
+
+      // Which way to turn onto it, the shorter way round.
+      Angle const turn = (Angle(sample.course) - ownship_.course + Angle::Pi()).WrapAround() - Angle::Pi();
+      ImGui::TextColored(
+        best.color, "%s: %.1f deg (%s %.1f deg), %.1f deg",
+        GetText(best.label), Angle(sample.course).ToDeg(), turn.AsRad() >= 0.0f ? "R" : "L", turn.Abs().ToDeg(),
+        Angle(sample.gyro_angle).ToDeg()
+      );
+    }
+    ImGui::Text("%s: %.2f", GetText(TextId::kSolveMs), course_sweep_solve_ms_);
+  }
+
+  /// What is under the mouse, as of this frame's solve. Clicking a target makes it the active one.
+  void UpdateHover() {
+    hovered_target_id_.reset();
+    hovered_boat_.reset();
+    if (ImGui::GetIO().WantCaptureMouse) {
+      return;
+    }
+
+    Vec2 const mouse_world_position = ToVec2(GetScreenToWorld2D(raylib::Mouse::GetPosition(), camera_));
+    float const pick_radius_m = kPickRadiusPx / camera_.GetZoom();
+    if (fleet_mode_) {
+      hovered_boat_ = fleet_grid_.FindNearest(mouse_world_position, std::max(0.5f * kOwnshipLength, pick_radius_m));
+    }
+    if (!hovered_boat_.has_value()) {
+      hovered_target_id_ = tdc_.FindTargetAt(mouse_world_position, std::max(0.5f * kTargetLength, pick_radius_m));
+    }
+
+    if (hovered_target_id_.has_value() && IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+      tdc_.SelectTarget(hovered_target_id_.value());
+    }
+  }
+
+  void DrawHoverTooltip() const {
+    if (hovered_boat_.has_value()) {
+      ImGui::SetTooltip("%s #%u", GetText(TextId::kFleet), hovered_boat_.value());
+      return;
+    }
+    if (!hovered_target_id_.has_value()) {
+      return;
+    }
+    tdc2::TargetTable const& targets = tdc_.GetTargets();
+    if (std::optional<std::size_t> const index = targets.FindIndex(hovered_target_id_.value()); index.has_value()) {
+      tdc2::TargetData const target = targets.GetTarget(index.value());
+      ImGui::SetTooltip(
+        "%s #%u  %.0f deg  %.0f m", GetText(TextId::kTarget),
+        hovered_target_id_.value(), target.target_bearing.WrapAround().ToDeg(), target.target_range_m
+      );
+    }
+  }
+
+  void DrawFleet(float min_screen_length) const {
+    tdc2::ParallaxCorrectionBatchOutput const& pc_output = engagements_.GetParallaxOutputs();
+
+    // The boats in view; the ownship is drawn on its own.
+    {
+      float const margin = std::max(kOwnshipLength, min_screen_length / camera_.GetZoom());
+      Vec2 const view_min = ToVec2(GetScreenToWorld2D(raylib::Vector2(0.0f, 0.0f), camera_));
+      Vec2 const view_max = ToVec2(GetScreenToWorld2D(
+        raylib::Vector2(static_cast<float>(GetScreenWidth()), static_cast<float>(GetScreenHeight())),
+        camera_
+      ));
+      fleet_grid_.ForEachInBox(view_min - Vec2 { margin, margin }, view_max + Vec2 { margin, margin }, [&](uint32_t o) {
+        if (o == 0 || engagements_.GetOwnshipCount() <= o) {
+          return;
+        }
+        DrawUBoatSilhouette(
+          ToRaylib(fleet_[o].position),
+          kOwnshipLength,
+          kOwnshipBeam,
+          fleet_[o].course,
+          Color { 130, 140, 150, 255 },
+          camera_.GetZoom(),
+          min_screen_length
+        );
+      });
+    }
+
+    // Torpedo runs, straight from the aiming device as a stand-in for the track.
+    for (std::size_t o = 0; o < engagements_.GetOwnshipCount(); ++o) {
+      raylib::Vector2 const aiming_device_position = ToRaylib(fleet_[o].GetAimingDevicePosition());
+      for (std::size_t t = 0; t < engagements_.GetTargetCount(); ++t) {
+        std::size_t const i = engagements_.GetIndex(o, t);
+        if (pc_output.valid[i] == 0) {
+          continue;
+        }
+        raylib::Vector2 const impact_position = raylib::Vector2 { pc_output.impact_x[i], pc_output.impact_y[i] };
+        DrawLineEx(aiming_device_position, impact_position, 1.5f, Fade(ORANGE, 0.25f));
+        DrawCircleV(impact_position, 5.0f, Fade(ORANGE, 0.4f));
+      }
+    }
+  }
+
+  void DrawTorpedoes() const {
+    constexpr float kTrackStepM = 25.0f;
+
+    BeginMode2D(camera_);
+
+    for (tdc2::SimTorpedo const& torpedo : sim_.GetTorpedoes()) {
+      Color const color =
+        (torpedo.state == tdc2::SimTorpedoState::kRunning) ? Color { 30, 60, 120, 255 } :
+        (torpedo.state == tdc2::SimTorpedoState::kHit)     ? Color { 200, 40, 40, 255 } :
+                                                             Color { 120, 120, 120, 255 };
+
+      // Wake, along the track run so far.
+      raylib::Vector2 previous = ToRaylib(torpedo.tube_position);
+      for (float run_distance_m = kTrackStepM; ; run_distance_m += kTrackStepM) {
+        run_distance_m = std::min(run_distance_m, torpedo.run_distance_m);
+        raylib::Vector2 const current = ToRaylib(tdc2::ComputeTorpedoTrackPosition(
+          torpedo.spec,
+          torpedo.tube_position,
+          torpedo.launch_course,
+          torpedo.gyro_angle,
+          run_distance_m
+        ));
+        DrawLineEx(previous, current, 2.0f, Fade(color, 0.3f));
+        previous = current;
+        if (run_distance_m >= torpedo.run_distance_m) {
+          break;
+        }
+      }
+
+      DrawCircleV(ToRaylib(torpedo.position), std::max(3.0f, 4.0f / camera_.GetZoom()), color);
+    }
+
+    EndMode2D();
+  }
+
   void DrawOverlayPanel() {
     ImGuiWindowFlags window_flags = 
       ImGuiWindowFlags_NoDecoration |
@@ -457,7 +976,104 @@ private:
 
       // U-Boat section
       ImGui::TextColored(ImVec4(0.4f, 0.7f, 1.0f, 1.0f), "U-Boat");
-      ownship_.course.ImGuiSliderDegWithId("Course", 0.0f, 359.99f, "%.1f", "%s (deg)", GetText(TextId::kCourse));
+      SliderAngleDegWithId("Course", &ownship_.course, 0.0f, 359.99f, "%.1f", "%s (deg)", GetText(TextId::kCourse));
+      SliderFloatWithId("Speed", &ownship_.speed_kn, 0.0f, 18.0f, "%.1f", ImGuiSliderFlags_None, "%s (kn)", GetText(TextId::kSpeed));
+
+      ImGui::Separator();
+
+      // Simulation section
+      ImGui::TextColored(ImVec4(0.4f, 0.7f, 1.0f, 1.0f), "%s", GetText(TextId::kSimulation));
+      if (ImGui::Button(sim_running_ ? GetText(TextId::kPause) : GetText(TextId::kRun))) {
+        sim_running_ = !sim_running_;
+      }
+      ImGui::SameLine();
+      if (ImGui::Button(GetText(TextId::kFire))) {
+        sim_.Fire();
+      }
+      SliderFloatWithId(
+        "TimeCompression", &time_compression_,
+        tdc2::Simulation::kMinTimeCompression, tdc2::Simulation::kMaxTimeCompression,
+        "%.0fx", ImGuiSliderFlags_Logarithmic, "%s", GetText(TextId::kTimeCompression)
+      );
+      {
+        std::span<tdc2::SimTorpedo const> const torpedoes = sim_.GetTorpedoes();
+        std::size_t const hit_count = std::count_if(torpedoes.begin(), torpedoes.end(), [](tdc2::SimTorpedo const& torpedo) {
+          return torpedo.state == tdc2::SimTorpedoState::kHit;
+        });
+        ImGui::Text("%s: %.1f s", GetText(TextId::kSimulationTime), sim_.GetTime());
+        ImGui::Text("%s: %zu / %zu", GetText(TextId::kHits), hit_count, torpedoes.size());
+      }
+
+      ImGui::Separator();
+
+      // Fleet section
+      ImGui::Checkbox(GetText(TextId::kFleet), &fleet_mode_);
+      if (fleet_mode_) {
+        ImGui::SliderInt(GetText(TextId::kWingmen), &wingman_count_, 1, kMaxWingmanCount);
+        std::vector<uint8_t> const& valid = engagements_.GetParallaxOutputs().valid;
+        ImGui::Text(
+          "%s: %zu / %zu x %zu (%.2f ms)", GetText(TextId::kEngagements),
+          static_cast<std::size_t>(std::count(valid.begin(), valid.end(), uint8_t(1))),
+          engagements_.GetOwnshipCount(), engagements_.GetTargetCount(), engagement_solve_ms_
+        );
+      }
+
+      ImGui::Separator();
+
+      // Convoy section
+      ImGui::TextColored(ImVec4(0.4f, 0.7f, 1.0f, 1.0f), "%s", GetText(TextId::kConvoy));
+      ImGui::BeginDisabled(scaling_benchmark_.has_value());
+      ImGui::SliderInt(GetText(TextId::kShips), &convoy_ship_count_, 1, kMaxConvoyShipCount, "%d", ImGuiSliderFlags_Logarithmic);
+      ImGui::InputInt(GetText(TextId::kSeed), &convoy_seed_);
+      if (ImGui::Button(GetText(TextId::kGenerate))) {
+        tdc_.SetTargets(this->GenerateConvoyTargets(static_cast<std::size_t>(convoy_ship_count_), static_cast<uint32_t>(convoy_seed_)));
+      }
+      ImGui::SameLine();
+      if (ImGui::Button(GetText(TextId::kScalingBenchmark))) {
+        this->StartScalingBenchmark();
+      }
+      ImGui::EndDisabled();
+      if (scaling_benchmark_.has_value()) {
+        ImGui::SameLine();
+        ImGui::Text("%zu / %zu", scaling_benchmark_->step + 1, kScalingBenchmarkShipCounts.size());
+      }
+      if (!scaling_benchmark_results_.empty() && ImGui::BeginTable("##scaling_benchmark", 4)) {
+        ImGui::TableSetupColumn(GetText(TextId::kContacts));
+        ImGui::TableSetupColumn(GetText(TextId::kSolveMs));
+        ImGui::TableSetupColumn(GetText(TextId::kDrawMs));
+        ImGui::TableSetupColumn(GetText(TextId::kBytesPerContact));
+        ImGui::TableHeadersRow();
+        for (ScalingBenchmarkResult const& result : scaling_benchmark_results_) {
+          ImGui::TableNextRow();
+          ImGui::TableNextColumn();
+          ImGui::Text("%zu", result.ship_count);
+          ImGui::TableNextColumn();
+          ImGui::Text("%.3f", result.solve_ms);
+          ImGui::TableNextColumn();
+          ImGui::Text("%.3f", result.draw_ms);
+          ImGui::TableNextColumn();
+          ImGui::Text("%zu", result.bytes_per_contact);
+        }
+        ImGui::EndTable();
+      }
+
+      ImGui::Separator();
+
+      // Planner section
+      ImGui::Checkbox(GetText(TextId::kFiringPlanner), &planner_enabled_);
+      if (planner_enabled_) {
+        SliderFloatWithId("Horizon", &planner_horizon_min_, 1.0f, 30.0f, "%.0f", ImGuiSliderFlags_None, "%s (min)", GetText(TextId::kHorizon));
+        ImGui::SliderInt(
+          GetText(TextId::kCandidates), &planner_candidate_count_, kMinPlannerCandidateCount, kMaxPlannerCandidateCount, "%d",
+          ImGuiSliderFlags_Logarithmic
+        );
+        this->DrawFiringPlan();
+      }
+
+      ImGui::Checkbox(GetText(TextId::kCourseSweep), &course_sweep_enabled_);
+      if (course_sweep_enabled_) {
+        this->DrawCourseSweep();
+      }
 
 #if 0
       {
@@ -546,6 +1162,43 @@ private:
 
   tdc2::Tdc tdc_;
 
+  tdc2::Simulation sim_;
+  bool sim_running_ = false;
+  float time_compression_ = 1.0f;
+
+  bool fleet_mode_ = false;
+  int wingman_count_ = 3;
+  std::vector<tdc2::FleetOwnship> fleet_;
+  std::vector<tdc2::FleetContact> contacts_;
+  tdc2::EngagementMatrix engagements_;
+  double engagement_solve_ms_ = 0.0;
+  JobSystem job_system_;
+  std::vector<Vec2> fleet_positions_;
+  tdc2::SpatialGrid fleet_grid_ { kFleetGridCellM };
+
+  std::optional<tdc2::TargetId> hovered_target_id_;
+  std::optional<uint32_t> hovered_boat_; // Index into `fleet_`.
+
+  int convoy_ship_count_ = 51;
+  int convoy_seed_ = 1;
+  std::optional<ScalingBenchmark> scaling_benchmark_;
+  std::vector<ScalingBenchmarkResult> scaling_benchmark_results_;
+  double tdc_solve_ms_ = 0.0;
+  double tdc_draw_ms_ = 0.0;
+
+  bool planner_enabled_ = false;
+  float planner_horizon_min_ = 10.0f;
+  int planner_candidate_count_ = 4096;
+  tdc2::FiringPlanner planner_;
+  std::vector<float> planner_quality_; // Per candidate, for plotting.
+  std::optional<Vec2> planner_firing_position_; // Of the ownship, at the best time.
+  double planner_solve_ms_ = 0.0;
+
+  bool course_sweep_enabled_ = false;
+  tdc2::CourseSweep course_sweep_;
+  std::vector<float> course_sweep_gyro_deg_; // Per course, for plotting; 180 where there is no solution.
+  double course_sweep_solve_ms_ = 0.0;
+
   bool show_tdc_panel_ = true;
 };
 static State s_state;
@@ -0,0 +1,106 @@
+// TU header --------------------------------------------
+#include "mapped_file.h"
+
+// c++ headers ------------------------------------------
+#include <utility>
+
+// public project headers --------------------------------
+#include "mbase/public/platform.h"
+
+// Platform-specific includes for mapping files
+#if MBASE_PLATFORM_WINDOWS
+# if !defined(WIN32_LEAN_AND_MEAN)
+#  define WIN32_LEAN_AND_MEAN
+# endif
+# if !defined(NOMINMAX)
+#  define NOMINMAX
+# endif
+# include <Windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+std::optional<MappedFile> MappedFile::Open(std::filesystem::path const& path) {
+#if MBASE_PLATFORM_WINDOWS
+  HANDLE const file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return std::nullopt;
+  }
+
+  LARGE_INTEGER size {};
+  if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+    CloseHandle(file);
+    return std::nullopt;
+  }
+
+  HANDLE const mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    return std::nullopt;
+  }
+
+  // The view keeps the mapping alive.
+  void const* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (data == nullptr) {
+    return std::nullopt;
+  }
+
+  return MappedFile(static_cast<std::byte const*>(data), static_cast<std::size_t>(size.QuadPart));
+#else
+  int const fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return std::nullopt;
+  }
+
+  struct stat st {};
+  if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+    ::close(fd);
+    return std::nullopt;
+  }
+
+  // The mapping stays valid after the descriptor is closed.
+  void* const data = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    return std::nullopt;
+  }
+
+  return MappedFile(static_cast<std::byte const*>(data), static_cast<std::size_t>(st.st_size));
+#endif
+}
+
+MappedFile::~MappedFile() {
+  this->Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+  : data_(std::exchange(other.data_, nullptr)),
+    size_(std::exchange(other.size_, 0))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    this->Close();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+  }
+  return *this;
+}
+
+void MappedFile::Close() {
+  if (data_ == nullptr) {
+    return;
+  }
+#if MBASE_PLATFORM_WINDOWS
+  UnmapViewOfFile(data_);
+#else
+  ::munmap(const_cast<std::byte*>(data_), size_);
+#endif
+  data_ = nullptr;
+  size_ = 0;
+}
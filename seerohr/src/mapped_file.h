@@ -0,0 +1,35 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cstddef>
+
+#include <filesystem>
+#include <optional>
+#include <span>
+
+/// Read-only memory mapping of a whole file.
+///
+/// Pages are loaded on first access by the OS, so opening is O(1) regardless of the file size.
+class MappedFile final {
+public:
+  /// Map the file at `path`. Fails for missing or empty files.
+  static std::optional<MappedFile> Open(std::filesystem::path const& path);
+
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(MappedFile const&) = delete;
+  MappedFile& operator=(MappedFile const&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  std::span<std::byte const> GetData() const { return { data_, size_ }; }
+
+private:
+  MappedFile(std::byte const* data, std::size_t size) : data_(data), size_(size) {}
+
+  void Close();
+
+  std::byte const* data_ = nullptr;
+  std::size_t size_ = 0;
+};
@@ -1,15 +1,356 @@
 #pragma once
 
 // c++ headers ------------------------------------------
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 
+#include <array>
+#include <limits>
 #include <optional>
-#include <functional>
+#include <span>
+#include <type_traits>
 
-std::optional<float> FindRootsBisection(
-  std::function<std::optional<float>(float)> const& evaluate,
+// Root finding on a scalar function of one variable.
+//
+// Header-only and free of heap allocations: callables are template parameters, and scan points and roots live in
+// fixed-capacity arrays on the stack, so it can run per frame.
+//
+// A function evaluated at `x` may return `float` or `std::optional<float>`. `std::nullopt` and NaN both mean the function
+// is undefined at `x`; brackets touching such points are skipped.
+
+enum class RootFindingMethod : uint8_t {
+  /// Halve the bracket every iteration. Always converges linearly.
+  kBisection,
+  /// Brent's method: inverse quadratic interpolation and secant steps, falling back to bisection. Superlinear.
+  kBrent,
+  /// Illinois variant of regula falsi: secant steps on the bracket, halving the stale endpoint's value. Superlinear.
+  kIllinois,
+};
+
+struct RootFindingOptions final {
+  RootFindingMethod method = RootFindingMethod::kBrent;
+  /// Tolerance on x: A root is returned once it is bracketed to within this distance.
+  float tolerance = 1e-6f;
+  /// Iterations per bracket before giving up and returning the best estimate.
+  uint32_t max_iterations = 100;
+  /// Equal intervals over [a, b] scanned for sign changes; at most `kMaxRootScanIntervalCount`.
+  /// Roots closer together than an interval may be missed.
+  uint32_t scan_interval_count = 100;
+};
+
+inline constexpr uint32_t kMaxRootScanIntervalCount = 256;
+
+/// Roots found by `FindRoots`, in ascending order, without duplicates closer than the tolerance.
+template <uint32_t kCapacity>
+class RootSet final {
+public:
+  uint32_t Size() const { return count_; }
+  bool IsEmpty() const { return count_ == 0; }
+  float operator[](uint32_t index) const { return roots_[index]; }
+  float const* begin() const { return roots_.data(); }
+  float const* end() const { return roots_.data() + count_; }
+
+  /// Whether roots were dropped because there were more than `kCapacity`; the first `kCapacity` ones are kept.
+  bool IsTruncated() const { return truncated_; }
+
+  /// The root closest to `x`; the lower one on a tie.
+  std::optional<float> FindNearest(float x) const {
+    std::optional<float> nearest;
+    for (float root : *this) {
+      if (!nearest.has_value() || std::abs(root - x) < std::abs(nearest.value() - x)) {
+        nearest = root;
+      }
+    }
+    return nearest;
+  }
+
+  /// Append `root`, which must not be less than the last root, unless it duplicates the last root within `tolerance`.
+  void Append(float root, float tolerance) {
+    if (count_ > 0 && std::abs(root - roots_[count_ - 1]) < tolerance) {
+      return;
+    }
+    if (count_ == kCapacity) {
+      truncated_ = true;
+      return;
+    }
+    roots_[count_++] = root;
+  }
+
+private:
+  std::array<float, kCapacity> roots_ {};
+  uint32_t count_ = 0;
+  bool truncated_ = false;
+};
+
+namespace numerical_detail {
+
+/// Evaluate `evaluate` at `x`, mapping "undefined" to NaN.
+template <typename Evaluate>
+float EvaluateOrNaN(Evaluate const& evaluate, float x) {
+  using Result = std::invoke_result_t<Evaluate const&, float>;
+  if constexpr (std::is_same_v<std::remove_cvref_t<Result>, std::optional<float>>) {
+    return evaluate(x).value_or(std::numeric_limits<float>::quiet_NaN());
+  }
+  else {
+    return static_cast<float>(evaluate(x));
+  }
+}
+
+template <typename Evaluate>
+std::optional<float> SolveBisection(Evaluate const& evaluate, float lo, float hi, float flo, RootFindingOptions const& options) {
+  for (uint32_t iter = 0; iter < options.max_iterations; ++iter) {
+    float const mid = 0.5f * (lo + hi);
+    float const fmid = EvaluateOrNaN(evaluate, mid);
+    if (!std::isfinite(fmid)) {
+      return std::nullopt;
+    }
+    if (fmid == 0.0f || 0.5f * (hi - lo) < options.tolerance) {
+      return mid;
+    }
+    if (flo * fmid < 0.0f) {
+      hi = mid;
+    }
+    else {
+      lo = mid;
+      flo = fmid;
+    }
+  }
+  return 0.5f * (lo + hi);
+}
+
+template <typename Evaluate>
+std::optional<float> SolveIllinois(Evaluate const& evaluate, float a, float b, float fa, float fb, RootFindingOptions const& options) {
+  for (uint32_t iter = 0; iter < options.max_iterations; ++iter) {
+    float c = (a * fb - b * fa) / (fb - fa);
+    if (!(std::fmin(a, b) < c && c < std::fmax(a, b))) {
+      // Rounding put the secant root onto or outside the bracket.
+      c = 0.5f * (a + b);
+    }
+
+    float const fc = EvaluateOrNaN(evaluate, c);
+    if (!std::isfinite(fc)) {
+      return std::nullopt;
+    }
+    if (fc == 0.0f) {
+      return c;
+    }
+
+    if (fc * fb < 0.0f) {
+      a = b;
+      fa = fb;
+    }
+    else {
+      fa *= 0.5f;
+    }
+    b = c;
+    fb = fc;
+
+    if (0.5f * std::abs(b - a) < options.tolerance) {
+      return b;
+    }
+  }
+  return b;
+}
+
+template <typename Evaluate>
+std::optional<float> SolveBrent(Evaluate const& evaluate, float a, float b, float fa, float fb, RootFindingOptions const& options) {
+  constexpr float kEpsilon = std::numeric_limits<float>::epsilon();
+
+  float c = b;
+  float fc = fb;
+  float d = b - a;
+  float e = d;
+
+  for (uint32_t iter = 0; iter < options.max_iterations; ++iter) {
+    if ((fb > 0.0f && fc > 0.0f) || (fb < 0.0f && fc < 0.0f)) {
+      // Keep the root between b and c.
+      c = a;
+      fc = fa;
+      d = b - a;
+      e = d;
+    }
+    if (std::abs(fc) < std::abs(fb)) {
+      // b is the best estimate.
+      a = b;
+      b = c;
+      c = a;
+      fa = fb;
+      fb = fc;
+      fc = fa;
+    }
+
+    float const tol1 = 2.0f * kEpsilon * std::abs(b) + 0.5f * options.tolerance;
+    float const xm = 0.5f * (c - b);
+    if (std::abs(xm) <= tol1 || fb == 0.0f) {
+      return b;
+    }
+
+    if (std::abs(e) >= tol1 && std::abs(fa) > std::abs(fb)) {
+      // Inverse quadratic interpolation, or the secant method if only two points are distinct.
+      float const s = fb / fa;
+      float p = 0.0f;
+      float q = 0.0f;
+      if (a == c) {
+        p = 2.0f * xm * s;
+        q = 1.0f - s;
+      }
+      else {
+        float const qa = fa / fc;
+        float const r = fb / fc;
+        p = s * (2.0f * xm * qa * (qa - r) - (b - a) * (r - 1.0f));
+        q = (qa - 1.0f) * (r - 1.0f) * (s - 1.0f);
+      }
+      if (p > 0.0f) {
+        q = -q;
+      }
+      p = std::abs(p);
+
+      if (2.0f * p < std::fmin(3.0f * xm * q - std::abs(tol1 * q), std::abs(e * q))) {
+        e = d;
+        d = p / q;
+      }
+      else {
+        // Interpolation would leave the bracket or converge too slowly.
+        d = xm;
+        e = d;
+      }
+    }
+    else {
+      d = xm;
+      e = d;
+    }
+
+    a = b;
+    fa = fb;
+    b += (std::abs(d) > tol1) ? d : std::copysign(tol1, xm);
+    fb = EvaluateOrNaN(evaluate, b);
+    if (!std::isfinite(fb)) {
+      return std::nullopt;
+    }
+  }
+  return b;
+}
+
+} // namespace numerical_detail
+
+/// Find a root of `evaluate` in [`lo`, `hi`], given the function values `flo` and `fhi` of opposite signs there.
+///
+/// ## Returns
+/// `std::nullopt` if `evaluate` is undefined somewhere the method samples.
+template <typename Evaluate>
+std::optional<float> FindRootInBracket(
+  Evaluate const& evaluate,
+  float lo,
+  float hi,
+  float flo,
+  float fhi,
+  RootFindingOptions const& options = {}
+) {
+  if (flo == 0.0f) {
+    return lo;
+  }
+  if (fhi == 0.0f) {
+    return hi;
+  }
+
+  switch (options.method) {
+  case RootFindingMethod::kBisection: return numerical_detail::SolveBisection(evaluate, lo, hi, flo, options);
+  case RootFindingMethod::kBrent:     return numerical_detail::SolveBrent(evaluate, lo, hi, flo, fhi, options);
+  case RootFindingMethod::kIllinois:  return numerical_detail::SolveIllinois(evaluate, lo, hi, flo, fhi, options);
+  }
+  return std::nullopt;
+}
+
+/// Same as `FindRoots`, but the bracket scan evaluates all scan points with a single call to `evaluate_batch`, so it can be
+/// vectorized. `evaluate_batch(std::span<float const> xs, std::span<float> ys)` must write NaN where undefined.
+/// `evaluate` refines the brackets as in `FindRoots`.
+template <uint32_t kCapacity = 8, typename Evaluate, typename EvaluateBatch>
+RootSet<kCapacity> FindRootsBatched(
+  Evaluate const& evaluate,
+  EvaluateBatch const& evaluate_batch,
+  float a,
+  float b,
+  RootFindingOptions const& options = {}
+) {
+  uint32_t const interval_count =
+    (options.scan_interval_count < 1) ? 1 :
+    (kMaxRootScanIntervalCount < options.scan_interval_count) ? kMaxRootScanIntervalCount : options.scan_interval_count;
+
+  std::array<float, kMaxRootScanIntervalCount + 1> xs;
+  std::array<float, kMaxRootScanIntervalCount + 1> ys;
+  for (uint32_t i = 0; i <= interval_count; ++i) {
+    xs[i] = a + (b - a) * static_cast<float>(i) / static_cast<float>(interval_count);
+  }
+  evaluate_batch(std::span<float const>(xs.data(), interval_count + 1), std::span<float>(ys.data(), interval_count + 1));
+
+  RootSet<kCapacity> roots;
+  for (uint32_t i = 0; i < interval_count; ++i) {
+    float const x0 = xs[i];
+    float const x1 = xs[i + 1];
+    float const y0 = ys[i];
+    float const y1 = ys[i + 1];
+
+    if (!std::isfinite(y0) || !std::isfinite(y1)) {
+      continue;
+    }
+
+    if (y0 == 0.0f) {
+      roots.Append(x0, options.tolerance);
+    }
+    else if (y0 * y1 < 0.0f) {
+      if (std::optional<float> const root = FindRootInBracket(evaluate, x0, x1, y0, y1, options); root.has_value()) {
+        roots.Append(root.value(), options.tolerance);
+      }
+    }
+    else if (y1 != 0.0f) {
+      // No sign change; catch a root of even multiplicity touching zero in the middle of the interval.
+      // |f| has a local minimum inside the interval then, so it falls towards the interval from both neighbors.
+      bool const falls_from_left = (i == 0) || !(std::abs(ys[i - 1]) < std::abs(y0));
+      bool const falls_from_right = (i + 1 == interval_count) || !(std::abs(ys[i + 2]) < std::abs(y1));
+      if (!falls_from_left || !falls_from_right) {
+        continue;
+      }
+
+      float const xm = 0.5f * (x0 + x1);
+      float const ym = numerical_detail::EvaluateOrNaN(evaluate, xm);
+      if (std::isfinite(ym) && std::abs(ym) < 1e-8f) {
+        roots.Append(xm, options.tolerance);
+      }
+    }
+  }
+  if (ys[interval_count] == 0.0f) {
+    roots.Append(xs[interval_count], options.tolerance);
+  }
+
+  return roots;
+}
+
+/// Find all roots of `evaluate` in [`a`, `b`]: Scan for sign changes at `options.scan_interval_count` equal intervals, then
+/// refine each bracket with `options.method`.
+template <uint32_t kCapacity = 8, typename Evaluate>
+RootSet<kCapacity> FindRoots(
+  Evaluate const& evaluate,
+  float a,
+  float b,
+  RootFindingOptions const& options = {}
+) {
+  auto evaluate_batch = [&evaluate](std::span<float const> xs, std::span<float> ys) {
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+      ys[i] = numerical_detail::EvaluateOrNaN(evaluate, xs[i]);
+    }
+  };
+  return FindRootsBatched<kCapacity>(evaluate, evaluate_batch, a, b, options);
+}
+
+/// The root of `evaluate` in [`a`, `b`] closest to `x`; see `FindRoots`.
+template <uint32_t kCapacity = 8, typename Evaluate>
+std::optional<float> FindRootNearest(
+  Evaluate const& evaluate,
   float a,
   float b,
-  float tol,
-  uint32_t max_iter
-);
+  float x,
+  RootFindingOptions const& options = {}
+) {
+  return FindRoots<kCapacity>(evaluate, a, b, options).FindNearest(x);
+}
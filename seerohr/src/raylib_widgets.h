@@ -6,6 +6,11 @@
 
 // project headers --------------------------------------
 #include "angle.h"
+#include "vec2.h"
+
+/// Conversions between the solver's `Vec2` and the raylib vector type; both share the layout of `::Vector2`.
+inline raylib::Vector2 ToRaylib(Vec2 const& v) { return raylib::Vector2(v.x, v.y); }
+inline Vec2 ToVec2(::Vector2 const& v) { return Vec2 { v.x, v.y }; }
 
 void DrawLineStippled(
   Vector2 startPos, Vector2 endPos, float thick, Color color
@@ -0,0 +1,321 @@
+// c++ headers ------------------------------------------
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <chrono>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <vector>
+
+// project headers --------------------------------------
+#include "job_system.h"
+#include "tdc2_sim.h"
+#include "tdc2_solver.h"
+#include "tool_options.h"
+
+// Headless engagement runner.
+//
+// Plays randomized engagements forward on `tdc2::Simulation` as fast as possible: The TDC tracks the target from the
+// first step, fires once at `--fire-at` with its solution at that time, and the engagement ends when the torpedo hits,
+// expires, or `--time-limit` runs out. Engagements are independent and run in parallel; results are the same on any
+// number of threads.
+//
+// Writes one CSV line per engagement, in order, and a summary on stderr.
+
+namespace {
+
+constexpr float kDegToRad = std::numbers::pi_v<float> / 180.0f;
+constexpr float kRadToDeg = 180.0f / std::numbers::pi_v<float>;
+
+// The target ship drawn by the app.
+constexpr float kTargetLengthM = 134.0f;
+constexpr float kTargetBeamM = 17.3f;
+
+// Engagements per job.
+constexpr uint64_t kChunkEngagementCount = 4;
+
+struct Options final {
+  char const* output_path = nullptr; // Null: stdout.
+  uint32_t seed = 1;
+  uint32_t engagement_count = 100;
+  float fire_at_s = 0.0f;
+  float time_limit_s = 900.0f;
+  float ownship_speed_kn = 0.0f;
+
+  tdc2::TorpedoSpec torpedo_spec = tdc2::GetTorpedoPresetSpec(tdc2::TorpedoPreset::kG7e);
+  tdc2::ParallaxSolveMethod method = tdc2::ParallaxSolveMethod::kGeometry;
+
+  uint32_t thread_count = 0; // 0: One per hardware thread.
+};
+
+enum class EngagementResult {
+  kHit,
+  kMiss,
+  kNoSolution, // The TDC had no solution at the time of firing.
+};
+
+char const* GetEngagementResultName(EngagementResult result) {
+  switch (result) {
+  case EngagementResult::kHit:        return "hit";
+  case EngagementResult::kMiss:       return "miss";
+  case EngagementResult::kNoSolution: return "no_solution";
+  }
+  return "";
+}
+
+struct Engagement final {
+  // Scenario, as the TDC observes it at the start.
+  float target_bearing_deg = 0.0f;
+  float target_range_m = 0.0f;
+  float target_speed_kn = 0.0f;
+  float angle_on_bow_deg = 0.0f;
+
+  // Outcome.
+  EngagementResult result = EngagementResult::kNoSolution;
+  float gyro_angle_deg = 0.0f;
+  float run_time_s = 0.0f;        // Until the hit or the end of the run.
+  float closest_approach_m = 0.0f;
+  uint64_t step_count = 0;
+};
+
+void PrintUsage() {
+  std::fprintf(
+    stderr,
+    "Usage: seerohr_sim [options]\n"
+    "\n"
+    "Options:\n"
+    "  --out <path>                 CSV output file. Default: stdout\n"
+    "  --seed <n>                   Scenario seed. Default: 1\n"
+    "  --count <n>                  Engagements. Default: 100\n"
+    "  --fire-at <s>                Simulated time to fire at. Default: 0\n"
+    "  --time-limit <s>             Simulated time after which an engagement ends. Default: 900\n"
+    "  --ownship-speed <kn>         Ownship speed. Default: 0\n"
+    "  --torpedo <g7a|g7e>          Torpedo preset. Default: g7e\n"
+    "  --method <name>              Parallax solver: geometry, newton or siemens. Default: geometry\n"
+    "  --threads <n>                Worker threads. Default: hardware concurrency\n"
+  );
+}
+
+std::optional<Options> ParseOptions(int argc, char** argv) {
+  Options options;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string_view const arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      return std::nullopt;
+    }
+    if (i + 1 >= argc) {
+      std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+      return std::nullopt;
+    }
+    char const* value = argv[++i];
+    std::string_view const value_sv = value;
+
+    bool ok = true;
+    if (arg == "--out") {
+      options.output_path = (value_sv == "-") ? nullptr : value;
+    }
+    else if (arg == "--seed" || arg == "--count" || arg == "--threads") {
+      std::optional<uint32_t> const parsed = tool_options::ParseUInt32(value_sv);
+      ok = parsed.has_value();
+      if (ok) {
+        uint32_t& field = (arg == "--seed") ? options.seed : (arg == "--count") ? options.engagement_count : options.thread_count;
+        field = parsed.value();
+      }
+    }
+    else if (arg == "--fire-at" || arg == "--time-limit" || arg == "--ownship-speed") {
+      std::optional<float> const parsed = tool_options::ParseFloat(value_sv);
+      ok = parsed.has_value() && parsed.value() >= 0.0f;
+      if (ok) {
+        float& field = (arg == "--fire-at") ? options.fire_at_s : (arg == "--time-limit") ? options.time_limit_s : options.ownship_speed_kn;
+        field = parsed.value();
+      }
+    }
+    else if (arg == "--torpedo") {
+      std::optional<tdc2::TorpedoSpec> const torpedo_spec = tool_options::ParseTorpedoPreset(value_sv);
+      ok = torpedo_spec.has_value();
+      if (ok) {
+        options.torpedo_spec = torpedo_spec.value();
+      }
+    }
+    else if (arg == "--method") {
+      std::optional<tdc2::ParallaxSolveMethod> const method = tool_options::ParseSolveMethod(value_sv);
+      ok = method.has_value();
+      if (ok) {
+        options.method = method.value();
+      }
+    }
+    else {
+      std::fprintf(stderr, "Unknown option: %s\n", argv[i - 1]);
+      return std::nullopt;
+    }
+
+    if (!ok) {
+      std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], value);
+      return std::nullopt;
+    }
+  }
+
+  return options;
+}
+
+/// Uniform in [`min`, `max`). Unlike `std::uniform_real_distribution`, gives the same sequence with every standard library.
+float GetUniform(std::mt19937& rng, float min, float max) {
+  return min + (max - min) * (static_cast<float>(rng() >> 8) * 0x1p-24f);
+}
+
+/// Scenario of engagement `index`; depends on the seed and the index only.
+Engagement MakeEngagement(Options const& options, uint64_t index) {
+  std::mt19937 rng(options.seed ^ static_cast<uint32_t>(index * 0x9E3779B9u));
+  return Engagement {
+    .target_bearing_deg = GetUniform(rng, -180.0f, 180.0f),
+    .target_range_m = GetUniform(rng, 500.0f, 3000.0f),
+    .target_speed_kn = GetUniform(rng, 0.0f, std::min(15.0f, options.torpedo_spec.speed_kn * 0.5f)),
+    .angle_on_bow_deg = GetUniform(rng, -180.0f, 180.0f),
+  };
+}
+
+void RunEngagement(Options const& options, Engagement& engagement) {
+  tdc2::Simulation simulation;
+
+  tdc2::SimShip& ownship = simulation.GetOwnship();
+  ownship.course = Angle::FromDeg(90.0f);
+  ownship.speed_kn = options.ownship_speed_kn;
+
+  // Place the target where the TDC would, from the scenario.
+  tdc2::TorpedoTriangle const triangle {
+    .torpedo_speed_kn = options.torpedo_spec.speed_kn,
+    .target_bearing = Angle::FromDeg(engagement.target_bearing_deg),
+    .target_range_m = engagement.target_range_m,
+    .target_speed_kn = engagement.target_speed_kn,
+    .angle_on_bow = Angle::FromDeg(engagement.angle_on_bow_deg),
+  };
+  std::size_t const target_index = simulation.AddTarget(tdc2::SimShip {
+    .position = tdc2::ComputeTargetPosition(ownship.GetAimingDevicePosition(), ownship.course, triangle.target_bearing, triangle.target_range_m),
+    .course = triangle.PrepareSolve(ownship.course).target_course,
+    .speed_kn = engagement.target_speed_kn,
+    .length_m = kTargetLengthM,
+    .beam_m = kTargetBeamM,
+  });
+
+  simulation.SetTdcSettings(tdc2::TdcInputs {
+    .torpedo_spec = options.torpedo_spec,
+    .pc_method = options.method,
+  });
+  simulation.SetTrackedTarget(target_index);
+
+  bool fired = false;
+  while (simulation.GetTime() < static_cast<double>(options.time_limit_s)) {
+    simulation.Step();
+
+    if (!fired && simulation.GetTime() >= static_cast<double>(options.fire_at_s)) {
+      if (!simulation.Fire()) {
+        break;
+      }
+      fired = true;
+      engagement.gyro_angle_deg = simulation.GetTorpedoes().front().gyro_angle * kRadToDeg;
+    }
+    if (fired && !simulation.HasRunningTorpedo()) {
+      break;
+    }
+  }
+
+  engagement.step_count = simulation.GetStepCount();
+  if (!fired) {
+    engagement.result = EngagementResult::kNoSolution;
+    return;
+  }
+
+  tdc2::SimTorpedo const& torpedo = simulation.GetTorpedoes().front();
+  engagement.result = (torpedo.state == tdc2::SimTorpedoState::kHit) ? EngagementResult::kHit : EngagementResult::kMiss;
+  double const end_time_s = (torpedo.state == tdc2::SimTorpedoState::kRunning) ? simulation.GetTime() : torpedo.end_time_s;
+  engagement.run_time_s = static_cast<float>(end_time_s - torpedo.launch_time_s);
+  engagement.closest_approach_m = torpedo.closest_approach_m;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::optional<Options> const parsed_options = ParseOptions(argc, argv);
+  if (!parsed_options) {
+    PrintUsage();
+    return EXIT_FAILURE;
+  }
+  Options const& options = parsed_options.value();
+
+  std::FILE* output = stdout;
+  if (options.output_path != nullptr) {
+    output = std::fopen(options.output_path, "w");
+    if (output == nullptr) {
+      std::fprintf(stderr, "Failed to open %s for writing\n", options.output_path);
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::vector<Engagement> engagements(options.engagement_count);
+  for (uint64_t i = 0; i < engagements.size(); ++i) {
+    engagements[i] = MakeEngagement(options, i);
+  }
+
+  JobSystem job_system(options.thread_count);
+
+  auto const start_time = std::chrono::steady_clock::now();
+  job_system.ParallelFor(
+    engagements.size(),
+    [&](uint64_t first, uint64_t count) {
+      for (uint64_t i = first; i < first + count; ++i) {
+        RunEngagement(options, engagements[i]);
+      }
+    },
+    ParallelForOptions { .chunk_size = kChunkEngagementCount, .progress = {} }
+  );
+  double const elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+  std::fputs("engagement,bearing_deg,range_m,target_speed_kn,aob_deg,result,gyro_angle_deg,run_time_s,closest_approach_m\n", output);
+  uint64_t result_counts[3] = {};
+  uint64_t total_step_count = 0;
+  for (std::size_t i = 0; i < engagements.size(); ++i) {
+    Engagement const& engagement = engagements[i];
+    std::fprintf(
+      output,
+      "%zu,%.3f,%.1f,%.2f,%.3f,%s,%.3f,%.2f,%.2f\n",
+      i,
+      engagement.target_bearing_deg,
+      engagement.target_range_m,
+      engagement.target_speed_kn,
+      engagement.angle_on_bow_deg,
+      GetEngagementResultName(engagement.result),
+      engagement.gyro_angle_deg,
+      engagement.run_time_s,
+      engagement.closest_approach_m
+    );
+    ++result_counts[static_cast<int>(engagement.result)];
+    total_step_count += engagement.step_count;
+  }
+  if (output != stdout) {
+    std::fclose(output);
+  }
+
+  double const simulated_s = static_cast<double>(total_step_count) * tdc2::Simulation::kStepS;
+  std::fprintf(
+    stderr,
+    "%zu engagements: %llu hit, %llu miss, %llu no solution.\n"
+    "Simulated %.0f s in %llu steps in %.2f s on %u threads (%.0f steps/s, %.0fx real time).\n",
+    engagements.size(),
+    static_cast<unsigned long long>(result_counts[static_cast<int>(EngagementResult::kHit)]),
+    static_cast<unsigned long long>(result_counts[static_cast<int>(EngagementResult::kMiss)]),
+    static_cast<unsigned long long>(result_counts[static_cast<int>(EngagementResult::kNoSolution)]),
+    simulated_s,
+    static_cast<unsigned long long>(total_step_count),
+    elapsed_s,
+    job_system.GetThreadCount(),
+    static_cast<double>(total_step_count) / std::max(elapsed_s, 1e-9),
+    simulated_s / std::max(elapsed_s, 1e-9)
+  );
+
+  return EXIT_SUCCESS;
+}
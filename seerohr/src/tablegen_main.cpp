@@ -0,0 +1,391 @@
+// c++ headers ------------------------------------------
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <chrono>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <vector>
+
+// project headers --------------------------------------
+#include "job_system.h"
+#include "tdc2_solver.h"
+#include "tdc2_table.h"
+#include "tool_options.h"
+
+// Offline generator for firing tables; see `tdc2::FiringTableFileHeader` for the file format.
+//
+// Solves every cell of a target bearing × range × speed × angle on bow grid with `TorpedoTriangle` and
+// `ParallaxCorrectionSolver` on a `JobSystem` and writes the result as a single file.
+// With `--validate`, instead compares lookups into an existing table against the live solver.
+
+namespace {
+
+constexpr float kDegToRad = std::numbers::pi_v<float> / 180.0f;
+
+// Cells per job; small enough to balance the load, large enough to keep the queues cold.
+constexpr uint64_t kChunkCellCount = 4096;
+
+struct Options final {
+  char const* output_path = "firing_table.bin";
+
+  tdc2::TorpedoSpec torpedo_spec = tdc2::GetTorpedoPresetSpec(tdc2::TorpedoPreset::kG7e);
+  tdc2::ParallaxSolveMethod method = tdc2::ParallaxSolveMethod::kGeometry;
+
+  // Bearing and angle on bow in degrees here; converted to radians for the grid.
+  tdc2::FiringTableAxis target_bearing_deg { .min = -180.0f, .max = 180.0f, .count = 73 };
+  tdc2::FiringTableAxis target_range_m { .min = 200.0f, .max = 5000.0f, .count = 49 };
+  tdc2::FiringTableAxis target_speed_kn { .min = 0.0f, .max = 30.0f, .count = 31 };
+  tdc2::FiringTableAxis angle_on_bow_deg { .min = -180.0f, .max = 180.0f, .count = 73 };
+
+  uint32_t thread_count = 0; // 0: One per hardware thread.
+
+  char const* validate_path = nullptr;
+  uint32_t sample_count = 100000;
+};
+
+void PrintUsage() {
+  std::fprintf(
+    stderr,
+    "Usage: seerohr_tablegen [options]\n"
+    "\n"
+    "Options:\n"
+    "  --out <path>                 Output file. Default: firing_table.bin\n"
+    "  --torpedo <g7a|g7e>          Torpedo preset. Default: g7e\n"
+    "  --distance-to-tube <m>       Override the distance from the aiming device to the tube.\n"
+    "  --reach <m>                  Override the initial straight run.\n"
+    "  --turn-radius <m>            Override the turn radius.\n"
+    "  --method <name>              Parallax solver: geometry, newton or siemens. Default: geometry\n"
+    "  --bearing <min:max:count>    Relative target bearing axis in degrees. Default: -180:180:73\n"
+    "  --range <min:max:count>      Target range axis in meters. Default: 200:5000:49\n"
+    "  --speed <min:max:count>      Target speed axis in knots. Default: 0:30:31\n"
+    "  --aob <min:max:count>        Angle on bow axis in degrees. Default: -180:180:73\n"
+    "  --threads <n>                Worker threads. Default: hardware concurrency\n"
+    "\n"
+    "  --validate <path>            Compare lookups into an existing table with the solver instead of generating.\n"
+    "  --samples <n>                Random scenarios to compare. Default: 100000\n"
+  );
+}
+
+std::optional<tdc2::FiringTableAxis> ParseAxis(std::string_view str) {
+  std::size_t const first_colon = str.find(':');
+  std::size_t const second_colon = str.find(':', first_colon + 1);
+  if (first_colon == std::string_view::npos || second_colon == std::string_view::npos) {
+    return std::nullopt;
+  }
+  std::optional<float> const min = tool_options::ParseFloat(str.substr(0, first_colon));
+  std::optional<float> const max = tool_options::ParseFloat(str.substr(first_colon + 1, second_colon - first_colon - 1));
+  std::optional<uint32_t> const count = tool_options::ParseUInt32(str.substr(second_colon + 1));
+  if (!min.has_value() || !max.has_value() || !count.has_value()) {
+    return std::nullopt;
+  }
+  if (count.value() == 0 || max.value() < min.value()) {
+    return std::nullopt;
+  }
+  return tdc2::FiringTableAxis { .min = min.value(), .max = max.value(), .count = count.value() };
+}
+
+std::optional<Options> ParseOptions(int argc, char** argv) {
+  Options options;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string_view const arg = argv[i];
+    if (arg == "--help" || arg == "-h") {
+      return std::nullopt;
+    }
+    if (i + 1 >= argc) {
+      std::fprintf(stderr, "Missing value for %s\n", argv[i]);
+      return std::nullopt;
+    }
+    char const* value = argv[++i];
+    std::string_view const value_sv = value;
+
+    bool ok = true;
+    if (arg == "--out") {
+      options.output_path = value;
+    }
+    else if (arg == "--torpedo") {
+      std::optional<tdc2::TorpedoSpec> const torpedo_spec = tool_options::ParseTorpedoPreset(value_sv);
+      ok = torpedo_spec.has_value();
+      if (ok) {
+        options.torpedo_spec = torpedo_spec.value();
+      }
+    }
+    else if (arg == "--distance-to-tube" || arg == "--reach" || arg == "--turn-radius") {
+      std::optional<float> const parsed = tool_options::ParseFloat(value_sv);
+      ok = parsed.has_value() && parsed.value() >= 0.0f;
+      if (ok) {
+        float& field = (arg == "--distance-to-tube") ? options.torpedo_spec.distance_to_tube :
+                       (arg == "--reach") ? options.torpedo_spec.reach : options.torpedo_spec.turn_radius;
+        field = parsed.value();
+      }
+    }
+    else if (arg == "--method") {
+      std::optional<tdc2::ParallaxSolveMethod> const method = tool_options::ParseSolveMethod(value_sv);
+      ok = method.has_value();
+      if (ok) {
+        options.method = method.value();
+      }
+    }
+    else if (arg == "--bearing" || arg == "--range" || arg == "--speed" || arg == "--aob") {
+      std::optional<tdc2::FiringTableAxis> const axis = ParseAxis(value_sv);
+      ok = axis.has_value();
+      if (ok) {
+        tdc2::FiringTableAxis& field = (arg == "--bearing") ? options.target_bearing_deg :
+                                       (arg == "--range") ? options.target_range_m :
+                                       (arg == "--speed") ? options.target_speed_kn : options.angle_on_bow_deg;
+        field = axis.value();
+      }
+    }
+    else if (arg == "--threads" || arg == "--samples") {
+      std::optional<uint32_t> const parsed = tool_options::ParseUInt32(value_sv);
+      ok = parsed.has_value();
+      if (ok) {
+        uint32_t& field = (arg == "--threads") ? options.thread_count : options.sample_count;
+        field = parsed.value();
+      }
+    }
+    else if (arg == "--validate") {
+      options.validate_path = value;
+    }
+    else {
+      std::fprintf(stderr, "Unknown option: %s\n", argv[i - 1]);
+      return std::nullopt;
+    }
+
+    if (!ok) {
+      std::fprintf(stderr, "Invalid value for %s: %s\n", argv[i - 1], value);
+      return std::nullopt;
+    }
+  }
+
+  if (options.target_range_m.min <= 0.0f) {
+    std::fprintf(stderr, "Target range must be positive.\n");
+    return std::nullopt;
+  }
+  if (options.target_speed_kn.min < 0.0f) {
+    std::fprintf(stderr, "Target speed must not be negative.\n");
+    return std::nullopt;
+  }
+
+  return options;
+}
+
+/// Error statistics of one quantity over the validation samples.
+struct ErrorStats final {
+  std::vector<float> errors;
+
+  void Add(float error) { errors.push_back(std::abs(error)); }
+
+  void Print(char const* name, char const* unit) {
+    if (errors.empty()) {
+      return;
+    }
+    std::sort(errors.begin(), errors.end());
+    double sum = 0.0;
+    for (float error : errors) {
+      sum += error;
+    }
+    std::printf(
+      "  %-16s mean %.6f %s, p99 %.6f %s, max %.6f %s\n",
+      name,
+      sum / static_cast<double>(errors.size()), unit,
+      errors[errors.size() * 99 / 100], unit,
+      errors.back(), unit
+    );
+  }
+};
+
+/// Compare lookups into the table at `options.validate_path` against `ParallaxCorrectionSolver::SolveByGeometry`
+/// with the closed-form equivalent point of fire, at random scenarios within the grid.
+int Validate(Options const& options) {
+  std::optional<tdc2::FiringTable> const table = tdc2::FiringTable::Open(options.validate_path);
+  if (!table) {
+    std::fprintf(stderr, "Failed to open %s as a firing table\n", options.validate_path);
+    return EXIT_FAILURE;
+  }
+
+  tdc2::TorpedoSpec const torpedo_spec = table->GetHeader().GetTorpedoSpec();
+  tdc2::FiringTableGrid const& grid = table->GetGrid();
+
+  std::mt19937 rng(1);
+  auto sample = [&rng](tdc2::FiringTableAxis const& axis) {
+    return std::uniform_real_distribution<float>(axis.min, axis.max)(rng);
+  };
+
+  std::vector<tdc2::TorpedoTriangle> triangles(options.sample_count);
+  for (tdc2::TorpedoTriangle& triangle : triangles) {
+    triangle = tdc2::TorpedoTriangle {
+      .torpedo_speed_kn = torpedo_spec.speed_kn,
+      .target_bearing = Angle(sample(grid.target_bearing)),
+      .target_range_m = sample(grid.target_range_m),
+      .target_speed_kn = sample(grid.target_speed_kn),
+      .angle_on_bow = Angle(sample(grid.angle_on_bow)),
+    };
+  }
+
+  // Lookups and solves are timed separately so that the comparison is of the lookup and the solve alone.
+  // The first lookup pass also pays for faulting in the pages of the mapping; the second one does not.
+  std::vector<std::optional<tdc2::FiringTableSolution>> lookups(triangles.size());
+  double lookup_s[2] = {};
+  for (double& elapsed_s : lookup_s) {
+    auto const lookup_start_time = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < triangles.size(); ++i) {
+      lookups[i] = table->Lookup(triangles[i]);
+    }
+    elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - lookup_start_time).count();
+  }
+
+  std::vector<std::optional<tdc2::ParallaxCorrectionSolution>> solutions(triangles.size());
+  auto const solve_start_time = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < triangles.size(); ++i) {
+    tdc2::TorpedoTriangle const& triangle = triangles[i];
+    std::optional<tdc2::TorpedoTriangleSolution> const tri_solution = triangle.Solve(triangle.PrepareSolve(Angle(0.0f)), { 0.0f, 0.0f });
+    if (!tri_solution) {
+      continue;
+    }
+    tdc2::ParallaxCorrectionSolution pc_solution;
+    if (tdc2::ParallaxCorrectionSolver::SolveByGeometry(torpedo_spec, triangle, tri_solution->pseudo_torpedo_gyro_angle.AsRad(), { 0.0f, 0.0f }, 0.0f, pc_solution)) {
+      solutions[i] = pc_solution;
+    }
+  }
+  double const solve_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - solve_start_time).count();
+
+  uint32_t both_count = 0;
+  uint32_t fallback_count = 0; // Solver has a solution, table does not cover it.
+  uint32_t spurious_count = 0; // Table has a solution, solver does not.
+  ErrorStats gyro_angle_errors;
+  ErrorStats parallax_delta_errors;
+  ErrorStats run_time_errors;
+
+  for (std::size_t i = 0; i < triangles.size(); ++i) {
+    if (lookups[i].has_value() && solutions[i].has_value()) {
+      ++both_count;
+      gyro_angle_errors.Add(std::remainder(lookups[i]->gyro_angle - solutions[i]->rho, 2.0f * std::numbers::pi_v<float>) / kDegToRad);
+      parallax_delta_errors.Add((lookups[i]->parallax_delta - solutions[i]->delta) / kDegToRad);
+      run_time_errors.Add(100.0f * (lookups[i]->run_time_s - solutions[i]->torpedo_time_to_target_s) / solutions[i]->torpedo_time_to_target_s);
+    }
+    else if (solutions[i].has_value()) {
+      ++fallback_count;
+    }
+    else if (lookups[i].has_value()) {
+      ++spurious_count;
+    }
+  }
+
+  std::printf(
+    "%u scenarios: %u answered by the table, %u fall back to the solver, %u answered by the table but unsolvable.\n",
+    options.sample_count, both_count, fallback_count, spurious_count
+  );
+  gyro_angle_errors.Print("Gyro angle", "deg");
+  parallax_delta_errors.Print("Parallax delta", "deg");
+  run_time_errors.Print("Run time", "%");
+
+  double const per_sample = 1e9 / std::max<double>(options.sample_count, 1.0);
+  std::printf(
+    "Lookup %.1f ns (first pass %.1f ns), solve %.1f ns per scenario.\n",
+    lookup_s[1] * per_sample,
+    lookup_s[0] * per_sample,
+    solve_s * per_sample
+  );
+
+  return EXIT_SUCCESS;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::optional<Options> const parsed_options = ParseOptions(argc, argv);
+  if (!parsed_options) {
+    PrintUsage();
+    return EXIT_FAILURE;
+  }
+  Options const& options = parsed_options.value();
+
+  if (options.validate_path != nullptr) {
+    return Validate(options);
+  }
+
+  auto to_rad = [](tdc2::FiringTableAxis axis) {
+    axis.min *= kDegToRad;
+    axis.max *= kDegToRad;
+    return axis;
+  };
+  tdc2::FiringTableGrid const grid {
+    .target_bearing = to_rad(options.target_bearing_deg),
+    .target_range_m = options.target_range_m,
+    .target_speed_kn = options.target_speed_kn,
+    .angle_on_bow = to_rad(options.angle_on_bow_deg),
+  };
+
+  std::optional<uint64_t> const checked_cell_count = grid.GetCellCount();
+  if (!checked_cell_count.has_value() || checked_cell_count.value() > SIZE_MAX / sizeof(tdc2::FiringTableEntry)) {
+    std::fprintf(stderr, "Too many cells (%u x %u x %u x %u)\n",
+      grid.target_bearing.count, grid.target_range_m.count, grid.target_speed_kn.count, grid.angle_on_bow.count);
+    return EXIT_FAILURE;
+  }
+  uint64_t const cell_count = checked_cell_count.value();
+
+  JobSystem job_system(options.thread_count);
+
+  std::printf(
+    "Generating %llu cells (%u x %u x %u x %u), %.1f MiB, on %u threads.\n",
+    static_cast<unsigned long long>(cell_count),
+    grid.target_bearing.count, grid.target_range_m.count, grid.target_speed_kn.count, grid.angle_on_bow.count,
+    static_cast<double>(cell_count * sizeof(tdc2::FiringTableEntry)) / (1024.0 * 1024.0),
+    job_system.GetThreadCount()
+  );
+
+  std::vector<tdc2::FiringTableEntry> entries(cell_count);
+
+  auto const start_time = std::chrono::steady_clock::now();
+
+  // Progress in tenths of a percent, printed as it changes.
+  uint64_t printed_permille = UINT64_MAX;
+  job_system.ParallelFor(
+    cell_count,
+    [&](uint64_t first, uint64_t count) {
+      tdc2::GenerateFiringTableEntries(options.torpedo_spec, options.method, grid, entries, first, count);
+    },
+    ParallelForOptions {
+      .chunk_size = kChunkCellCount,
+      .progress = [&](uint64_t done_count, uint64_t total_count) {
+        uint64_t const permille = done_count * 1000 / total_count;
+        if (permille != printed_permille) {
+          printed_permille = permille;
+          std::printf("\r%5.1f%%", static_cast<double>(permille) / 10.0);
+          std::fflush(stdout);
+        }
+      },
+    }
+  );
+  std::printf("\n");
+
+  double const elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+  uint64_t const feasible_count = static_cast<uint64_t>(std::count_if(
+    entries.begin(), entries.end(),
+    [](tdc2::FiringTableEntry const& entry) { return entry.IsFeasible(); }
+  ));
+  std::printf(
+    "Solved in %.2f s (%.0f cells/s); %llu of %llu cells feasible.\n",
+    elapsed_s,
+    static_cast<double>(cell_count) / std::max(elapsed_s, 1e-9),
+    static_cast<unsigned long long>(feasible_count),
+    static_cast<unsigned long long>(cell_count)
+  );
+
+  if (!tdc2::WriteFiringTable(options.output_path, options.torpedo_spec, options.method, grid, entries)) {
+    std::fprintf(stderr, "Failed to write %s\n", options.output_path);
+    return EXIT_FAILURE;
+  }
+  std::printf("Wrote %s\n", options.output_path);
+
+  return EXIT_SUCCESS;
+}
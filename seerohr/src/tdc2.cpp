@@ -3,9 +3,13 @@
 
 // c++ headers ------------------------------------------
 #include <cassert>
+#include <cstdio>
 
 #include <algorithm>
+#include <chrono>
+#include <limits>
 #include <numbers>
+#include <utility>
 
 // external headers -------------------------------------
 #include "imgui.h"
@@ -14,7 +18,6 @@
 #include "text.h"
 #include "raylib_widgets.h"
 #include "widgets.h"
-#include "numerical.h"
 
 // http://www.tvre.org/en/torpedo-calculator-t-vh-re-s3
 // http://www.tvre.org/en/gyro-angled-torpedoes
@@ -24,424 +27,114 @@
 
 namespace tdc2 {
 
-namespace {
-
-Angle ComputeAbsoluteTargetBearing(
-  Angle ownship_course,
-  Angle relative_target_bearing
-) {
-  return ownship_course + relative_target_bearing;
+Tdc::Tdc() {
+  active_target_id_ = targets_.Add(this->GetPanelTarget());
 }
 
-raylib::Vector2 ComputeTargetPosition(
-  raylib::Vector2 const& aiming_device_position,
+void Tdc::Update(
   Angle ownship_course,
-  Angle relative_target_bearing,
-  float target_range_m
+  raylib::Vector2 const& aiming_device_position_screen,
+  JobSystem* job_system
 ) {
-  Angle const absolute_target_bearing = ComputeAbsoluteTargetBearing(
-    ownship_course,
-    relative_target_bearing
-  );
-
-  return {
-    aiming_device_position.x + target_range_m * +(-absolute_target_bearing + Angle::RightAngle()).Cos(),
-    aiming_device_position.y + target_range_m * -(-absolute_target_bearing + Angle::RightAngle()).Sin()
-  };
-}
-
-struct TorpedoTriangle final {
-  float torpedo_speed_kn = 0.0f;
-  Angle target_bearing = Angle::FromDeg(0.0f);
-  float target_range_m = 0.0f;
-  float target_speed_kn = 0.0f;
-
-  Angle angle_on_bow = Angle::FromDeg(0.0f); // Signed: Positive is starboard, negative is port.
-
-  TorpedoTriangleIntermediate PrepareSolve(
-    Angle ownship_course
-  ) const {
-    Angle const absolute_target_bearing = ComputeAbsoluteTargetBearing(
-      ownship_course,
-      this->target_bearing
-    );
-
-    Angle target_course = absolute_target_bearing + Angle::Pi() - this->angle_on_bow;
-    target_course = target_course.WrapAround();
-
-    return TorpedoTriangleIntermediate {
-      .ownship_course = ownship_course,
-      .absolute_target_bearing = absolute_target_bearing,
-      .target_course = target_course,
-    };
+  if (std::optional<std::size_t> const index = targets_.FindIndex(active_target_id_); index.has_value()) {
+    targets_.SetTarget(index.value(), this->GetPanelTarget());
   }
+  // The same curve the worker evaluates for the active target.
+  targets_.Solve(torpedo_spec_, ownship_course, ToVec2(aiming_device_position_screen), &epf_curve_cache_.Get(torpedo_spec_), job_system);
 
-  std::optional<TorpedoTriangleSolution> Solve(
-    TorpedoTriangleIntermediate const& interm,
-    raylib::Vector2 const& aiming_device_position
-  ) const {
-    assert(this->torpedo_speed_kn > 0.0f);
-
-    // No solution using torpedo triangle; target course line is identical to ownship line.
-    if (this->angle_on_bow.AsRad() == 0.0f || std::abs(this->angle_on_bow.AsRad()) == std::numbers::pi_v<float>) {
-      {
-        float target_speed_seen_from_torpedo_kn = ((this->angle_on_bow.AsRad() == 0.0f) ? -this->target_speed_kn : this->target_speed_kn) - this->torpedo_speed_kn;
-
-        if (target_speed_seen_from_torpedo_kn >= 0.0f){
-          // No solution; the target is too fast for the torpedo to ever catch up.
-          return std::nullopt;
-        }
-      }
-
-      // Closing: Positive
-      // Moving away: Negative
-      float signed_target_speed_kn = (this->angle_on_bow.AsRad() == 0.0f) ? this->target_speed_kn : -this->target_speed_kn;
-
-      float torpedo_time_to_target_s = this->target_range_m / ((this->torpedo_speed_kn + signed_target_speed_kn) * 1852.0f / 3600.0f);
-      float torpedo_run_distance_m = (this->torpedo_speed_kn * 1852.0f / 3600.0f) * torpedo_time_to_target_s;
-
-      raylib::Vector2 const impact_position = aiming_device_position + raylib::Vector2 (
-        torpedo_run_distance_m * (interm.absolute_target_bearing - Angle::RightAngle()).Cos(),
-        torpedo_run_distance_m * (interm.absolute_target_bearing - Angle::RightAngle()).Sin()
-      );
-
-      Angle const pseudo_torpedo_gyro_angle = this->target_bearing;
-
-      return TorpedoTriangleSolution {
-        .target_course = interm.target_course,
-        .lead_angle = Angle(0.0f),
-        .intercept_angle = signed_target_speed_kn >= 0.0f ? Angle::Pi() : Angle(0.0f),
-        .torpedo_time_to_target_s = torpedo_time_to_target_s,
-        .pseudo_torpedo_gyro_angle = pseudo_torpedo_gyro_angle,
-        .impact_position = impact_position,
-      };
-    }
-
-    // Try to solve using torpedo triangle.
-
-    float const sin_lead_angle = this->target_speed_kn / this->torpedo_speed_kn * this->angle_on_bow.Abs().Sin();
-    if (1.0f < sin_lead_angle) {
-      // No solution; target is too fast leaving no valid lead angle for given torpedo speed and target course.
-      // NOTE: sin_lead_angle == 0.0f is only possible when `this->target_speed_kn` or `this->angle_on_bow` is zero.
-      return std::nullopt;
-    }
-
-    assert(0.0f <= sin_lead_angle && sin_lead_angle <= 1.0f);
-
-    Angle const lead_angle = Angle(std::asin(sin_lead_angle));
-    Angle const intercept_angle = Angle::Pi() - this->angle_on_bow.Abs() - lead_angle;
-    if (intercept_angle.AsRad() <= 0.0f) {
-      // No solution; target is too fast leaving no valid lead angle for given torpedo speed and target course.
-      return std::nullopt;
-    }
-
-    float const torpedo_run_distance_m = this->target_range_m / intercept_angle.Sin() * this->angle_on_bow.Abs().Sin();
-
-    float torpedo_time_to_target_s = 0.0f;
-    {
-      float torpedo_speed_mps = this->torpedo_speed_kn * 1852.0f / 3600.0f;
-
-      torpedo_time_to_target_s = torpedo_run_distance_m / torpedo_speed_mps;
+  target_grid_.Update(targets_.GetPositions());
+  {
+    ParallaxCorrectionBatchOutput const& pc_output = targets_.GetParallaxOutputs();
+    impact_positions_.resize(targets_.GetCount());
+    for (std::size_t i = 0; i < impact_positions_.size(); ++i) {
+      impact_positions_[i] = pc_output.valid[i]
+        ? Vec2 { pc_output.impact_x[i], pc_output.impact_y[i] }
+        : Vec2 { std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::quiet_NaN() };
     }
-
-    Angle const torpedo_course = interm.absolute_target_bearing + (this->angle_on_bow.Sign() * lead_angle);
-    Angle const pseudo_torpedo_gyro_angle = torpedo_course - interm.ownship_course;
-
-    // `- Angle::RightAngle()` corrects for coordinate space difference.
-    raylib::Vector2 const impact_position = aiming_device_position + raylib::Vector2(
-      torpedo_run_distance_m * (interm.absolute_target_bearing + (this->angle_on_bow.Sign() * lead_angle) - Angle::RightAngle()).Cos(),
-      torpedo_run_distance_m * (interm.absolute_target_bearing + (this->angle_on_bow.Sign() * lead_angle) - Angle::RightAngle()).Sin()
-    );
-
-    return TorpedoTriangleSolution {
-      .target_course = interm.target_course,
-      .lead_angle = lead_angle,
-      .intercept_angle = intercept_angle,
-      .torpedo_time_to_target_s = torpedo_time_to_target_s,
-      .pseudo_torpedo_gyro_angle = pseudo_torpedo_gyro_angle,
-      .impact_position = impact_position,
-    };
+    impact_grid_.Update(impact_positions_);
   }
-};
-
-} // namespace
-
-namespace {
-struct ParallaxCorrectionSolver final {
-  /// Solve for the parallax correction using geometric iteration.
-  ///
-  /// This method iteratively refines the parallax correction angle (delta) using geometric relationships.
-  /// It uses the initial guess (`rho0`) and the observed target position to compute the correction.
-  /// 
-  /// ## Parameters
-  /// - `rho0`: Initial guess for the torpedo gyro angle (Schusswinkel) in radians.
-  /// - `aiming_device_position`: For computing the parallax-corrected impact position.
-  /// - `ownship_course_rad`: The course of the ownship in radians.
-  static bool SolveByGeometry(
-    TorpedoSpec const& torpedo_spec,
-    TorpedoTriangle const& triangle,
-    float rho0,
-    raylib::Vector2 const& aiming_device_position,
-    float ownship_course_rad,
-    ParallaxCorrectionSolution& out_pc_solution
-  ) {
-    constexpr uint32_t kIters = 64;
-    constexpr float kTolerance = 1e-6f;
-    constexpr float kLambda = 0.6f;
-
-    // Target range, as observed from the aiming device.
-    float const los = triangle.target_range_m;
-
-    // Signed target bearing.
-    float const omega1 = triangle.target_bearing.AsRad();
-
-    // Signed angle on bow.
-    float const gamma1 = triangle.angle_on_bow.AsRad();
-
-    auto wrap_pi = [](float angle) -> float {
-      return std::remainder(angle, 2.0f * std::numbers::pi_v<float>); // (-pi, pi]
-    };
-
-    // Target position, as observed from the aiming device.
-    raylib::Vector2 const T { los * std::cos(omega1), los * std::sin(omega1) };
-
-    float rho = rho0; // Initialize with initial guess for rho.
-
-    for (uint32_t i = 0; i < kIters; ++i) {
-      // Relative to ownship course.
-      raylib::Vector2 const epf_offset = torpedo_spec.ComputeEquivalentPointOfFireOffset(rho);
-
-      raylib::Vector2 const e_to_t = T - epf_offset;
-
-      // Target bearing, as observed from this equivalent point of fire.
-      float const omega2 = std::atan2(e_to_t.y, e_to_t.x);
-
-      // Parallax correction delta.
-      float const delta = wrap_pi(omega1 - omega2);
-
-      // Signed angle on bow, as observed from the equivalent point of fire.
-      float const gamma2 = wrap_pi(gamma1 - delta);
-
-      // Lead angle as seen from the equivalent point of fire.
-      float beta2 = 0.0f;
-      {
-        float sin_beta = (triangle.target_speed_kn / torpedo_spec.speed_kn) * std::sin(gamma2);
 
-        if (sin_beta < -1.0f || 1.0f < sin_beta) {
-          // No solution; target is too fast leaving no valid lead angle for given torpedo speed and target course.
-          return false;
-        }
-
-        beta2 = std::asin(sin_beta);
-      }
-
-      // Desired rho.
-      float const rho_target = wrap_pi(omega2 + beta2);
-
-      // Relaxed update on the circle.
-      float const step = wrap_pi(rho_target - rho);
-      rho = wrap_pi(rho + kLambda * step);
-
-      if (std::abs(step) < kTolerance) {
-        // Converged.
-
-        // Intercept angle, as seen from the equivalent point of fire.
-        float const alpha2 = std::numbers::pi_v<float> - gamma2 - beta2;
+  solver_.Submit(this->GetInputs(ownship_course, aiming_device_position_screen), use_firing_table_ ? firing_table_ : nullptr);
+}
 
-        float const los2 = e_to_t.Length();
-        float const torpedo_run_distance_m = los2 * (std::sin(gamma2) / std::sin(alpha2));
+TdcInputs Tdc::GetInputs(
+  Angle ownship_course,
+  raylib::Vector2 const& aiming_device_position_screen
+) const {
+  return TdcInputs {
+    .torpedo_spec = torpedo_spec_,
+    .target_bearing = target_bearing_,
+    .target_range_m = target_range_m_,
+    .target_speed_kn = target_speed_kn_,
+    .angle_on_bow = angle_on_bow_,
+    .ownship_course = ownship_course,
+    .aiming_device_position = ToVec2(aiming_device_position_screen),
+    .pc_method = pc_method_,
+    .firing_table = use_firing_table_ ? firing_table_.get() : nullptr,
+  };
+}
 
-        float const torpedo_speed_mps = torpedo_spec.speed_kn * 1852.0f / 3600.0f;
-        float const torpedo_time_to_target_s = torpedo_run_distance_m / torpedo_speed_mps;
+void Tdc::SetTargetInputs(TdcInputs const& observed) {
+  target_bearing_ = observed.target_bearing;
+  target_range_m_ = observed.target_range_m;
+  target_speed_kn_ = observed.target_speed_kn;
+  angle_on_bow_ = observed.angle_on_bow;
+}
 
-        raylib::Vector2 const e = aiming_device_position + epf_offset.Rotate(ownship_course_rad - std::numbers::pi_v<float> / 2.0f);
-        raylib::Vector2 const impact_position = e + raylib::Vector2(
-          torpedo_run_distance_m * std::cos(ownship_course_rad - std::numbers::pi_v<float> / 2.0f + rho),
-          torpedo_run_distance_m * std::sin(ownship_course_rad - std::numbers::pi_v<float> / 2.0f + rho)
-        );
+TargetData Tdc::GetPanelTarget() const {
+  return TargetData {
+    .target_bearing = target_bearing_,
+    .target_range_m = target_range_m_,
+    .target_speed_kn = target_speed_kn_,
+    .angle_on_bow = angle_on_bow_,
+  };
+}
 
-        out_pc_solution.delta = delta;
-        out_pc_solution.rho = rho;
-        out_pc_solution.gamma = gamma2;
-        out_pc_solution.beta = beta2;
-        out_pc_solution.epf_offset = epf_offset;
-        out_pc_solution.torpedo_run_distance_m = torpedo_run_distance_m;
-        out_pc_solution.torpedo_time_to_target_s = torpedo_time_to_target_s;
-        out_pc_solution.impact_position = impact_position;
-        return true;
-      }
-    }
+void Tdc::SetPanelTarget(TargetData const& target) {
+  target_bearing_ = target.target_bearing;
+  target_range_m_ = target.target_range_m;
+  target_speed_kn_ = target.target_speed_kn;
+  angle_on_bow_ = target.angle_on_bow;
+}
 
-    // No convergence.
-    return false;
+void Tdc::SelectTarget(TargetId id) {
+  std::optional<std::size_t> const index = targets_.FindIndex(id);
+  if (!index.has_value()) {
+    return;
   }
-
-  // Code currently disabled. SIEMENS approach as in the 1944 patent.
-#if 0
-  /// Numerically solve the equation H(Δ) = Δ - F(Δ) * sin(Δ + G(Δ)) for Δ
-  /// where:
-  ///  F(Δ) = 1/e * X(ρ)
-  ///  G(Δ) = ω + θ(Δ)
-  ///  X(ρ) = sqrt(x(ρ)^2 + y(ρ)^2)
-  ///  θ(ρ) = arctan(y(ρ) / x(ρ))
-  ///  ρ = ω + Δ - β
-  ///
-  /// ## Outputs
-  /// Δ is the parallax correction angle, or Winkelparallaxverbesserung.
-  /// ρ is the final torpedo gyro angle, or Schusswinkel.
-  static bool SolveSiemens(
-    TorpedoSpec const& torpedo_spec,
-    TorpedoTriangle const& triangle,
-    ParallaxCorrectionSolution& out_solution
-  ) {
-    struct EvaluateContext final {
-      TorpedoSpec const& torpedo_spec;
-      float target_speed_kn;
-      float e;      // Target range, as observed from the aiming device.
-      float omega;  // Absolute value of target bearing, as observed from the aiming device.
-      float gamma1; // Absolute value of angle on bow, as observed from the aiming device.
-    } ctx {
-      .torpedo_spec = torpedo_spec,
-      .target_speed_kn = triangle.target_speed_kn,
-      .e = triangle.target_range_m,
-      .omega = triangle.target_bearing.Abs().AsRad(),
-      .gamma1 = triangle.angle_on_bow.Abs().AsRad(),
-    };
-
-    struct Solution final {
-      float delta = 0.0f;
-      float gamma = 0.0f; // γ = θ1 - Δ: Angle on bow as seen from the equivalent point of fire.
-      float beta = 0.0f;  // β: Lead angle as seen from the equivalent point of fire.
-      float rho = 0.0f;   // ρ = ω + Δ - β: Final torpedo gyro angle
-      raylib::Vector2 epf_offset {};
-    } solution;
-
-    // Evaluate H(Δ) = Δ - F(Δ) * sin(Δ + G(Δ))
-    auto evaluate = [&ctx, &solution](float delta) -> std::optional<float> {
-      float const gamma = ctx.gamma1 - delta;
-
-      float beta = 0.0f;  
-      {
-        float sin_beta = (ctx.target_speed_kn / ctx.torpedo_spec.speed_kn) * std::sin(gamma);
-
-        //assert(-1.0f <= sin_beta && sin_beta <= 1.0f);
-        if (sin_beta < -1.0f || 1.0f < sin_beta) {
-          // No solution; target is too fast leaving no valid lead angle for given torpedo speed and target course.
-          return std::nullopt;
-        }
-
-        beta = std::asin(sin_beta);
-      }
-
-      float const rho = -(ctx.omega + delta - beta);
-
-      // X(ρ): Offset to the equivalent point of fire.
-      raylib::Vector2 const epf_offset = ctx.torpedo_spec.ComputeEquivalentPointOfFireOffset(rho);
-
-      // F(ρ) = 1/e * X(ρ)
-      float f = 1.0f / ctx.e * std::sqrt(epf_offset.x * epf_offset.x + epf_offset.y * epf_offset.y);
-
-      // θ(ρ): Angle between ownship course and line to the equivalent point of fire.
-      float theta = std::atan2(epf_offset.y, epf_offset.x);
-
-      // G(Δ) = ω + θ(ρ)
-      float g = ctx.omega + theta;
-
-      solution.delta = delta;
-      solution.gamma = ctx.gamma1 - delta;
-      solution.beta = beta;
-      solution.rho = rho;
-      solution.epf_offset = epf_offset;
-
-      return delta - f * std::sin(delta + g);
-    };
-
-    std::optional<float> opt_root = FindRootsBisection(
-      evaluate,
-      -std::numbers::pi_v<float>,
-      std::numbers::pi_v<float>,
-      1e-6f,
-      100
-    );
-
-    if (opt_root.has_value()) {
-      float delta = opt_root.value();
-
-      evaluate(delta);
-
-      out_solution.delta = delta;
-      out_solution.rho   = solution.rho;
-      out_solution.gamma = solution.gamma;
-      out_solution.beta = solution.beta;
-      out_solution.epf_offset = solution.epf_offset;
-      return true;
-    }
-
-    return false;
+  if (std::optional<std::size_t> const active_index = targets_.FindIndex(active_target_id_); active_index.has_value()) {
+    targets_.SetTarget(active_index.value(), this->GetPanelTarget());
   }
-#endif
-};
-
-} // namespace
-
-raylib::Vector2 TorpedoSpec::ComputeEquivalentPointOfFireOffset(float rho) const {
-  float const abs_rho = std::abs(rho);
-  float const sin_abs_rho = std::sin(abs_rho);
-  float const cos_abs_rho = std::cos(abs_rho);
-
-  float x = this->distance_to_tube + this->reach + this->turn_radius * sin_abs_rho - (this->turn_radius * abs_rho + this->reach) * cos_abs_rho;
-  float y = this->turn_radius * (1.0f - cos_abs_rho) - (this->turn_radius * abs_rho + this->reach) * sin_abs_rho;
-
-  float sign = (rho >= 0.0f) ? -1.0f : 1.0f;
-
-  // Positive (starboard) rho gives positive y.
-  return { x, y * sign };
+  active_target_id_ = id;
+  this->SetPanelTarget(targets_.GetTarget(index.value()));
 }
 
-void Tdc::Update(
-  Angle ownship_course,
-  raylib::Vector2 const& aiming_device_position
-) {
-  // Expect full circle [0, 2pi) degrees for target bearing.
-  // Convert to signed angle [-pi, +pi) degrees.
-  Angle target_bearing = target_bearing_;
-  if (std::numbers::pi_v<float> <= target_bearing.AsRad()) {
-    target_bearing = target_bearing - Angle(std::numbers::pi_v<float> * 2.0f);
+void Tdc::SetTargets(std::span<TargetData const> targets) {
+  if (targets.empty()) {
+    return;
   }
+  targets_.Clear();
+  for (TargetData const& target : targets) {
+    targets_.Add(target);
+  }
+  active_target_id_ = targets_.GetId(0);
+  this->SetPanelTarget(targets.front());
+}
 
-  TorpedoTriangle triangle {
-    .torpedo_speed_kn = torpedo_spec_.speed_kn,
-    .target_bearing = target_bearing,
-    .target_range_m = target_range_m_,
-    .target_speed_kn = target_speed_kn_,
-    .angle_on_bow = angle_on_bow_
-  };
-
-  interm_ = triangle.PrepareSolve(ownship_course);
-
-  pc_solution_ = std::nullopt;
-  tri_solution_ = triangle.Solve(interm_, aiming_device_position);
-
-  if (tri_solution_.has_value()) {
-    ParallaxCorrectionSolution pc_solution;
+std::optional<TargetId> Tdc::FindTargetAt(Vec2 const& position, float radius) const {
+  std::optional<uint32_t> const index = target_grid_.FindNearest(position, radius);
+  if (!index.has_value() || targets_.GetCount() <= index.value()) {
+    return std::nullopt;
+  }
+  return targets_.GetId(index.value());
+}
 
-#if 1
-    bool result = ParallaxCorrectionSolver::SolveByGeometry(
-      torpedo_spec_,
-      triangle,
-      tri_solution_->pseudo_torpedo_gyro_angle.AsRad(),
-      aiming_device_position,
-      ownship_course.AsRad(),
-      pc_solution
-    );
-#else
-    bool result = ParallaxCorrectionSolver::SolveSiemens(torpedo_spec_, triangle, pc_solution);
-#endif
+void Tdc::AcquireSolution() {
+  solver_.Poll();
+}
 
-    if (result) {
-      pc_solution_ = pc_solution;
-    }
-  }
+void Tdc::SetFiringTable(std::shared_ptr<FiringTable const> firing_table) {
+  firing_table_ = std::move(firing_table);
 }
 
 void Tdc::DrawVisualization(
@@ -454,12 +147,17 @@ void Tdc::DrawVisualization(
 ) const {
   constexpr float kTriangleAlpha = 0.1f;
 
-  raylib::Vector2 const target_position = ComputeTargetPosition(
-    aiming_device_position,
+  TdcSolveResult const& result = solver_.GetResult();
+  TorpedoTriangleIntermediate const& interm = result.intermediate;
+  std::optional<TorpedoTriangleSolution> const& tri_solution = result.triangle_solution;
+  std::optional<ParallaxCorrectionSolution> const& pc_solution = result.parallax_solution;
+
+  raylib::Vector2 const target_position = ToRaylib(ComputeTargetPosition(
+    ToVec2(aiming_device_position),
     ownship_course,
     target_bearing_,
     target_range_m_
-  );
+  ));
 
   BeginMode2D(camera);
 
@@ -468,7 +166,7 @@ void Tdc::DrawVisualization(
   {
     for (float rho_deg = -120.0f; rho_deg <= 120.0f; rho_deg += 1.0f) {
       float rho = rho_deg * DEG2RAD;
-      raylib::Vector2 const epf_offset = torpedo_spec_.ComputeEquivalentPointOfFireOffset(rho);
+      Vec2 const epf_offset = torpedo_spec_.ComputeEquivalentPointOfFireOffset(rho);
       raylib::Vector2 const epf_position = aiming_device_position + raylib::Vector2 (
         epf_offset.x * (ownship_course - Angle::RightAngle()).Cos() - epf_offset.y * (ownship_course - Angle::RightAngle()).Sin(),
         epf_offset.x * (ownship_course - Angle::RightAngle()).Sin() + epf_offset.y * (ownship_course - Angle::RightAngle()).Cos()
@@ -482,6 +180,61 @@ void Tdc::DrawVisualization(
   }
 #endif
 
+  // Draw the other targets in view, each with a ghost at its parallax-corrected impact position.
+  {
+    std::optional<std::size_t> const active_index = targets_.FindIndex(active_target_id_);
+
+    // The world seen through `camera`, widened so that silhouettes reaching into it are drawn too.
+    Vec2 view_min;
+    Vec2 view_max;
+    {
+      Vec2 const corner_0 = ToVec2(GetScreenToWorld2D(raylib::Vector2(0.0f, 0.0f), camera));
+      Vec2 const corner_1 = ToVec2(GetScreenToWorld2D(
+        raylib::Vector2(static_cast<float>(GetScreenWidth()), static_cast<float>(GetScreenHeight())),
+        camera
+      ));
+      view_min = Vec2 { std::min(corner_0.x, corner_1.x) - target_length, std::min(corner_0.y, corner_1.y) - target_length };
+      view_max = Vec2 { std::max(corner_0.x, corner_1.x) + target_length, std::max(corner_0.y, corner_1.y) + target_length };
+    }
+
+    auto compute_target_course = [&](std::size_t i) {
+      TargetData const target = targets_.GetTarget(i);
+      return ComputeAbsoluteTargetBearing(ownship_course, target.target_bearing) + Angle::Pi() - target.angle_on_bow;
+    };
+
+    target_grid_.ForEachInBox(view_min, view_max, [&](uint32_t i) {
+      if (i == active_index || targets_.GetCount() <= i) {
+        return;
+      }
+      DrawShipSilhouette(
+        ToRaylib(target_grid_.GetPosition(i)),
+        target_length,
+        target_beam,
+        compute_target_course(i),
+        Color { 140, 90, 90, 200 }
+      );
+    });
+
+    impact_grid_.ForEachInBox(view_min, view_max, [&](uint32_t i) {
+      if (i == active_index || targets_.GetCount() <= i) {
+        return;
+      }
+      raylib::Vector2 const impact_position = ToRaylib(impact_grid_.GetPosition(i));
+      DrawShipSilhouette(
+        impact_position,
+        target_length,
+        target_beam,
+        compute_target_course(i),
+        Color { 140, 90, 90, 50 }
+      );
+      DrawCircleV(
+        impact_position,
+        6.0f,
+        Fade(ORANGE, 0.5f)
+      );
+    });
+  }
+
   // Draw a target ghost.
   {
     // Current target position - solid ship
@@ -489,17 +242,17 @@ void Tdc::DrawVisualization(
       target_position,
       target_length,
       target_beam,
-      interm_.target_course,
+      interm.target_course,
       Color{ 180, 60, 60, 255 }  // Muted red
     );
 
     // If we have a parallax-corrected solution, draw a target ghost at the corrected impact position (fainter)
-    if (pc_solution_.has_value()) {
+    if (pc_solution.has_value()) {
       DrawShipSilhouette(
-        pc_solution_->impact_position,
+        ToRaylib(pc_solution->impact_position),
         target_length,
         target_beam,
-        interm_.target_course,
+        interm.target_course,
         Color { 180, 60, 60, 80 }  // Same red but transparent (ghost)
       );
     }
@@ -517,8 +270,8 @@ void Tdc::DrawVisualization(
   DrawCircleSector(
     target_position,
     150.0f,
-    interm_.target_course.ToDeg() - 90.0f,
-    interm_.target_course.ToDeg() + angle_on_bow_.ToDeg() - 90.0f,
+    interm.target_course.ToDeg() - 90.0f,
+    interm.target_course.ToDeg() + angle_on_bow_.ToDeg() - 90.0f,
     32,
     Fade(GREEN, 0.08f)
   );
@@ -534,13 +287,13 @@ void Tdc::DrawVisualization(
     DARKGRAY
   );
 
-  if (tri_solution_.has_value()) {
+  if (tri_solution.has_value()) {
     // Draw lead angle.
     DrawCircleSector(
       aiming_device_position,
       150.0f,
-      interm_.absolute_target_bearing.ToDeg() - 90.0f,
-      interm_.absolute_target_bearing.ToDeg() + (angle_on_bow_.Sign() * tri_solution_->lead_angle.ToDeg()) - 90.0f,
+      interm.absolute_target_bearing.ToDeg() - 90.0f,
+      interm.absolute_target_bearing.ToDeg() + (angle_on_bow_.Sign() * tri_solution->lead_angle.ToDeg()) - 90.0f,
       32,
       Fade(BLUE, 0.1f)
     );
@@ -548,7 +301,7 @@ void Tdc::DrawVisualization(
     // Draw projected target course line to impact position.
     DrawLineStippled(
       target_position,
-      tri_solution_->impact_position,
+      ToRaylib(tri_solution->impact_position),
       5.0f,
       GRAY
     );
@@ -568,7 +321,7 @@ void Tdc::DrawVisualization(
       // Side 2: Target to impact position (target run)
       DrawLineStippled(
         target_position,
-        tri_solution_->impact_position,
+        ToRaylib(tri_solution->impact_position),
         3.0f,
         triangle_color
       );
@@ -576,7 +329,7 @@ void Tdc::DrawVisualization(
       // Side 3: Aiming device to impact position (torpedo run)
       DrawLineStippled(
         aiming_device_position,
-        tri_solution_->impact_position,
+        ToRaylib(tri_solution->impact_position),
         3.0f,
         triangle_color
       );
@@ -585,12 +338,12 @@ void Tdc::DrawVisualization(
       DrawTriangle(
         aiming_device_position,
         target_position,
-        tri_solution_->impact_position,
+        ToRaylib(tri_solution->impact_position),
         triangle_color
       );
       DrawTriangle(
         aiming_device_position,
-        tri_solution_->impact_position,
+        ToRaylib(tri_solution->impact_position),
         target_position,
         triangle_color
       );
@@ -598,21 +351,20 @@ void Tdc::DrawVisualization(
   }
 
   // If we have a non-parallax-corrected solution, draw the impact position but fainter.
-  if (tri_solution_.has_value()) {
+  if (tri_solution.has_value()) {
     DrawCircleV(
-      tri_solution_->impact_position,
+      ToRaylib(tri_solution->impact_position),
       10.0f,
       Fade(GREEN, 0.5f)
     );
   }
 
-  if (pc_solution_.has_value()) {
-    raylib::Vector2 const epf_offset_physical = torpedo_spec_.ComputeEquivalentPointOfFireOffset(pc_solution_->rho);
-    raylib::Vector2 const epf_offset_screen = { epf_offset_physical.x, -epf_offset_physical.y };
+  if (pc_solution.has_value()) {
+    Vec2 const epf_offset = epf_curve_cache_.Get(torpedo_spec_).Evaluate(pc_solution->rho);
 
     raylib::Vector2 const epf_position = aiming_device_position + raylib::Vector2(
-      epf_offset_screen.x * (ownship_course - Angle::RightAngle()).Cos() - epf_offset_screen.y * (ownship_course - Angle::RightAngle()).Sin(),
-      epf_offset_screen.x * (ownship_course - Angle::RightAngle()).Sin() + epf_offset_screen.y * (ownship_course - Angle::RightAngle()).Cos()
+      epf_offset.x * (ownship_course - Angle::RightAngle()).Cos() - epf_offset.y * (ownship_course - Angle::RightAngle()).Sin(),
+      epf_offset.x * (ownship_course - Angle::RightAngle()).Sin() + epf_offset.y * (ownship_course - Angle::RightAngle()).Cos()
     );
 
     // Draw the torpedo triangle from the equivalent point of fire (transparent blue).
@@ -630,7 +382,7 @@ void Tdc::DrawVisualization(
       // Side 2: Target to impact position (target run)
       DrawLineEx(
         target_position,
-        pc_solution_->impact_position,
+        ToRaylib(pc_solution->impact_position),
         3.0f,
         epf_triangle_color
       );
@@ -638,7 +390,7 @@ void Tdc::DrawVisualization(
       // Side 3: EPF to impact position (torpedo run from EPF)
       DrawLineEx(
         epf_position,
-        pc_solution_->impact_position,
+        ToRaylib(pc_solution->impact_position),
         3.0f,
         epf_triangle_color
       );
@@ -647,12 +399,12 @@ void Tdc::DrawVisualization(
       DrawTriangle(
         epf_position,
         target_position,
-        pc_solution_->impact_position,
+        ToRaylib(pc_solution->impact_position),
         epf_triangle_color
       );
       DrawTriangle(
         epf_position,
-        pc_solution_->impact_position,
+        ToRaylib(pc_solution->impact_position),
         target_position,
         epf_triangle_color
       );
@@ -676,7 +428,7 @@ void Tdc::DrawVisualization(
       Color const kTrackColor = Color { 255, 140, 0, 200 };  // Orange with some transparency
 
       // Gyro angle: positive is starboard, negative is port
-      float const gyro_angle = pc_solution_->rho;
+      float const gyro_angle = pc_solution->rho;
 
       // Forward vector at launch
       raylib::Vector2 const e0(
@@ -746,7 +498,7 @@ void Tdc::DrawVisualization(
       }
 
       // 3. Draw the final straight run from end of turn to impact position
-      DrawLineEx(p2, pc_solution_->impact_position, kTrackThickness, kTrackColor);
+      DrawLineEx(p2, ToRaylib(pc_solution->impact_position), kTrackThickness, kTrackColor);
 
       // Draw markers at key points
       DrawCircleV(p0, 5.0f, Color { 100, 100, 200, 255 });  // Tube position - blue
@@ -756,12 +508,12 @@ void Tdc::DrawVisualization(
 
     // Draw impact position marker (parallax corrected)
     DrawCircleV(
-      pc_solution_->impact_position,
+      ToRaylib(pc_solution->impact_position),
       12.0f,
       Color { 255, 100, 0, 255 }  // Bright orange
     );
     DrawCircleLinesV(
-      pc_solution_->impact_position,
+      ToRaylib(pc_solution->impact_position),
       16.0f,
       Color { 255, 100, 0, 180 }
     );
@@ -782,7 +534,7 @@ void Tdc::DrawVisualization(
         torpedo_spec_.turn_radius * (ownship_course - Angle::RightAngle() - Angle::RightAngle()).Sin()
       );
 
-      if (pc_solution_->rho >= 0.0f) {
+      if (pc_solution->rho >= 0.0f) {
         DrawCircleV(
           starboard_turn_center,
           torpedo_spec_.turn_radius,
@@ -802,7 +554,7 @@ void Tdc::DrawVisualization(
       // So gyro angle positive is starboard, negative port.
       constexpr float kSign = 1.0f;
 
-      float const gyro_angle = kSign * pc_solution_->rho;
+      float const gyro_angle = kSign * pc_solution->rho;
 
       // Forward vector at launch.
       raylib::Vector2 const e0(
@@ -882,18 +634,63 @@ void Tdc::DoPanelImGui(
   constexpr float kMaxTorpedoSpeedKn = 60.0f;
   constexpr float kMaxTargetSpeedKn = 60.0f;
 
+  TdcSolveResult const& result = solver_.GetResult();
+  std::optional<TorpedoTriangleSolution> const& tri_solution = result.triangle_solution;
+  std::optional<ParallaxCorrectionSolution> const& pc_solution = result.parallax_solution;
+
   // Input section
   ImGui::BeginGroup();
   {
     ImGui::TextColored(ImVec4(0.6f, 0.8f, 1.0f, 1.0f), "%s:", GetText(TextId::kInput));
     ImGui::Text("%s: %.1f", GetText(TextId::kOwnCourse), ownship_course.ToDeg());
+
+    // Target selection.
+    {
+      constexpr float kNewTargetBearingOffsetDeg = 15.0f;
+
+      char label[32];
+      std::snprintf(label, sizeof(label), "#%u", active_target_id_);
+      ImGui::PushItemWidth(80.0f);
+      if (ImGui::BeginCombo(GetText(TextId::kTarget), label)) {
+        for (std::size_t i = 0; i < targets_.GetCount(); ++i) {
+          TargetId const id = targets_.GetId(i);
+          TargetData const target = (id == active_target_id_) ? this->GetPanelTarget() : targets_.GetTarget(i);
+          std::snprintf(label, sizeof(label), "#%u  %.0f deg  %.0f m", id, target.target_bearing.WrapAround().ToDeg(), target.target_range_m);
+          if (ImGui::Selectable(label, id == active_target_id_)) {
+            this->SelectTarget(id);
+          }
+          if (id == active_target_id_) {
+            ImGui::SetItemDefaultFocus();
+          }
+        }
+        ImGui::EndCombo();
+      }
+      ImGui::PopItemWidth();
+
+      ImGui::SameLine();
+      if (ImGui::Button(GetText(TextId::kAddTarget))) {
+        TargetData target = this->GetPanelTarget();
+        target.target_bearing = (target.target_bearing + Angle::FromDeg(kNewTargetBearingOffsetDeg)).WrapAround();
+        this->SelectTarget(targets_.Add(target));
+      }
+
+      ImGui::SameLine();
+      ImGui::BeginDisabled(targets_.GetCount() <= 1);
+      if (ImGui::Button(GetText(TextId::kRemoveTarget))) {
+        TargetId const removed_id = active_target_id_;
+        active_target_id_ = 0;
+        targets_.Remove(removed_id);
+        this->SelectTarget(targets_.GetId(0));
+      }
+      ImGui::EndDisabled();
+    }
     
     ImGui::PushItemWidth(180.0f);
     SliderFloatWithId("Torpedo Speed", &torpedo_spec_.speed_kn, 1.0f, kMaxTorpedoSpeedKn, "%.0f", ImGuiSliderFlags_None, "%s (kn)", GetText(TextId::kTorpedoSpeed));
-    target_bearing_.ImGuiSliderDegWithId("TargetBearing", 0.0f, 359.0f, "%.2f", "%s (deg)", GetText(TextId::kTargetBearing));
+    SliderAngleDegWithId("TargetBearing", &target_bearing_, 0.0f, 359.0f, "%.2f", "%s (deg)", GetText(TextId::kTargetBearing));
     SliderFloatWithId("TargetRange", &target_range_m_, 300.0f, 4000.0f, "%.0f", ImGuiSliderFlags_None, "%s (m)", GetText(TextId::kTargetRange));
     SliderFloatWithId("TargetSpeed", &target_speed_kn_, 0.0f, kMaxTargetSpeedKn, "%.0f", ImGuiSliderFlags_None, "%s (kn)", GetText(TextId::kTargetSpeed));
-    angle_on_bow_.ImGuiSliderDegWithId("AngleOnBow", -180.0f, 180.0f, "%.1f", "%s (deg)", GetText(TextId::kAngleOnBow));
+    SliderAngleDegWithId("AngleOnBow", &angle_on_bow_, -180.0f, 180.0f, "%.1f", "%s (deg)", GetText(TextId::kAngleOnBow));
     ImGui::PopItemWidth();
   }
   ImGui::EndGroup();
@@ -951,27 +748,60 @@ void Tdc::DoPanelImGui(
   ImGui::BeginGroup();
   {
     ImGui::TextColored(ImVec4(0.6f, 0.8f, 1.0f, 1.0f), "%s:", GetText(TextId::kOutput));
-    if (!tri_solution_.has_value()) {
+    if (result.sequence != 0) {
+      double const age_ms = std::chrono::duration<double, std::milli>(result.GetAge(std::chrono::steady_clock::now())).count();
+      ImGui::SameLine();
+      ImGui::TextDisabled("%s: %.1f ms", GetText(TextId::kSolutionAge), age_ms);
+    }
+    if (!tri_solution.has_value()) {
       ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%s", GetText(TextId::kNoSolution));
     }
     else {
-      TorpedoTriangleSolution const& solution = tri_solution_.value();
+      TorpedoTriangleSolution const& solution = tri_solution.value();
 
       ImGui::Text("%s: %.1f deg", GetText(TextId::kTargetCourse), solution.target_course.ToDeg());
       ImGui::Text("%s: %.1f deg", GetText(TextId::kLeadAngle), solution.lead_angle.ToDeg());
       ImGui::Text("%s: %s %.1f deg", GetText(TextId::kPseudoTorpedoGyroAngle), solution.pseudo_torpedo_gyro_angle.AsRad() >= 0.0f ? "R" : "L", solution.pseudo_torpedo_gyro_angle.Abs().ToDeg());
 
 #if 1
-      if (pc_solution_.has_value()) {
-        ImGui::Text("%s: %.2f deg", GetText(TextId::kParallaxCorrection), pc_solution_->delta * RAD2DEG);
+      if (pc_solution.has_value()) {
+        ImGui::Text("%s: %.2f deg", GetText(TextId::kParallaxCorrection), pc_solution->delta * RAD2DEG);
         ImGui::Spacing();
         ImGui::TextColored(ImVec4(0.5f, 0.7f, 0.5f, 1.0f), "%s:", GetText(TextId::kAfterParallaxCorrection));
-        ImGui::Text("%s: %.1f deg", GetText(TextId::kLeadAngle), pc_solution_->beta * RAD2DEG);
-        ImGui::Text("%s: %s %.1f deg", GetText(TextId::kGyroAngle), pc_solution_->rho >= 0.0f ? "R" : "L", std::abs(pc_solution_->rho) * RAD2DEG);
-        ImGui::Text("%s: %.1f m", GetText(TextId::kTorpedoRunDistance), pc_solution_->torpedo_run_distance_m);
-        ImGui::Text("%s: %.1f s", GetText(TextId::kTimeToImpact), pc_solution_->torpedo_time_to_target_s);
+        ImGui::Text("%s: %.1f deg", GetText(TextId::kLeadAngle), pc_solution->beta * RAD2DEG);
+        ImGui::Text("%s: %s %.1f deg", GetText(TextId::kGyroAngle), pc_solution->rho >= 0.0f ? "R" : "L", std::abs(pc_solution->rho) * RAD2DEG);
+        ImGui::Text("%s: %.1f m", GetText(TextId::kTorpedoRunDistance), pc_solution->torpedo_run_distance_m);
+        ImGui::Text("%s: %.1f s", GetText(TextId::kTimeToImpact), pc_solution->torpedo_time_to_target_s);
       }
 #endif
+
+      ImGui::Spacing();
+      ImGui::TextColored(ImVec4(0.5f, 0.7f, 0.5f, 1.0f), "%s:", GetText(TextId::kParallaxSolver));
+      if (ImGui::RadioButton(GetText(TextId::kSolverGeometry), pc_method_ == ParallaxSolveMethod::kGeometry)) {
+        pc_method_ = ParallaxSolveMethod::kGeometry;
+      }
+      ImGui::SameLine();
+      if (ImGui::RadioButton(GetText(TextId::kSolverNewton), pc_method_ == ParallaxSolveMethod::kNewton)) {
+        pc_method_ = ParallaxSolveMethod::kNewton;
+      }
+      ImGui::SameLine();
+      if (ImGui::RadioButton(GetText(TextId::kSolverSiemens), pc_method_ == ParallaxSolveMethod::kSiemens)) {
+        pc_method_ = ParallaxSolveMethod::kSiemens;
+      }
+      if (pc_solution.has_value()) {
+        ImGui::SameLine();
+        if (result.parallax_solution_from_firing_table) {
+          ImGui::TextDisabled("%s", GetText(TextId::kFromFiringTable));
+        }
+        else {
+          ImGui::TextDisabled("%s: %u", GetText(TextId::kIterations), pc_solution->iterations);
+        }
+      }
+      if (firing_table_ != nullptr) {
+        ImGui::BeginDisabled(!firing_table_->IsGeneratedFor(torpedo_spec_));
+        ImGui::Checkbox(GetText(TextId::kUseFiringTable), &use_firing_table_);
+        ImGui::EndDisabled();
+      }
     }
   }
   ImGui::EndGroup();
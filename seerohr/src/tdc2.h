@@ -1,70 +1,51 @@
 ﻿#pragma once
 
 // c++ headers ------------------------------------------
+#include <memory>
 #include <optional>
+#include <span>
+#include <vector>
 
 // external headers -------------------------------------
 #include "raylib-cpp.hpp"
 
 // project headers --------------------------------------
 #include "angle.h"
+#include "tdc2_async.h"
+#include "tdc2_epf.h"
+#include "tdc2_graph.h"
+#include "tdc2_solver.h"
+#include "tdc2_spatial.h"
+#include "tdc2_table.h"
+#include "tdc2_targets.h"
 
 namespace tdc2 {
 
-struct TorpedoSpec final {
-  /// Distance in meters from the aiming device to the torpedo tube.
-  float distance_to_tube = 27.0f;
-  /// Initial straight run in meters; distance the torpedo runs straight ahead before starting to turn.
-  float reach = 9.5f;
-  /// Turn radius of the torpedo in meters.
-  float turn_radius = 95.0f;
-  /// Speed of the torpedo in knots.
-  float speed_kn = 30.0f;
-
-  /// Compute the offset to the equivalent point of fire, or ideeller Torpedoeintrittsort as it is called in German.
-  ///
-  /// * `rho`: Gyro angle, or Schusswinkel, for which to compute the equivalent point of fire offset. Positive is starboard, negative is port.
-  ///
-  /// ## Returns
-  /// Positive X is forward along the torpedo's initial course, positive Y is to starboard.
-  raylib::Vector2 ComputeEquivalentPointOfFireOffset(float rho) const;
-};
-
-struct TorpedoTriangleIntermediate final {
-  Angle ownship_course = Angle(0.0f);
-  Angle absolute_target_bearing = Angle(0.0f);
-  Angle target_course = Angle(0.0f);
-};
-
-struct TorpedoTriangleSolution final {
-  Angle target_course = Angle::FromDeg(0.0f);
-  Angle lead_angle = Angle::FromDeg(0.0f);
-  Angle intercept_angle = Angle::FromDeg(0.0f);
-  float torpedo_time_to_target_s = 0.0f;
-  Angle pseudo_torpedo_gyro_angle = Angle::FromDeg(0.0f); // Signed: Positive is starboard, negative is port.
-  raylib::Vector2 impact_position = { 0.0f, 0.0f }; // Note no parallax correction applied.
-};
-
-struct ParallaxCorrectionSolution final {
-  float delta = 0.0f; // Parallax correction angle, or Winkelparallaxverbesserung.
-  float rho = 0.0f;   // Final torpedo gyro angle, or Schusswinkel.
-  float gamma = 0.0f; // γ = θ1 - Δ: Angle on bow as seen from the equivalent point of fire.
-  float beta = 0.0f;  // β: Lead angle as seen from the equivalent point of fire.
-  raylib::Vector2 epf_offset {};
-
-  float torpedo_run_distance_m = 0.0f;
-  float torpedo_time_to_target_s = 0.0f;
-
-  raylib::Vector2 impact_position = { 0.0f, 0.0f };
-};
-
 class Tdc final {
 public:
+  Tdc();
+
+  /// Solve every tracked target, on `job_system` if given, and submit the current inputs of the active one to the solver.
+  /// Does not wait for the solve; see `AcquireSolution`.
   void Update(
     Angle ownship_course,
-    raylib::Vector2 const& aiming_device_position
+    raylib::Vector2 const& aiming_device_position,
+    JobSystem* job_system = nullptr
   );
 
+  /// Inputs as `Update` would submit them.
+  TdcInputs GetInputs(
+    Angle ownship_course,
+    raylib::Vector2 const& aiming_device_position
+  ) const;
+
+  /// Take the target bearing, range, speed and angle on bow of the active target from `observed`, e.g. as observed in a
+  /// `Simulation`, in place of those set on the panel.
+  void SetTargetInputs(TdcInputs const& observed);
+
+  /// Take the latest complete solution for drawing. The solution may lag the inputs; the panel shows by how much.
+  void AcquireSolution();
+
   void DrawVisualization(
     raylib::Camera2D const& camera,
     raylib::Vector2 const& ownship_position,
@@ -78,23 +59,57 @@ public:
     Angle ownship_course
   );
 
+  TorpedoSpec const& GetTorpedoSpec() const { return torpedo_spec_; }
+  /// Every tracked target. The active one is as of the last `Update`.
+  TargetTable const& GetTargets() const { return targets_; }
+  /// Track `targets` in place of every current one, the first of them active. Does nothing if `targets` is empty.
+  void SetTargets(std::span<TargetData const> targets);
+  /// Make target `id` the active one, keeping what is set on the panel for the one active so far.
+  void SelectTarget(TargetId id);
+  TargetId GetActiveTargetId() const { return active_target_id_; }
+  /// The target nearest to `position` within `radius`, as of the last `Update`.
+  std::optional<TargetId> FindTargetAt(Vec2 const& position, float radius) const;
+
+  /// Use `firing_table` for solves whose `TorpedoSpec` it was generated for, falling back to the solver outside of it.
+  /// Pass null to always solve.
+  void SetFiringTable(std::shared_ptr<FiringTable const> firing_table);
+
 private:
+  /// The active target as set on the panel.
+  TargetData GetPanelTarget() const;
+  void SetPanelTarget(TargetData const& target);
+
   //
   // TDC inputs.
   //
 
   TorpedoSpec torpedo_spec_;
-  
+
   Angle target_bearing_ = Angle::FromDeg(280.0f);
   float target_range_m_ = 900.0f;
   float target_speed_kn_ = 20.0f;
   Angle angle_on_bow_ = Angle::FromDeg(70.0f);
 
-  // TDC outputs.
-  TorpedoTriangleIntermediate interm_;
+  // Every tracked target; the panel shows and edits the active one, which is the only one the worker solves in full.
+  TargetTable targets_;
+  TargetId active_target_id_ = 0;
+
+  // Where the targets are and where their torpedoes would hit, as of the last `Update`; for culling and picking.
+  static constexpr float kTargetGridCellM = 500.0f;
+  SpatialGrid target_grid_ { kTargetGridCellM };
+  SpatialGrid impact_grid_ { kTargetGridCellM };
+  std::vector<Vec2> impact_positions_; // Scratch; NaN where there is no solution.
+
+  ParallaxSolveMethod pc_method_ = ParallaxSolveMethod::kGeometry;
+
+  std::shared_ptr<FiringTable const> firing_table_;
+  bool use_firing_table_ = true;
+
+  // TDC outputs, solved on a worker thread; recomputed only downstream of the inputs that changed since the last solve.
+  AsyncTdcSolver solver_;
 
-  std::optional<TorpedoTriangleSolution> tri_solution_;
-  std::optional<ParallaxCorrectionSolution> pc_solution_;
+  // For drawing the equivalent point of fire of the solution; the solver has its own on the worker thread.
+  mutable EquivalentPointOfFireCurveCache epf_curve_cache_;
 };
 
 } // namespace tdc2
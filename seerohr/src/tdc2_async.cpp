@@ -0,0 +1,79 @@
+// TU header --------------------------------------------
+#include "tdc2_async.h"
+
+// c++ headers ------------------------------------------
+#include <utility>
+
+// public project headers --------------------------------
+#include "mbase/public/platform.h"
+
+namespace tdc2 {
+
+AsyncTdcSolver::AsyncTdcSolver() {
+#if !MBASE_PLATFORM_WEB
+  worker_ = std::thread(&AsyncTdcSolver::RunWorker, this);
+#endif
+}
+
+AsyncTdcSolver::~AsyncTdcSolver() {
+  if (worker_.joinable()) {
+    stopping_.store(true, std::memory_order_relaxed);
+    latest_sequence_.fetch_add(1, std::memory_order_release);
+    latest_sequence_.notify_one();
+    worker_.join();
+  }
+}
+
+void AsyncTdcSolver::Submit(TdcInputs const& inputs, std::shared_ptr<FiringTable const> firing_table) {
+  InputSnapshot& snapshot = inputs_.GetWriteSlot();
+  snapshot.inputs = inputs;
+  snapshot.firing_table = std::move(firing_table);
+  snapshot.sequence = ++submitted_count_;
+  snapshot.submit_time = std::chrono::steady_clock::now();
+  inputs_.Publish();
+
+  if (!worker_.joinable()) {
+    this->SolveLatest();
+    return;
+  }
+
+  latest_sequence_.store(submitted_count_, std::memory_order_release);
+  latest_sequence_.notify_one();
+}
+
+bool AsyncTdcSolver::Poll() {
+  return results_.Acquire();
+}
+
+void AsyncTdcSolver::SolveLatest() {
+  if (!inputs_.Acquire()) {
+    return;
+  }
+  InputSnapshot const& snapshot = inputs_.GetReadSlot();
+
+  graph_.Update(snapshot.inputs);
+
+  TdcSolveResult& result = results_.GetWriteSlot();
+  result.sequence = snapshot.sequence;
+  result.submit_time = snapshot.submit_time;
+  result.intermediate = graph_.GetIntermediate();
+  result.triangle_solution = graph_.GetTriangleSolution();
+  result.parallax_solution = graph_.GetParallaxSolution();
+  result.parallax_solution_from_firing_table = graph_.IsParallaxSolutionFromFiringTable();
+  results_.Publish();
+}
+
+void AsyncTdcSolver::RunWorker() {
+  uint64_t seen_sequence = 0;
+  for (;;) {
+    latest_sequence_.wait(seen_sequence, std::memory_order_acquire);
+    if (stopping_.load(std::memory_order_relaxed)) {
+      break;
+    }
+    seen_sequence = latest_sequence_.load(std::memory_order_acquire);
+
+    this->SolveLatest();
+  }
+}
+
+} // namespace tdc2
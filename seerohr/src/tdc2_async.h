@@ -0,0 +1,86 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <thread>
+
+// project headers --------------------------------------
+#include "triple_buffer.h"
+#include "tdc2_graph.h"
+#include "tdc2_solver.h"
+
+namespace tdc2 {
+
+/// One complete solve of an `AsyncTdcSolver`, consistent with the inputs it was solved from.
+struct TdcSolveResult final {
+  /// Sequence number of the inputs, counting submissions from 1. 0: Nothing solved yet.
+  uint64_t sequence = 0;
+  /// When the inputs were submitted.
+  std::chrono::steady_clock::time_point submit_time;
+
+  TorpedoTriangleIntermediate intermediate;
+  std::optional<TorpedoTriangleSolution> triangle_solution;
+  std::optional<ParallaxCorrectionSolution> parallax_solution;
+  /// Whether `parallax_solution` was looked up in the firing table rather than solved for.
+  bool parallax_solution_from_firing_table = false;
+
+  /// Time since the inputs were submitted; how far the result lags behind them.
+  std::chrono::steady_clock::duration GetAge(std::chrono::steady_clock::time_point now) const {
+    return now - submit_time;
+  }
+};
+
+/// Solves a `TdcGraph` on a dedicated worker thread, so that solving never stretches the frame.
+///
+/// The UI thread submits input snapshots and polls for results; the worker always solves the latest snapshot, dropping
+/// the ones it did not get to. Both directions go through a `TripleBuffer`, so neither thread ever waits for the other.
+///
+/// On the web, without threads, `Submit` solves inline.
+class AsyncTdcSolver final {
+public:
+  AsyncTdcSolver();
+  ~AsyncTdcSolver();
+
+  AsyncTdcSolver(AsyncTdcSolver const&) = delete;
+  AsyncTdcSolver& operator=(AsyncTdcSolver const&) = delete;
+
+  /// Hand `inputs` to the worker. `firing_table` keeps `inputs.firing_table` alive until the worker is done with it.
+  void Submit(TdcInputs const& inputs, std::shared_ptr<FiringTable const> firing_table);
+
+  /// Take the latest complete result. Returns whether it changed.
+  bool Poll();
+
+  /// The result taken by the last `Poll`.
+  TdcSolveResult const& GetResult() const { return results_.GetReadSlot(); }
+
+private:
+  struct InputSnapshot final {
+    TdcInputs inputs;
+    std::shared_ptr<FiringTable const> firing_table;
+    uint64_t sequence = 0;
+    std::chrono::steady_clock::time_point submit_time;
+  };
+
+  /// Solve the latest submitted snapshot, if there is a new one, and publish the result.
+  void SolveLatest();
+  void RunWorker();
+
+  TripleBuffer<InputSnapshot> inputs_;
+  TripleBuffer<TdcSolveResult> results_;
+
+  uint64_t submitted_count_ = 0; // UI thread only.
+  // Sequence number of the latest published snapshot; the worker waits on it.
+  std::atomic<uint64_t> latest_sequence_ = 0;
+  std::atomic<bool> stopping_ = false;
+
+  TdcGraph graph_; // Worker only.
+
+  std::thread worker_;
+};
+
+} // namespace tdc2
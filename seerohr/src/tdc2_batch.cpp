@@ -0,0 +1,604 @@
+// TU header --------------------------------------------
+#include "tdc2_batch.h"
+
+// c++ headers ------------------------------------------
+#include <cassert>
+#include <cmath>
+
+#include <algorithm>
+#include <limits>
+#include <numbers>
+
+// project headers --------------------------------------
+#include "tdc2_epf.h"
+#include "tdc2_kernels.h"
+#include "tdc2_lane_math.h"
+
+namespace tdc2 {
+
+namespace {
+
+/// Number of scenarios processed together. Most stages below loop over a full block, without library calls or
+/// data-dependent control flow, so the compiler maps them onto SIMD registers. Lane masks are `int32_t`, as wide as the
+/// floats they select between, so a register holds as many of either.
+constexpr std::size_t kLaneCount = 8;
+
+/// Number of scenarios iterated together by the parallax correction solver.
+constexpr std::size_t kParallaxLaneCount = 16;
+
+using lane::WrapPi;
+
+} // namespace
+
+void TorpedoTriangleBatchInput::Resize(std::size_t count) {
+  target_bearing.resize(count);
+  target_range_m.resize(count);
+  target_speed_kn.resize(count);
+  angle_on_bow.resize(count);
+  ownship_course.resize(count);
+  aiming_device_x.resize(count);
+  aiming_device_y.resize(count);
+}
+
+void TorpedoTriangleBatchInput::Set(
+  std::size_t index,
+  TorpedoTriangle const& triangle,
+  Angle ownship_course,
+  Vec2 const& aiming_device_position
+) {
+  assert(index < this->Size());
+
+  this->target_bearing[index] = triangle.target_bearing.AsRad();
+  this->target_range_m[index] = triangle.target_range_m;
+  this->target_speed_kn[index] = triangle.target_speed_kn;
+  this->angle_on_bow[index] = triangle.angle_on_bow.AsRad();
+  this->ownship_course[index] = ownship_course.AsRad();
+  this->aiming_device_x[index] = aiming_device_position.x;
+  this->aiming_device_y[index] = aiming_device_position.y;
+}
+
+void TorpedoTriangleBatchOutput::Resize(std::size_t count) {
+  target_course.resize(count);
+  lead_angle.resize(count);
+  intercept_angle.resize(count);
+  torpedo_time_to_target_s.resize(count);
+  pseudo_torpedo_gyro_angle.resize(count);
+  impact_x.resize(count);
+  impact_y.resize(count);
+  valid.resize(count);
+}
+
+std::optional<TorpedoTriangleSolution> TorpedoTriangleBatchOutput::Get(std::size_t index) const {
+  assert(index < this->Size());
+
+  if (this->valid[index] == 0) {
+    return std::nullopt;
+  }
+
+  return TorpedoTriangleSolution {
+    .target_course = Angle(this->target_course[index]),
+    .lead_angle = Angle(this->lead_angle[index]),
+    .intercept_angle = Angle(this->intercept_angle[index]),
+    .torpedo_time_to_target_s = this->torpedo_time_to_target_s[index],
+    .pseudo_torpedo_gyro_angle = Angle(this->pseudo_torpedo_gyro_angle[index]),
+    .impact_position = Vec2 { this->impact_x[index], this->impact_y[index] },
+  };
+}
+
+void ParallaxCorrectionBatchOutput::Resize(std::size_t count) {
+  delta.resize(count);
+  rho.resize(count);
+  gamma.resize(count);
+  beta.resize(count);
+  epf_offset_x.resize(count);
+  epf_offset_y.resize(count);
+  torpedo_run_distance_m.resize(count);
+  torpedo_time_to_target_s.resize(count);
+  impact_x.resize(count);
+  impact_y.resize(count);
+  valid.resize(count);
+  iterations.resize(count);
+}
+
+std::optional<ParallaxCorrectionSolution> ParallaxCorrectionBatchOutput::Get(std::size_t index) const {
+  assert(index < this->Size());
+
+  if (this->valid[index] == 0) {
+    return std::nullopt;
+  }
+
+  return ParallaxCorrectionSolution {
+    .delta = this->delta[index],
+    .rho = this->rho[index],
+    .gamma = this->gamma[index],
+    .beta = this->beta[index],
+    .epf_offset = Vec2 { this->epf_offset_x[index], this->epf_offset_y[index] },
+    .torpedo_run_distance_m = this->torpedo_run_distance_m[index],
+    .torpedo_time_to_target_s = this->torpedo_time_to_target_s[index],
+    .impact_position = Vec2 { this->impact_x[index], this->impact_y[index] },
+    .iterations = this->iterations[index],
+  };
+}
+
+void SolveTorpedoTriangleBatch(
+  float torpedo_speed_kn,
+  TorpedoTriangleBatchInput const& input,
+  TorpedoTriangleBatchOutput& output
+) {
+  SolveTorpedoTriangleBatch(torpedo_speed_kn, input, output, 0, input.Size());
+}
+
+void SolveTorpedoTriangleBatch(
+  float torpedo_speed_kn,
+  TorpedoTriangleBatchInput const& input,
+  TorpedoTriangleBatchOutput& output,
+  std::size_t first,
+  std::size_t count
+) {
+  assert(torpedo_speed_kn > 0.0f);
+  assert(output.Size() == input.Size());
+  assert(first + count <= input.Size());
+
+  // NOTE: The constants and the order of every operation below mirror `TorpedoTriangle::Solve` and the `Angle` operators it uses.
+  //       Do not "simplify" the arithmetic; doing so breaks bit-exact agreement with the scalar path.
+  float const kPi = std::numbers::pi_v<float>;
+  float const kRightAngle = std::numbers::pi_v<float> * 0.5f;
+  float const kTwoPi = 2.0f * std::numbers::pi_v<float>;
+
+  float const torpedo_speed_mps = torpedo_speed_kn * 1852.0f / 3600.0f;
+
+  std::size_t const last = first + count;
+
+  for (std::size_t base = first; base < last; base += kLaneCount) {
+    std::size_t const lane_count = std::min(kLaneCount, last - base);
+
+    // Gather one block of inputs. Tail lanes are padded with a benign scenario and never stored.
+    float bearing[kLaneCount];
+    float range[kLaneCount];
+    float target_speed[kLaneCount];
+    float aob[kLaneCount];
+    float course[kLaneCount];
+    float aim_x[kLaneCount];
+    float aim_y[kLaneCount];
+    for (std::size_t l = 0; l < kLaneCount; ++l) {
+      std::size_t const i = base + std::min(l, lane_count - 1);
+      bearing[l] = input.target_bearing[i];
+      range[l] = input.target_range_m[i];
+      target_speed[l] = input.target_speed_kn[i];
+      aob[l] = input.angle_on_bow[i];
+      course[l] = input.ownship_course[i];
+      aim_x[l] = input.aiming_device_x[i];
+      aim_y[l] = input.aiming_device_y[i];
+    }
+
+    // PrepareSolve. `std::fmod` stays a library call: It is exact, and so must be the wrap of `Angle::WrapAround`.
+    float absolute_target_bearing[kLaneCount];
+    float target_course[kLaneCount];
+    for (std::size_t l = 0; l < kLaneCount; ++l) {
+      absolute_target_bearing[l] = course[l] + bearing[l];
+
+      float r = std::fmod((absolute_target_bearing[l] + kPi) - aob[l], kTwoPi);
+      target_course[l] = (r < 0.0f) ? (r + kTwoPi) : r;
+    }
+
+    // Common terms.
+    float abs_aob[kLaneCount];
+    float sin_abs_aob[kLaneCount];
+    float sign_aob[kLaneCount];
+    int32_t degenerate[kLaneCount];
+    for (std::size_t l = 0; l < kLaneCount; ++l) {
+      abs_aob[l] = std::abs(aob[l]);
+      sin_abs_aob[l] = lane::Sin(abs_aob[l]);
+      sign_aob[l] = (aob[l] > 0.0f) ? 1.0f : ((aob[l] < 0.0f) ? -1.0f : 0.0f);
+      degenerate[l] = (aob[l] == 0.0f) | (abs_aob[l] == kPi);
+    }
+
+    // Branch A: Target course line is identical to ownship line (AoB == 0 or 180 degrees).
+    int32_t a_valid[kLaneCount];
+    float a_time[kLaneCount];
+    float a_run[kLaneCount];
+    float a_intercept[kLaneCount];
+    for (std::size_t l = 0; l < kLaneCount; ++l) {
+      bool const bow_on = (aob[l] == 0.0f);
+
+      float const target_speed_seen_from_torpedo_kn = (bow_on ? -target_speed[l] : target_speed[l]) - torpedo_speed_kn;
+      float const signed_target_speed_kn = bow_on ? target_speed[l] : -target_speed[l];
+
+      a_valid[l] = (target_speed_seen_from_torpedo_kn < 0.0f);
+      a_time[l] = range[l] / ((torpedo_speed_kn + signed_target_speed_kn) * 1852.0f / 3600.0f);
+      a_run[l] = (torpedo_speed_kn * 1852.0f / 3600.0f) * a_time[l];
+      a_intercept[l] = (signed_target_speed_kn >= 0.0f) ? kPi : 0.0f;
+    }
+
+    // Branch B: General torpedo triangle.
+    int32_t b_valid[kLaneCount];
+    float b_lead[kLaneCount];
+    float b_intercept[kLaneCount];
+    float b_run[kLaneCount];
+    float b_time[kLaneCount];
+    int32_t b_ill_conditioned[kLaneCount];
+    for (std::size_t l = 0; l < kLaneCount; ++l) {
+      float const sin_lead_angle = target_speed[l] / torpedo_speed_kn * sin_abs_aob[l];
+      bool const lead_ok = !(1.0f < sin_lead_angle);
+
+      b_lead[l] = lane::Asin(lead_ok ? sin_lead_angle : 0.0f);
+      b_intercept[l] = (kPi - abs_aob[l]) - b_lead[l];
+      b_valid[l] = lead_ok & (0.0f < b_intercept[l]);
+
+      float const sin_intercept = lane::Sin(b_intercept[l]);
+      b_run[l] = range[l] / sin_intercept * sin_abs_aob[l];
+      b_time[l] = b_run[l] / torpedo_speed_mps;
+      // Without a lead angle, the scalar path leaves the intercept angle unset, but the lead angle alone flags the lane.
+      b_ill_conditioned[l] = IsTorpedoTriangleIllConditioned(sin_abs_aob[l], sin_lead_angle, sin_intercept);
+    }
+
+    // Float rounding dominates ill-conditioned triangles; solve them again in double, as `TorpedoTriangle::Solve` does.
+    for (std::size_t l = 0; l < lane_count; ++l) {
+      if (degenerate[l] != 0 || b_ill_conditioned[l] == 0) {
+        continue;
+      }
+      TorpedoTriangleCore<double> const refined = SolveTorpedoTriangleCore<double>(
+        torpedo_speed_kn, target_speed[l], range[l], abs_aob[l]
+      );
+      b_valid[l] = refined.valid;
+      b_lead[l] = static_cast<float>(refined.lead_angle);
+      b_intercept[l] = static_cast<float>(refined.intercept_angle);
+      b_run[l] = static_cast<float>(refined.torpedo_run_distance_m);
+      b_time[l] = b_run[l] / torpedo_speed_mps;
+    }
+
+    // Select, and compute the impact position along the (pseudo) torpedo course.
+    int32_t out_valid[kLaneCount];
+    float out_target_course[kLaneCount];
+    float out_lead_angle[kLaneCount];
+    float out_intercept_angle[kLaneCount];
+    float out_time_to_target[kLaneCount];
+    float out_pseudo_torpedo_gyro_angle[kLaneCount];
+    float out_impact_x[kLaneCount];
+    float out_impact_y[kLaneCount];
+    for (std::size_t l = 0; l < kLaneCount; ++l) {
+      bool const is_degenerate = (degenerate[l] != 0);
+      int32_t const is_valid = (degenerate[l] & a_valid[l]) | ((degenerate[l] ^ 1) & b_valid[l]);
+
+      float const lead_angle = lane::Select(is_degenerate, 0.0f, b_lead[l]);
+      float const run = lane::Select(is_degenerate, a_run[l], b_run[l]);
+      float const intercept_angle = lane::Select(is_degenerate, a_intercept[l], b_intercept[l]);
+      float const time_to_target = lane::Select(is_degenerate, a_time[l], b_time[l]);
+
+      float const torpedo_course = lane::Select(is_degenerate, absolute_target_bearing[l], absolute_target_bearing[l] + lead_angle * sign_aob[l]);
+      float const pseudo_torpedo_gyro_angle = lane::Select(is_degenerate, bearing[l], torpedo_course - course[l]);
+
+      float const impact_angle = torpedo_course - kRightAngle;
+
+      out_valid[l] = is_valid;
+      out_target_course[l] = lane::Select(is_valid != 0, target_course[l], 0.0f);
+      out_lead_angle[l] = lane::Select(is_valid != 0, lead_angle, 0.0f);
+      out_intercept_angle[l] = lane::Select(is_valid != 0, intercept_angle, 0.0f);
+      out_time_to_target[l] = lane::Select(is_valid != 0, time_to_target, 0.0f);
+      out_pseudo_torpedo_gyro_angle[l] = lane::Select(is_valid != 0, pseudo_torpedo_gyro_angle, 0.0f);
+      out_impact_x[l] = lane::Select(is_valid != 0, aim_x[l] + run * lane::Cos(impact_angle), 0.0f);
+      out_impact_y[l] = lane::Select(is_valid != 0, aim_y[l] + run * lane::Sin(impact_angle), 0.0f);
+    }
+
+    for (std::size_t l = 0; l < lane_count; ++l) {
+      std::size_t const i = base + l;
+
+      output.valid[i] = static_cast<uint8_t>(out_valid[l]);
+      output.target_course[i] = out_target_course[l];
+      output.lead_angle[i] = out_lead_angle[l];
+      output.intercept_angle[i] = out_intercept_angle[l];
+      output.torpedo_time_to_target_s[i] = out_time_to_target[l];
+      output.pseudo_torpedo_gyro_angle[i] = out_pseudo_torpedo_gyro_angle[l];
+      output.impact_x[i] = out_impact_x[l];
+      output.impact_y[i] = out_impact_y[l];
+    }
+  }
+}
+
+void SolveParallaxCorrectionBatch(
+  TorpedoSpec const& torpedo_spec,
+  TorpedoTriangleBatchInput const& input,
+  TorpedoTriangleBatchOutput const& tri_output,
+  ParallaxCorrectionBatchOutput& output,
+  EquivalentPointOfFireCurve const* epf_curve,
+  float const* start_gyro_angles
+) {
+  SolveParallaxCorrectionBatch(torpedo_spec, input, tri_output, output, 0, input.Size(), epf_curve, start_gyro_angles);
+}
+
+namespace {
+
+/// `SolveParallaxCorrectionBatch` for `Spec`, either `TorpedoSpec` or a `PresetTorpedoSpec` whose constants fold.
+template <typename Spec>
+void SolveParallaxCorrectionBatchWith(
+  Spec const& torpedo_spec,
+  TorpedoTriangleBatchInput const& input,
+  TorpedoTriangleBatchOutput const& tri_output,
+  ParallaxCorrectionBatchOutput& output,
+  std::size_t first,
+  std::size_t count,
+  EquivalentPointOfFireCurve const* epf_curve,
+  float const* start_gyro_angles
+) {
+  assert(tri_output.Size() == input.Size());
+  assert(output.Size() == input.Size());
+  assert(first + count <= input.Size());
+
+  constexpr uint32_t kIters = ParallaxCorrectionSolver::kIters;
+  constexpr float kTolerance = ParallaxCorrectionSolver::kTolerance;
+  constexpr float kLambda = ParallaxCorrectionSolver::kLambda;
+  constexpr uint32_t kStallIters = ParallaxCorrectionSolver::kStallIters;
+
+  // NOTE: The order of every operation below mirrors `ParallaxCorrectionSolver::SolveByGeometry`.
+  //       Do not "simplify" the arithmetic; doing so breaks bit-exact agreement with the scalar path.
+  std::size_t const last = first + count;
+
+  // Per-lane state, stepped from one copy into another: Were a lane loop to select into the array it reads, the compiler
+  // would turn the select back into a conditional store, and give up on vectorizing the loop.
+  struct LaneState final {
+    float rho[kParallaxLaneCount];
+    int32_t active[kParallaxLaneCount];
+    int32_t converged[kParallaxLaneCount];
+    int32_t iterations[kParallaxLaneCount];
+    float min_step[kParallaxLaneCount];
+    int32_t stall_iterations[kParallaxLaneCount];
+
+    // Captured at convergence, for the final solution.
+    float delta[kParallaxLaneCount];
+    float gamma[kParallaxLaneCount];
+    float beta[kParallaxLaneCount];
+    float epf_x[kParallaxLaneCount];
+    float epf_y[kParallaxLaneCount];
+    float e_to_t_x[kParallaxLaneCount];
+    float e_to_t_y[kParallaxLaneCount];
+  };
+
+  float const* const start_rho = (start_gyro_angles != nullptr) ? start_gyro_angles : tri_output.pseudo_torpedo_gyro_angle.data();
+  float const torpedo_speed_mps = torpedo_spec.speed_kn * 1852.0f / 3600.0f;
+
+  // Per-lane constants of the scenario in the lane. Lanes left without one stay inactive.
+  std::size_t scenarios[kParallaxLaneCount] = {};
+  float omega1[kParallaxLaneCount] = {};
+  float gamma1[kParallaxLaneCount] = {};
+  float speed_ratio[kParallaxLaneCount] = {};
+  float t_x[kParallaxLaneCount] = {};
+  float t_y[kParallaxLaneCount] = {};
+
+  LaneState state {};
+  LaneState next;
+
+  auto write_failure = [&](std::size_t i, int32_t iterations) {
+    output.iterations[i] = static_cast<uint8_t>(iterations);
+    output.valid[i] = 0;
+    output.delta[i] = 0.0f;
+    output.rho[i] = 0.0f;
+    output.gamma[i] = 0.0f;
+    output.beta[i] = 0.0f;
+    output.epf_offset_x[i] = 0.0f;
+    output.epf_offset_y[i] = 0.0f;
+    output.torpedo_run_distance_m[i] = 0.0f;
+    output.torpedo_time_to_target_s[i] = 0.0f;
+    output.impact_x[i] = 0.0f;
+    output.impact_y[i] = 0.0f;
+  };
+
+  // Put the next scenario with a triangle solution into lane `l`; those without one fail as they are passed over.
+  std::size_t next_scenario = first;
+  auto load_lane = [&](std::size_t l) {
+    while (next_scenario < last && tri_output.valid[next_scenario] == 0) {
+      write_failure(next_scenario, 0);
+      ++next_scenario;
+    }
+    if (next_scenario == last) {
+      state.active[l] = 0;
+      return;
+    }
+    std::size_t const i = next_scenario++;
+
+    float const los = input.target_range_m[i];
+    scenarios[l] = i;
+    omega1[l] = input.target_bearing[i];
+    gamma1[l] = input.angle_on_bow[i];
+    speed_ratio[l] = input.target_speed_kn[i] / torpedo_spec.speed_kn;
+    t_x[l] = los * lane::Cos(omega1[l]);
+    t_y[l] = los * lane::Sin(omega1[l]);
+
+    state.rho[l] = start_rho[i];
+    state.active[l] = 1;
+    state.converged[l] = 0;
+    state.iterations[l] = 0;
+    state.min_step[l] = std::numeric_limits<float>::infinity();
+    state.stall_iterations[l] = 0;
+  };
+
+  auto store_lane = [&](std::size_t l) {
+    std::size_t const i = scenarios[l];
+    if (state.converged[l] == 0) {
+      write_failure(i, state.iterations[l]);
+      return;
+    }
+
+    float const ownship_course_rad = input.ownship_course[i];
+
+    float const los2 = std::sqrt(state.e_to_t_x[l] * state.e_to_t_x[l] + state.e_to_t_y[l] * state.e_to_t_y[l]);
+    float const torpedo_run_distance_m = ComputeParallaxRunDistanceMixed(los2, state.gamma[l], state.beta[l], speed_ratio[l]);
+    float const torpedo_time_to_target_s = torpedo_run_distance_m / torpedo_speed_mps;
+
+    float const rotation = ownship_course_rad - std::numbers::pi_v<float> / 2.0f;
+    float const cos_rotation = std::cos(rotation);
+    float const sin_rotation = std::sin(rotation);
+    float const e_x = input.aiming_device_x[i] + (state.epf_x[l] * cos_rotation - state.epf_y[l] * sin_rotation);
+    float const e_y = input.aiming_device_y[i] + (state.epf_x[l] * sin_rotation + state.epf_y[l] * cos_rotation);
+
+    float const run_angle = ownship_course_rad - std::numbers::pi_v<float> / 2.0f + state.rho[l];
+
+    output.iterations[i] = static_cast<uint8_t>(state.iterations[l]);
+    output.valid[i] = 1;
+    output.delta[i] = state.delta[l];
+    output.rho[i] = state.rho[l];
+    output.gamma[i] = state.gamma[l];
+    output.beta[i] = state.beta[l];
+    output.epf_offset_x[i] = state.epf_x[l];
+    output.epf_offset_y[i] = state.epf_y[l];
+    output.torpedo_run_distance_m[i] = torpedo_run_distance_m;
+    output.torpedo_time_to_target_s[i] = torpedo_time_to_target_s;
+    output.impact_x[i] = e_x + torpedo_run_distance_m * std::cos(run_angle);
+    output.impact_y[i] = e_y + torpedo_run_distance_m * std::sin(run_angle);
+  };
+
+  int32_t any_active = 0;
+  for (std::size_t l = 0; l < kParallaxLaneCount; ++l) {
+    load_lane(l);
+    any_active |= state.active[l];
+  }
+
+  // Every lane is stepped until the range is done; lanes that are not active keep their state.
+  float epf_x[kParallaxLaneCount];
+  float epf_y[kParallaxLaneCount];
+  int32_t retired[kParallaxLaneCount];
+  while (any_active != 0) {
+    if (epf_curve != nullptr) {
+      for (std::size_t l = 0; l < kParallaxLaneCount; ++l) {
+        Vec2 const epf_offset = epf_curve->Evaluate(state.rho[l]);
+        epf_x[l] = epf_offset.x;
+        epf_y[l] = epf_offset.y;
+      }
+    }
+    else {
+      for (std::size_t l = 0; l < kParallaxLaneCount; ++l) {
+        Vec2 const epf_offset = ComputeEquivalentPointOfFireOffset(torpedo_spec, state.rho[l]);
+        epf_x[l] = epf_offset.x;
+        epf_y[l] = epf_offset.y;
+      }
+    }
+
+    for (std::size_t l = 0; l < kParallaxLaneCount; ++l) {
+      float const rho = state.rho[l];
+
+      float const e_to_t_x = t_x[l] - epf_x[l];
+      float const e_to_t_y = t_y[l] - epf_y[l];
+
+      float const omega2 = lane::Atan2(e_to_t_y, e_to_t_x);
+      float const delta = WrapPi(omega1[l] - omega2);
+      float const gamma2 = WrapPi(gamma1[l] - delta);
+
+      float const sin_beta = speed_ratio[l] * lane::Sin(gamma2);
+      bool const beta_ok = !((sin_beta < -1.0f) | (1.0f < sin_beta));
+      float const beta2 = lane::Asin(beta_ok ? sin_beta : 0.0f);
+
+      float const rho_target = WrapPi(omega2 + beta2);
+      float const step = WrapPi(rho_target - rho);
+      float const rho_next = WrapPi(rho + kLambda * step);
+
+      float const abs_step = std::abs(step);
+      int32_t const new_min_step = (abs_step < state.min_step[l]);
+      int32_t const stall_iterations = (state.stall_iterations[l] + 1) * (new_min_step ^ 1);
+
+      // Mask off lanes that failed, converged, cycle or ran out of iterations; only converged lanes record their state.
+      // Masks are combined with `&` and `|`, as short-circuiting would put branches back into the loop.
+      bool const was_active = (state.active[l] != 0);
+      bool const done = was_active & beta_ok & (abs_step < kTolerance);
+      int32_t const iterations = state.iterations[l] + static_cast<int32_t>(was_active);
+      int32_t const active = was_active & beta_ok & !done & (iterations < static_cast<int32_t>(kIters))
+        & (stall_iterations < static_cast<int32_t>(kStallIters));
+
+      next.iterations[l] = iterations;
+      next.min_step[l] = lane::Select(new_min_step != 0, abs_step, state.min_step[l]);
+      next.stall_iterations[l] = stall_iterations;
+      next.rho[l] = lane::Select(was_active & beta_ok, rho_next, rho);
+      next.active[l] = active;
+      next.converged[l] = state.converged[l] | done;
+      retired[l] = state.active[l] & (active ^ 1);
+
+      next.delta[l] = lane::Select(done, delta, state.delta[l]);
+      next.gamma[l] = lane::Select(done, gamma2, state.gamma[l]);
+      next.beta[l] = lane::Select(done, beta2, state.beta[l]);
+      next.epf_x[l] = lane::Select(done, epf_x[l], state.epf_x[l]);
+      next.epf_y[l] = lane::Select(done, epf_y[l], state.epf_y[l]);
+      next.e_to_t_x[l] = lane::Select(done, e_to_t_x, state.e_to_t_x[l]);
+      next.e_to_t_y[l] = lane::Select(done, e_to_t_y, state.e_to_t_y[l]);
+    }
+    state = next;
+
+    // Lanes just done are written out and take the next scenario, so that a scenario slow to converge, or never
+    // converging, holds up no other.
+    any_active = 0;
+    for (std::size_t l = 0; l < kParallaxLaneCount; ++l) {
+      if (retired[l] != 0) {
+        store_lane(l);
+        load_lane(l);
+      }
+      any_active |= state.active[l];
+    }
+  }
+}
+
+} // namespace
+
+void SolveParallaxCorrectionBatch(
+  TorpedoSpec const& torpedo_spec,
+  TorpedoTriangleBatchInput const& input,
+  TorpedoTriangleBatchOutput const& tri_output,
+  ParallaxCorrectionBatchOutput& output,
+  std::size_t first,
+  std::size_t count,
+  EquivalentPointOfFireCurve const* epf_curve,
+  float const* start_gyro_angles
+) {
+  VisitTorpedoSpec(torpedo_spec, [&](auto const& spec) {
+    SolveParallaxCorrectionBatchWith(spec, input, tri_output, output, first, count, epf_curve, start_gyro_angles);
+  });
+}
+
+void ParallaxWarmStartBatch::Resize(std::size_t count) {
+  gyro_correction.resize(count, std::numeric_limits<float>::quiet_NaN());
+  gyro_correction_rate.resize(count, std::numeric_limits<float>::quiet_NaN());
+  start_gyro_angle.resize(count);
+}
+
+void ParallaxWarmStartBatch::Reset(std::size_t first, std::size_t count) {
+  std::fill_n(gyro_correction.begin() + first, count, std::numeric_limits<float>::quiet_NaN());
+  std::fill_n(gyro_correction_rate.begin() + first, count, std::numeric_limits<float>::quiet_NaN());
+}
+
+void ParallaxWarmStartBatch::Move(std::size_t from, std::size_t to) {
+  gyro_correction[to] = gyro_correction[from];
+  gyro_correction_rate[to] = gyro_correction_rate[from];
+}
+
+void SolveParallaxCorrectionBatchWarm(
+  TorpedoSpec const& torpedo_spec,
+  TorpedoTriangleBatchInput const& input,
+  TorpedoTriangleBatchOutput const& tri_output,
+  ParallaxWarmStartBatch& warm,
+  ParallaxCorrectionBatchOutput& output,
+  std::size_t first,
+  std::size_t count,
+  EquivalentPointOfFireCurve const* epf_curve
+) {
+  assert(warm.Size() == input.Size());
+
+  std::size_t const last = first + count;
+
+  for (std::size_t i = first; i < last; ++i) {
+    float const pseudo_gyro_angle = tri_output.pseudo_torpedo_gyro_angle[i];
+    float const correction = warm.gyro_correction[i];
+    float const rate = std::isnan(warm.gyro_correction_rate[i]) ? 0.0f : warm.gyro_correction_rate[i];
+    warm.start_gyro_angle[i] = std::isnan(correction) ? pseudo_gyro_angle : WrapPi(pseudo_gyro_angle + correction + rate);
+  }
+  SolveParallaxCorrectionBatch(torpedo_spec, input, tri_output, output, first, count, epf_curve, warm.start_gyro_angle.data());
+
+  for (std::size_t i = first; i < last; ++i) {
+    // Diverged from the warm start, e.g. after a jump of the inputs; the cold start decides whether there is a solution.
+    if (output.valid[i] == 0 && tri_output.valid[i] != 0 && !std::isnan(warm.gyro_correction[i])) {
+      SolveParallaxCorrectionBatch(torpedo_spec, input, tri_output, output, i, 1, epf_curve);
+    }
+    float const correction = (output.valid[i] != 0)
+      ? WrapPi(output.rho[i] - tri_output.pseudo_torpedo_gyro_angle[i])
+      : std::numeric_limits<float>::quiet_NaN();
+    warm.gyro_correction_rate[i] = correction - warm.gyro_correction[i];
+    warm.gyro_correction[i] = correction;
+  }
+}
+
+} // namespace tdc2
@@ -0,0 +1,177 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cstddef>
+#include <cstdint>
+
+#include <optional>
+#include <vector>
+
+// project headers --------------------------------------
+#include "angle.h"
+#include "vec2.h"
+#include "tdc2_solver.h"
+
+namespace tdc2 {
+
+/// Structure-of-arrays scenario inputs for `SolveTorpedoTriangleBatch`.
+///
+/// All arrays must have the same length; element `i` of each array describes scenario `i`.
+struct TorpedoTriangleBatchInput final {
+  std::vector<float> target_bearing;  // Signed relative target bearing in radians: Positive is starboard, negative is port.
+  std::vector<float> target_range_m;
+  std::vector<float> target_speed_kn;
+  std::vector<float> angle_on_bow;    // Signed, in radians: Positive is starboard, negative is port.
+  std::vector<float> ownship_course;  // In radians. North is 0, clockwise.
+  std::vector<float> aiming_device_x;
+  std::vector<float> aiming_device_y;
+
+  std::size_t Size() const { return target_bearing.size(); }
+  void Resize(std::size_t count);
+
+  /// Store the scenario described by `triangle` at `index`. `triangle.torpedo_speed_kn` is ignored; the batch uses a single torpedo speed.
+  void Set(
+    std::size_t index,
+    TorpedoTriangle const& triangle,
+    Angle ownship_course,
+    Vec2 const& aiming_device_position
+  );
+};
+
+/// Structure-of-arrays outputs of `SolveTorpedoTriangleBatch`.
+///
+/// Lanes for which `valid[i] == 0` have no solution; their other outputs are zero.
+struct TorpedoTriangleBatchOutput final {
+  std::vector<float> target_course;
+  std::vector<float> lead_angle;
+  std::vector<float> intercept_angle;
+  std::vector<float> torpedo_time_to_target_s;
+  std::vector<float> pseudo_torpedo_gyro_angle; // Signed: Positive is starboard, negative is port.
+  std::vector<float> impact_x;                  // Note no parallax correction applied.
+  std::vector<float> impact_y;
+  std::vector<uint8_t> valid;
+
+  std::size_t Size() const { return valid.size(); }
+  void Resize(std::size_t count);
+
+  /// Gather lane `index` back into the scalar solution type.
+  std::optional<TorpedoTriangleSolution> Get(std::size_t index) const;
+};
+
+/// Solve the torpedo triangle for every scenario in `input`, writing into `output`, which must already be sized to `input.Size()`.
+///
+/// Scenarios are processed in blocks of fixed-width lanes. Both the AoB == 0/180° branch and the general branch are evaluated
+/// for every lane and the result is selected by mask, as is the "target too fast" validity test, so the inner loops are free of
+/// data-dependent control flow, and vectorize.
+///
+/// ## Accuracy
+/// Every lane evaluates the exact operation sequence of `TorpedoTriangle::Solve`, with the trigonometry of
+/// `tdc2_lane_math.h` on both paths, so results are bit-identical (0 ULP) to the scalar path. `tdc2_core` is built with
+/// `-ffp-contract=off`, as FMA contraction would differ between the vectorized and the scalar code; `seerohr_bench`
+/// checks the agreement. Lanes flagged by `IsTorpedoTriangleIllConditioned` are solved again in double, as the scalar
+/// path does.
+void SolveTorpedoTriangleBatch(
+  float torpedo_speed_kn,
+  TorpedoTriangleBatchInput const& input,
+  TorpedoTriangleBatchOutput& output
+);
+
+/// Same as above, restricted to scenarios [`first`, `first + count`), so disjoint ranges can be solved concurrently.
+void SolveTorpedoTriangleBatch(
+  float torpedo_speed_kn,
+  TorpedoTriangleBatchInput const& input,
+  TorpedoTriangleBatchOutput& output,
+  std::size_t first,
+  std::size_t count
+);
+
+/// Structure-of-arrays outputs of `SolveParallaxCorrectionBatch`.
+///
+/// Lanes for which `valid[i] == 0` have no solution (no triangle solution, target too fast, or no convergence);
+/// their other outputs are zero except for `iterations`.
+struct ParallaxCorrectionBatchOutput final {
+  std::vector<float> delta;
+  std::vector<float> rho;
+  std::vector<float> gamma;
+  std::vector<float> beta;
+  std::vector<float> epf_offset_x;
+  std::vector<float> epf_offset_y;
+  std::vector<float> torpedo_run_distance_m;
+  std::vector<float> torpedo_time_to_target_s;
+  std::vector<float> impact_x;
+  std::vector<float> impact_y;
+  std::vector<uint8_t> valid;
+  std::vector<uint8_t> iterations; // Fixed-point iterations spent on the lane.
+
+  std::size_t Size() const { return valid.size(); }
+  void Resize(std::size_t count);
+
+  /// Gather lane `index` back into the scalar solution type.
+  std::optional<ParallaxCorrectionSolution> Get(std::size_t index) const;
+};
+
+/// Solve the parallax correction for every scenario in `input`, starting each lane from the pseudo gyro angle in `tri_output`.
+/// `output` must already be sized to `input.Size()`.
+///
+/// Scenarios are iterated together in 16 lanes. A lane is masked off as soon as it converges or fails, and takes the next
+/// scenario, so that one slow to converge holds up no other; scenarios without a triangle solution never start.
+/// If `epf_curve` is given, it is evaluated instead of the closed-form equivalent point of fire offset.
+/// If `start_gyro_angles` is given, lane `i` starts from `start_gyro_angles[i]` instead, e.g. from the previous solution
+/// of a scenario that changed little; indexed like `input`.
+///
+/// ## Accuracy
+/// Every lane evaluates the exact operation sequence of `ParallaxCorrectionSolver::SolveByGeometry`, so results are
+/// bit-identical (0 ULP) to the scalar path, iteration counts included; see `SolveTorpedoTriangleBatch`.
+void SolveParallaxCorrectionBatch(
+  TorpedoSpec const& torpedo_spec,
+  TorpedoTriangleBatchInput const& input,
+  TorpedoTriangleBatchOutput const& tri_output,
+  ParallaxCorrectionBatchOutput& output,
+  EquivalentPointOfFireCurve const* epf_curve = nullptr,
+  float const* start_gyro_angles = nullptr
+);
+
+/// Same as above, restricted to scenarios [`first`, `first + count`), so disjoint ranges can be solved concurrently.
+void SolveParallaxCorrectionBatch(
+  TorpedoSpec const& torpedo_spec,
+  TorpedoTriangleBatchInput const& input,
+  TorpedoTriangleBatchOutput const& tri_output,
+  ParallaxCorrectionBatchOutput& output,
+  std::size_t first,
+  std::size_t count,
+  EquivalentPointOfFireCurve const* epf_curve = nullptr,
+  float const* start_gyro_angles = nullptr
+);
+
+/// Per-scenario state for warm-starting the parallax correction of scenarios that change little from one solve to the
+/// next, as tracked targets do from tick to tick; see `SolveParallaxCorrectionBatchWarm`.
+struct ParallaxWarmStartBatch final {
+  std::vector<float> gyro_correction;      // Final less pseudo gyro angle of the last solution; NaN if none.
+  std::vector<float> gyro_correction_rate; // Change of the above over the last solve; NaN if unknown.
+  std::vector<float> start_gyro_angle;     // Scratch.
+
+  std::size_t Size() const { return gyro_correction.size(); }
+  /// New scenarios start cold.
+  void Resize(std::size_t count);
+  /// Forget scenarios [`first`, `first + count`), e.g. after they were rearranged.
+  void Reset(std::size_t first, std::size_t count);
+  /// Move the state of scenario `from` to `to`, e.g. when removing `to` by moving the last scenario into its place.
+  void Move(std::size_t from, std::size_t to);
+};
+
+/// `SolveParallaxCorrectionBatch`, starting every scenario from its last gyro angle correction, extrapolated by its last
+/// change, much as `TdcGraph` does with `TdcInputs::warm_start`. Scenarios changing steadily then take a single iteration;
+/// those whose inputs jumped too far for that are solved again cold. `warm` must already be sized to `input.Size()`, and
+/// is updated with the new solutions.
+void SolveParallaxCorrectionBatchWarm(
+  TorpedoSpec const& torpedo_spec,
+  TorpedoTriangleBatchInput const& input,
+  TorpedoTriangleBatchOutput const& tri_output,
+  ParallaxWarmStartBatch& warm,
+  ParallaxCorrectionBatchOutput& output,
+  std::size_t first,
+  std::size_t count,
+  EquivalentPointOfFireCurve const* epf_curve = nullptr
+);
+
+} // namespace tdc2
@@ -0,0 +1,129 @@
+// TU header --------------------------------------------
+#include "tdc2_convoy.h"
+
+// c++ headers ------------------------------------------
+#include <cmath>
+
+#include <algorithm>
+#include <numbers>
+#include <random>
+
+// project headers --------------------------------------
+#include "tdc2_sim.h"
+
+namespace tdc2 {
+
+namespace {
+
+/// Uniform in [`min`, `max`). Unlike `std::uniform_real_distribution`, gives the same sequence with every standard library.
+float GetUniform(std::mt19937& rng, float min, float max) {
+  return min + (max - min) * (static_cast<float>(rng() >> 8) * 0x1p-24f);
+}
+
+/// Distance covered at 1 m/s along the zig-zag plan of `spec` by `time_s`.
+Vec2 ComputeZigZagDisplacement(ConvoySpec const& spec, double time_s) {
+  if (spec.zigzag_leg_s <= 0.0f) {
+    return ComputeCourseDirection(spec.base_course) * static_cast<float>(time_s);
+  }
+
+  Vec2 const starboard_leg = ComputeCourseDirection(spec.base_course + spec.zigzag_angle);
+  Vec2 const port_leg = ComputeCourseDirection(spec.base_course - spec.zigzag_angle);
+  double const leg_s = spec.zigzag_leg_s;
+
+  // Whole pairs of legs, then a whole starboard leg if the current one is to port, then the current one so far.
+  double const leg_count = std::floor(time_s / leg_s);
+  double const pair_count = std::floor(leg_count * 0.5);
+  bool const on_port_leg = (leg_count - 2.0 * pair_count) != 0.0;
+  double const leg_time_s = time_s - leg_count * leg_s;
+
+  Vec2 displacement = (starboard_leg + port_leg) * static_cast<float>(pair_count * leg_s);
+  if (on_port_leg) {
+    displacement += starboard_leg * static_cast<float>(leg_s);
+  }
+  displacement += (on_port_leg ? port_leg : starboard_leg) * static_cast<float>(leg_time_s);
+  return displacement;
+}
+
+} // namespace
+
+ConvoySpec ConvoySpec::ForShipCount(std::size_t ship_count, uint32_t seed) {
+  ConvoySpec spec;
+  spec.seed = seed;
+  spec.escort_count = static_cast<uint32_t>(ship_count / 10);
+  spec.merchant_count = static_cast<uint32_t>(ship_count - spec.escort_count);
+
+  // Width: columns * column spacing. Depth: merchants / columns * ship spacing.
+  double const columns = std::sqrt(2.0 * spec.merchant_count * spec.ship_spacing_m / spec.column_spacing_m);
+  spec.column_count = std::clamp(static_cast<uint32_t>(std::lround(columns)), 1u, std::max(spec.merchant_count, 1u));
+  return spec;
+}
+
+std::vector<ConvoyShip> GenerateConvoy(ConvoySpec const& spec) {
+  std::mt19937 rng(spec.seed);
+  auto uniform = [&rng](float min, float max) { return GetUniform(rng, min, max); };
+
+  Vec2 const forward = ComputeCourseDirection(spec.base_course);
+  Vec2 const starboard = { spec.base_course.Cos(), spec.base_course.Sin() };
+  Angle const course = ComputeConvoyCourse(spec, 0.0);
+
+  uint32_t const column_count = std::max(spec.column_count, 1u);
+  uint32_t const row_count = (spec.merchant_count + column_count - 1) / column_count;
+  float const half_width_m = 0.5f * static_cast<float>(column_count - 1) * spec.column_spacing_m;
+  float const half_depth_m = 0.5f * static_cast<float>(std::max(row_count, 1u) - 1) * spec.ship_spacing_m;
+
+  std::vector<ConvoyShip> ships;
+  ships.reserve(spec.GetShipCount());
+
+  for (uint32_t i = 0; i < spec.merchant_count; ++i) {
+    uint32_t const column = i / row_count;
+    uint32_t const row = i % row_count;
+    float const across_m = static_cast<float>(column) * spec.column_spacing_m - half_width_m + uniform(-spec.station_error_m, spec.station_error_m);
+    float const along_m = half_depth_m - static_cast<float>(row) * spec.ship_spacing_m + uniform(-spec.station_error_m, spec.station_error_m);
+    float const length_m = uniform(110.0f, 160.0f);
+
+    ships.push_back(ConvoyShip {
+      .role = ConvoyRole::kMerchant,
+      .position = spec.center + starboard * across_m + forward * along_m,
+      .course = course,
+      .speed_kn = spec.speed_kn + uniform(-spec.speed_spread_kn, spec.speed_spread_kn),
+      .length_m = length_m,
+      .beam_m = length_m * 0.135f,
+    });
+  }
+
+  // Evenly around an ellipse clear of the columns, starting dead ahead, each a little off its bearing.
+  for (uint32_t i = 0; i < spec.escort_count; ++i) {
+    float const bearing_rad = 2.0f * std::numbers::pi_v<float> * (static_cast<float>(i) + uniform(-0.2f, 0.2f)) / static_cast<float>(spec.escort_count);
+    float const length_m = uniform(60.0f, 80.0f);
+
+    ships.push_back(ConvoyShip {
+      .role = ConvoyRole::kEscort,
+      .position = spec.center
+        + starboard * ((half_width_m + spec.screen_distance_m) * std::sin(bearing_rad))
+        + forward * ((half_depth_m + spec.screen_distance_m) * std::cos(bearing_rad)),
+      .course = course,
+      .speed_kn = spec.speed_kn,
+      .length_m = length_m,
+      .beam_m = length_m * 0.12f,
+    });
+  }
+
+  return ships;
+}
+
+Angle ComputeConvoyCourse(ConvoySpec const& spec, double time_s) {
+  if (spec.zigzag_leg_s <= 0.0f) {
+    return spec.base_course;
+  }
+  bool const on_port_leg = static_cast<int64_t>(std::floor(time_s / spec.zigzag_leg_s)) % 2 != 0;
+  return (on_port_leg ? spec.base_course - spec.zigzag_angle : spec.base_course + spec.zigzag_angle).WrapAround();
+}
+
+ConvoyShip AdvanceConvoyShip(ConvoySpec const& spec, ConvoyShip const& ship, double time_s) {
+  ConvoyShip advanced = ship;
+  advanced.position = ship.position + ComputeZigZagDisplacement(spec, time_s) * (ship.speed_kn * 1852.0f / 3600.0f);
+  advanced.course = ComputeConvoyCourse(spec, time_s);
+  return advanced;
+}
+
+} // namespace tdc2
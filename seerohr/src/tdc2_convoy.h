@@ -0,0 +1,69 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+// project headers --------------------------------------
+#include "angle.h"
+#include "vec2.h"
+
+namespace tdc2 {
+
+/// A convoy: Merchants in columns abreast, ringed by a screen of escorts, all zig-zagging together about a base course.
+///
+/// The same spec always generates the same convoy, with every standard library.
+struct ConvoySpec final {
+  uint32_t seed = 1;
+
+  uint32_t merchant_count = 45;
+  uint32_t column_count = 9;
+  uint32_t escort_count = 6;
+
+  float column_spacing_m = 900.0f;   // Between neighbouring columns.
+  float ship_spacing_m = 550.0f;     // Between consecutive ships of a column, bow to bow.
+  float station_error_m = 50.0f;     // Largest deviation of a ship from its station, along and across the base course.
+  float screen_distance_m = 2000.0f; // Of the escorts, beyond the outermost stations.
+
+  float speed_kn = 9.0f;
+  float speed_spread_kn = 0.5f;      // Largest deviation of a merchant's speed from `speed_kn`; escorts keep it exactly.
+
+  Vec2 center = { 0.0f, 0.0f };
+  Angle base_course = Angle::FromDeg(0.0f);  // North is 0, clockwise.
+  Angle zigzag_angle = Angle::FromDeg(20.0f); // Off the base course, on legs alternately to starboard and to port.
+  float zigzag_leg_s = 600.0f;               // Duration of a leg; 0 for no zig-zag.
+
+  std::size_t GetShipCount() const { return std::size_t(merchant_count) + escort_count; }
+
+  /// A convoy of exactly `ship_count` ships: A tenth of them escorts, the others in a formation about twice as wide as
+  /// it is deep.
+  static ConvoySpec ForShipCount(std::size_t ship_count, uint32_t seed);
+};
+
+enum class ConvoyRole : uint8_t {
+  kMerchant,
+  kEscort,
+};
+
+struct ConvoyShip final {
+  ConvoyRole role = ConvoyRole::kMerchant;
+  Vec2 position = { 0.0f, 0.0f };
+  Angle course = Angle::FromDeg(0.0f); // North is 0, clockwise.
+  float speed_kn = 0.0f;
+  float length_m = 0.0f;
+  float beam_m = 0.0f;
+};
+
+/// The ships of `spec` at time 0, on the first leg: Merchants column by column from port, front to back, then escorts.
+std::vector<ConvoyShip> GenerateConvoy(ConvoySpec const& spec);
+
+/// Course on the zig-zag plan of `spec` at `time_s`.
+Angle ComputeConvoyCourse(ConvoySpec const& spec, double time_s);
+
+/// `ship` of `spec`, as generated at time 0, advanced along the zig-zag plan to `time_s`. Closed form, so any time costs
+/// the same.
+ConvoyShip AdvanceConvoyShip(ConvoySpec const& spec, ConvoyShip const& ship, double time_s);
+
+} // namespace tdc2
@@ -0,0 +1,106 @@
+// TU header --------------------------------------------
+#include "tdc2_epf.h"
+
+// c++ headers ------------------------------------------
+#include <cmath>
+
+#include <algorithm>
+
+namespace tdc2 {
+
+namespace {
+
+constexpr EquivalentPointOfFireCurve kG7aCurve(GetTorpedoPresetSpec(TorpedoPreset::kG7a));
+constexpr EquivalentPointOfFireCurve kG7eCurve(GetTorpedoPresetSpec(TorpedoPreset::kG7e));
+
+} // namespace
+
+Vec2 EquivalentPointOfFireCurve::Evaluate(float rho) const {
+  constexpr float kInvIntervalWidth = static_cast<float>(1.0 / kIntervalWidth);
+  constexpr float kIntervalWidthF = static_cast<float>(kIntervalWidth);
+
+  float const t = std::min(std::abs(rho) * kInvIntervalWidth, static_cast<float>(kIntervalCount));
+  uint32_t const i = std::min(static_cast<uint32_t>(t), kIntervalCount - 1);
+  float const s = t - static_cast<float>(i);
+
+  float const h00 = (2.0f * s - 3.0f) * s * s + 1.0f;
+  float const h10 = ((s - 2.0f) * s + 1.0f) * s * kIntervalWidthF;
+  float const h01 = (3.0f - 2.0f * s) * s * s;
+  float const h11 = (s - 1.0f) * s * s * kIntervalWidthF;
+
+  float const x = h00 * x_[i] + h10 * dx_[i] + h01 * x_[i + 1] + h11 * dx_[i + 1];
+  float const y = h00 * y_[i] + h10 * dy_[i] + h01 * y_[i + 1] + h11 * dy_[i + 1];
+
+  float const sign = (rho >= 0.0f) ? 1.0f : -1.0f;
+
+  // Positive (starboard) rho gives negative y.
+  return { x, y * sign };
+}
+
+Vec2 EquivalentPointOfFireCurve::EvaluateDerivative(float rho) const {
+  constexpr float kInvIntervalWidth = static_cast<float>(1.0 / kIntervalWidth);
+
+  float const t = std::min(std::abs(rho) * kInvIntervalWidth, static_cast<float>(kIntervalCount));
+  uint32_t const i = std::min(static_cast<uint32_t>(t), kIntervalCount - 1);
+  float const s = t - static_cast<float>(i);
+
+  // Derivatives of the Hermite basis with respect to |rho|.
+  float const g00 = 6.0f * (s - 1.0f) * s * kInvIntervalWidth;
+  float const g10 = (3.0f * s - 4.0f) * s + 1.0f;
+  float const g01 = -g00;
+  float const g11 = (3.0f * s - 2.0f) * s;
+
+  float const dx = g00 * x_[i] + g10 * dx_[i] + g01 * x_[i + 1] + g11 * dx_[i + 1];
+  float const dy = g00 * y_[i] + g10 * dy_[i] + g01 * y_[i + 1] + g11 * dy_[i + 1];
+
+  // d|rho|/drho flips x's slope for port gyro angles; y's mirroring cancels it out.
+  return { (rho >= 0.0f) ? dx : -dx, dy };
+}
+
+EquivalentPointOfFireCurve const& EquivalentPointOfFireCurveCache::Get(TorpedoSpec const& torpedo_spec) {
+  if (EquivalentPointOfFireCurve const* curve = this->Find(torpedo_spec); curve != nullptr) {
+    return *curve;
+  }
+
+  preset_.reset();
+  owned_curve_.reset();
+
+  for (TorpedoPreset preset : { TorpedoPreset::kG7a, TorpedoPreset::kG7e }) {
+    if (GetPresetEquivalentPointOfFireCurve(preset).IsBuiltFor(torpedo_spec)) {
+      preset_ = preset;
+      return GetPresetEquivalentPointOfFireCurve(preset);
+    }
+  }
+
+  return owned_curve_.emplace(torpedo_spec);
+}
+
+EquivalentPointOfFireCurve const* EquivalentPointOfFireCurveCache::Find(TorpedoSpec const& torpedo_spec) const {
+  EquivalentPointOfFireCurve const* curve = this->GetCurrent();
+  if (curve != nullptr && curve->IsBuiltFor(torpedo_spec)) {
+    return curve;
+  }
+  return nullptr;
+}
+
+EquivalentPointOfFireCurve const* EquivalentPointOfFireCurveCache::GetCurrent() const {
+  if (preset_.has_value()) {
+    return &GetPresetEquivalentPointOfFireCurve(preset_.value());
+  }
+  if (owned_curve_.has_value()) {
+    return &owned_curve_.value();
+  }
+  return nullptr;
+}
+
+EquivalentPointOfFireCurve const& GetPresetEquivalentPointOfFireCurve(TorpedoPreset preset) {
+  switch (preset) {
+  case TorpedoPreset::kG7a:
+    return kG7aCurve;
+  case TorpedoPreset::kG7e:
+    return kG7eCurve;
+  }
+  return kG7eCurve;
+}
+
+} // namespace tdc2
@@ -0,0 +1,177 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cstdint>
+
+#include <array>
+#include <numbers>
+#include <optional>
+
+// project headers --------------------------------------
+#include "tdc2_solver.h"
+#include "vec2.h"
+
+namespace tdc2 {
+
+namespace detail {
+
+/// sin and cos of `a` in [0, pi], usable in constant expressions.
+struct ConstexprSinCos final {
+  double sin = 0.0;
+  double cos = 0.0;
+};
+
+constexpr ConstexprSinCos ComputeConstexprSinCos(double a) {
+  // sin(a) = cos(u), cos(a) = -sin(u) with u = a - pi/2 in [-pi/2, pi/2], where the Taylor series below is accurate to ~1e-17.
+  double const u = a - std::numbers::pi / 2.0;
+  double const u2 = u * u;
+
+  double sin_u = 0.0;
+  double cos_u = 0.0;
+  {
+    double term_sin = u;
+    double term_cos = 1.0;
+    for (int k = 0; k < 14; ++k) {
+      sin_u += term_sin;
+      cos_u += term_cos;
+      term_sin *= -u2 / static_cast<double>((2 * k + 2) * (2 * k + 3));
+      term_cos *= -u2 / static_cast<double>((2 * k + 1) * (2 * k + 2));
+    }
+  }
+
+  return ConstexprSinCos { .sin = cos_u, .cos = -sin_u };
+}
+
+} // namespace detail
+
+/// Precomputed equivalent point of fire curve of one torpedo geometry.
+///
+/// Replaces `TorpedoSpec::ComputeEquivalentPointOfFireOffset` and its derivative with a table lookup and a cubic Hermite
+/// interpolation over |ρ| in [0, π], using the exact values and derivatives at `kIntervalCount + 1` nodes.
+/// The interpolation error is bounded by h⁴/384 · max|f⁗| and is measured against the closed form when the curve is built;
+/// see `GetMaxError`. For the default geometry it is ~4e-7 m, far below the float rounding (~1e-4 m) of the closed form.
+///
+/// Curves are literal types so that presets can be built at compile time; see `GetPresetEquivalentPointOfFireCurve`.
+class EquivalentPointOfFireCurve final {
+public:
+  static constexpr uint32_t kIntervalCount = 128;
+
+  constexpr explicit EquivalentPointOfFireCurve(TorpedoSpec const& torpedo_spec);
+
+  /// Same as `TorpedoSpec::ComputeEquivalentPointOfFireOffset`, for `rho` in [-π, π].
+  Vec2 Evaluate(float rho) const;
+  /// Same as `TorpedoSpec::ComputeEquivalentPointOfFireOffsetDerivative`, for `rho` in [-π, π].
+  Vec2 EvaluateDerivative(float rho) const;
+
+  /// Whether this curve describes the geometry of `torpedo_spec`. The torpedo speed does not affect the curve.
+  constexpr bool IsBuiltFor(TorpedoSpec const& torpedo_spec) const {
+    return distance_to_tube_ == torpedo_spec.distance_to_tube &&
+           reach_ == torpedo_spec.reach &&
+           turn_radius_ == torpedo_spec.turn_radius;
+  }
+
+  /// Largest interpolation error in meters, measured against the closed form at the interval midpoints and quarter points.
+  constexpr float GetMaxError() const { return max_error_m_; }
+
+private:
+  struct Node final {
+    double x = 0.0;
+    double y = 0.0;
+    double dx = 0.0; // d/d|ρ|
+    double dy = 0.0; // d/d|ρ|
+  };
+
+  static constexpr double kIntervalWidth = std::numbers::pi / static_cast<double>(kIntervalCount);
+
+  static constexpr Node ComputeNode(TorpedoSpec const& torpedo_spec, double abs_rho);
+
+  float distance_to_tube_ = 0.0f;
+  float reach_ = 0.0f;
+  float turn_radius_ = 0.0f;
+
+  // Unsigned curve, i.e. for ρ >= 0; `Evaluate` mirrors it for port gyro angles.
+  std::array<float, kIntervalCount + 1> x_ {};
+  std::array<float, kIntervalCount + 1> y_ {};
+  std::array<float, kIntervalCount + 1> dx_ {};
+  std::array<float, kIntervalCount + 1> dy_ {};
+
+  float max_error_m_ = 0.0f;
+};
+
+constexpr EquivalentPointOfFireCurve::Node EquivalentPointOfFireCurve::ComputeNode(TorpedoSpec const& torpedo_spec, double abs_rho) {
+  detail::ConstexprSinCos const sc = detail::ComputeConstexprSinCos(abs_rho);
+
+  double const distance_to_tube = torpedo_spec.distance_to_tube;
+  double const reach = torpedo_spec.reach;
+  double const turn_radius = torpedo_spec.turn_radius;
+  double const arm = turn_radius * abs_rho + reach;
+
+  return Node {
+    .x = distance_to_tube + reach + turn_radius * sc.sin - arm * sc.cos,
+    .y = turn_radius * (1.0 - sc.cos) - arm * sc.sin,
+    .dx = arm * sc.sin,
+    .dy = -arm * sc.cos,
+  };
+}
+
+constexpr EquivalentPointOfFireCurve::EquivalentPointOfFireCurve(TorpedoSpec const& torpedo_spec)
+  : distance_to_tube_(torpedo_spec.distance_to_tube),
+    reach_(torpedo_spec.reach),
+    turn_radius_(torpedo_spec.turn_radius)
+{
+  std::array<Node, kIntervalCount + 1> nodes {};
+  for (uint32_t i = 0; i <= kIntervalCount; ++i) {
+    nodes[i] = ComputeNode(torpedo_spec, kIntervalWidth * static_cast<double>(i));
+
+    x_[i] = static_cast<float>(nodes[i].x);
+    y_[i] = static_cast<float>(nodes[i].y);
+    dx_[i] = static_cast<float>(nodes[i].dx);
+    dy_[i] = static_cast<float>(nodes[i].dy);
+  }
+
+  // Measure the interpolation error in double precision.
+  double max_error = 0.0;
+  for (uint32_t i = 0; i < kIntervalCount; ++i) {
+    for (double s : { 0.25, 0.5, 0.75 }) {
+      Node const exact = ComputeNode(torpedo_spec, kIntervalWidth * (static_cast<double>(i) + s));
+
+      double const h00 = (2.0 * s - 3.0) * s * s + 1.0;
+      double const h10 = ((s - 2.0) * s + 1.0) * s;
+      double const h01 = (3.0 - 2.0 * s) * s * s;
+      double const h11 = (s - 1.0) * s * s;
+
+      double const x = h00 * nodes[i].x + h10 * kIntervalWidth * nodes[i].dx + h01 * nodes[i + 1].x + h11 * kIntervalWidth * nodes[i + 1].dx;
+      double const y = h00 * nodes[i].y + h10 * kIntervalWidth * nodes[i].dy + h01 * nodes[i + 1].y + h11 * kIntervalWidth * nodes[i + 1].dy;
+
+      double const ex = (x < exact.x) ? (exact.x - x) : (x - exact.x);
+      double const ey = (y < exact.y) ? (exact.y - y) : (y - exact.y);
+      max_error = (max_error < ex) ? ex : max_error;
+      max_error = (max_error < ey) ? ey : max_error;
+    }
+  }
+  max_error_m_ = static_cast<float>(max_error);
+}
+
+/// Holds the equivalent point of fire curve for a `TorpedoSpec` whose geometry may change.
+///
+/// `Get` compares the geometry with the one the current curve was built for and rebuilds it on change, so callers never
+/// observe a stale curve. Geometries matching a preset reuse the prebuilt preset curve instead of building a new one.
+class EquivalentPointOfFireCurveCache final {
+public:
+  EquivalentPointOfFireCurve const& Get(TorpedoSpec const& torpedo_spec);
+
+  /// The cached curve if it was built for `torpedo_spec`, otherwise null.
+  EquivalentPointOfFireCurve const* Find(TorpedoSpec const& torpedo_spec) const;
+
+private:
+  EquivalentPointOfFireCurve const* GetCurrent() const;
+
+  // Either the preset whose prebuilt curve is current, or a curve built at runtime. Never both.
+  std::optional<TorpedoPreset> preset_;
+  std::optional<EquivalentPointOfFireCurve> owned_curve_;
+};
+
+/// Curve for the geometry of `preset`, built at compile time.
+EquivalentPointOfFireCurve const& GetPresetEquivalentPointOfFireCurve(TorpedoPreset preset);
+
+} // namespace tdc2
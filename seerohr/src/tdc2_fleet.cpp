@@ -0,0 +1,110 @@
+// TU header --------------------------------------------
+#include "tdc2_fleet.h"
+
+// c++ headers ------------------------------------------
+#include <cassert>
+
+#include <algorithm>
+
+// project headers --------------------------------------
+#include "tdc2_sim.h"
+#include "tdc2_targets.h"
+
+namespace tdc2 {
+
+Vec2 FleetOwnship::GetAimingDevicePosition() const {
+  return position + ComputeCourseDirection(course) * distance_to_aiming_device;
+}
+
+void EngagementMatrix::Solve(
+  std::span<FleetOwnship const> ownships,
+  std::span<FleetContact const> targets,
+  JobSystem* job_system
+) {
+  std::size_t const count = ownships.size() * targets.size();
+
+  if (ownships.size() != ownship_count_ || targets.size() != target_count_) {
+    ownship_count_ = ownships.size();
+    target_count_ = targets.size();
+
+    input_.Resize(count);
+    tri_output_.Resize(count);
+    pc_output_.Resize(count);
+    warm_start_.Resize(count);
+    warm_start_.Reset(0, count);
+    torpedo_specs_.resize(ownship_count_);
+    epf_curve_caches_.resize(ownship_count_);
+    epf_curves_.resize(ownship_count_);
+  }
+
+  // Curves are built here, as the caches are not safe to share between the tiles.
+  for (std::size_t o = 0; o < ownship_count_; ++o) {
+    TorpedoSpec const& torpedo_spec = ownships[o].torpedo_spec;
+    if (!(torpedo_spec == torpedo_specs_[o])) {
+      torpedo_specs_[o] = torpedo_spec;
+      warm_start_.Reset(this->GetIndex(o, 0), target_count_);
+    }
+    epf_curves_[o] = &epf_curve_caches_[o].Get(torpedo_spec);
+  }
+
+  std::size_t const tiles_per_row = (target_count_ + kTileTargetCount - 1) / kTileTargetCount;
+
+  auto solve_tile = [&](std::size_t tile) {
+    std::size_t const o = tile / tiles_per_row;
+    std::size_t const first_target = (tile % tiles_per_row) * kTileTargetCount;
+    std::size_t const tile_target_count = std::min(kTileTargetCount, target_count_ - first_target);
+    std::size_t const first = this->GetIndex(o, first_target);
+
+    FleetOwnship const& ownship = ownships[o];
+    Vec2 const aiming_device_position = ownship.GetAimingDevicePosition();
+    float const ownship_course_rad = ownship.course.AsRad();
+
+    for (std::size_t t = 0; t < tile_target_count; ++t) {
+      FleetContact const& target = targets[first_target + t];
+      std::size_t const i = first + t;
+
+      TargetData const observed = ComputeTargetData(aiming_device_position, ownship.course, target.position, target.course, target.speed_kn);
+      input_.target_bearing[i] = observed.target_bearing.AsRad();
+      input_.target_range_m[i] = observed.target_range_m;
+      input_.target_speed_kn[i] = observed.target_speed_kn;
+      input_.angle_on_bow[i] = observed.angle_on_bow.AsRad();
+      input_.ownship_course[i] = ownship_course_rad;
+      input_.aiming_device_x[i] = aiming_device_position.x;
+      input_.aiming_device_y[i] = aiming_device_position.y;
+    }
+
+    SolveTorpedoTriangleBatch(ownship.torpedo_spec.speed_kn, input_, tri_output_, first, tile_target_count);
+    SolveParallaxCorrectionBatchWarm(
+      ownship.torpedo_spec, input_, tri_output_, warm_start_, pc_output_, first, tile_target_count, epf_curves_[o]
+    );
+  };
+
+  std::size_t const tile_count = ownship_count_ * tiles_per_row;
+  if (job_system == nullptr) {
+    for (std::size_t tile = 0; tile < tile_count; ++tile) {
+      solve_tile(tile);
+    }
+    return;
+  }
+  job_system->ParallelFor(
+    tile_count,
+    [&](uint64_t first, uint64_t count) {
+      for (uint64_t tile = first; tile < first + count; ++tile) {
+        solve_tile(static_cast<std::size_t>(tile));
+      }
+    },
+    ParallelForOptions { .chunk_size = 1, .progress = {} }
+  );
+}
+
+std::optional<TorpedoTriangleSolution> EngagementMatrix::GetTriangleSolution(std::size_t ownship, std::size_t target) const {
+  assert(ownship < ownship_count_ && target < target_count_);
+  return tri_output_.Get(this->GetIndex(ownship, target));
+}
+
+std::optional<ParallaxCorrectionSolution> EngagementMatrix::GetParallaxSolution(std::size_t ownship, std::size_t target) const {
+  assert(ownship < ownship_count_ && target < target_count_);
+  return pc_output_.Get(this->GetIndex(ownship, target));
+}
+
+} // namespace tdc2
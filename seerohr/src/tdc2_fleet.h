@@ -0,0 +1,83 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cstddef>
+
+#include <optional>
+#include <span>
+#include <vector>
+
+// project headers --------------------------------------
+#include "angle.h"
+#include "vec2.h"
+#include "job_system.h"
+#include "tdc2_batch.h"
+#include "tdc2_epf.h"
+#include "tdc2_solver.h"
+
+namespace tdc2 {
+
+/// One of several ownships attacking together, each with its own torpedoes.
+struct FleetOwnship final {
+  Vec2 position = { 0.0f, 0.0f };
+  Angle course = Angle::FromDeg(0.0f); // North is 0, clockwise.
+  float distance_to_aiming_device = 0.0f;
+  TorpedoSpec torpedo_spec;
+
+  Vec2 GetAimingDevicePosition() const;
+};
+
+/// A target, in the world frame.
+struct FleetContact final {
+  Vec2 position = { 0.0f, 0.0f };
+  Angle course = Angle::FromDeg(0.0f); // North is 0, clockwise.
+  float speed_kn = 0.0f;
+};
+
+/// The torpedo triangle and parallax correction of every ownship of a fleet against every contact.
+///
+/// Solutions are stored densely in SoA layout, ownship-major: Engagement (`ownship`, `target`) is at
+/// `ownship * GetTargetCount() + target` of every array. Rows are solved in tiles of up to `kTileTargetCount` targets,
+/// which run concurrently; from one solve to the next, each engagement starts from its last solution.
+class EngagementMatrix final {
+public:
+  /// Targets per tile: Several blocks of the batch solvers, few enough for the tiles of a row to spread over the workers.
+  static constexpr std::size_t kTileTargetCount = 128;
+
+  /// Observe every target from every ownship, and solve. Runs on `job_system` if given, otherwise inline.
+  ///
+  /// Engagements keep their warm start as long as the number of ownships and targets and the ownship's `TorpedoSpec`
+  /// do not change.
+  void Solve(
+    std::span<FleetOwnship const> ownships,
+    std::span<FleetContact const> targets,
+    JobSystem* job_system = nullptr
+  );
+
+  std::size_t GetOwnshipCount() const { return ownship_count_; }
+  std::size_t GetTargetCount() const { return target_count_; }
+  std::size_t GetIndex(std::size_t ownship, std::size_t target) const { return ownship * target_count_ + target; }
+
+  std::optional<TorpedoTriangleSolution> GetTriangleSolution(std::size_t ownship, std::size_t target) const;
+  std::optional<ParallaxCorrectionSolution> GetParallaxSolution(std::size_t ownship, std::size_t target) const;
+
+  TorpedoTriangleBatchInput const& GetInputs() const { return input_; }
+  TorpedoTriangleBatchOutput const& GetTriangleOutputs() const { return tri_output_; }
+  ParallaxCorrectionBatchOutput const& GetParallaxOutputs() const { return pc_output_; }
+
+private:
+  std::size_t ownship_count_ = 0;
+  std::size_t target_count_ = 0;
+
+  TorpedoTriangleBatchInput input_;
+  TorpedoTriangleBatchOutput tri_output_;
+  ParallaxCorrectionBatchOutput pc_output_;
+  ParallaxWarmStartBatch warm_start_;
+
+  // Per ownship: What the warm start of its row was solved for, and its equivalent point of fire curve.
+  std::vector<TorpedoSpec> torpedo_specs_;
+  std::vector<EquivalentPointOfFireCurveCache> epf_curve_caches_;
+  std::vector<EquivalentPointOfFireCurve const*> epf_curves_;
+};
+
+} // namespace tdc2
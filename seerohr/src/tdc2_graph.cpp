@@ -0,0 +1,138 @@
+// TU header --------------------------------------------
+#include "tdc2_graph.h"
+
+// c++ headers ------------------------------------------
+#include <cmath>
+
+#include <numbers>
+
+// project headers --------------------------------------
+#include "tdc2_table.h"
+
+namespace tdc2 {
+
+bool TdcGraph::Update(TdcInputs const& inputs) {
+  ++stats_.update_count;
+  uint64_t const now = ++clock_;
+
+  SetInput(target_, TargetInput { inputs.target_bearing, inputs.target_range_m, inputs.target_speed_kn, inputs.angle_on_bow }, now);
+  SetInput(torpedo_spec_, inputs.torpedo_spec, now);
+  SetInput(ownship_course_, inputs.ownship_course, now);
+  SetInput(aiming_device_position_, inputs.aiming_device_position, now);
+  SetInput(solver_, SolverInput { inputs.pc_method, inputs.firing_table, inputs.warm_start }, now);
+
+  if (IsStale(triangle_, target_, torpedo_spec_)) {
+    ++stats_.triangle_count;
+
+    // Expect full circle [0, 2pi) degrees for target bearing.
+    // Convert to signed angle [-pi, +pi) degrees.
+    Angle target_bearing = target_.value.bearing;
+    if (std::numbers::pi_v<float> <= target_bearing.AsRad()) {
+      target_bearing = target_bearing - Angle(std::numbers::pi_v<float> * 2.0f);
+    }
+
+    triangle_.value = TorpedoTriangle {
+      .torpedo_speed_kn = torpedo_spec_.value.speed_kn,
+      .target_bearing = target_bearing,
+      .target_range_m = target_.value.range_m,
+      .target_speed_kn = target_.value.speed_kn,
+      .angle_on_bow = target_.value.angle_on_bow,
+    };
+    triangle_.version = now;
+  }
+
+  if (IsStale(interm_, triangle_, ownship_course_)) {
+    ++stats_.intermediate_count;
+    interm_.value = triangle_.value.PrepareSolve(ownship_course_.value);
+    interm_.version = now;
+  }
+
+  if (IsStale(tri_solution_, triangle_, interm_, aiming_device_position_)) {
+    ++stats_.triangle_solution_count;
+    tri_solution_.value = triangle_.value.Solve(interm_.value, aiming_device_position_.value);
+    tri_solution_.version = now;
+  }
+
+  if (IsStale(pc_solution_, tri_solution_, torpedo_spec_, ownship_course_, aiming_device_position_, solver_)) {
+    ++stats_.parallax_solution_count;
+    pc_solution_.value = ComputeParallaxOutput();
+    pc_solution_.version = now;
+
+    if (pc_solution_.value.solution.has_value()) {
+      float const correction = pc_solution_.value.solution->rho - tri_solution_.value->pseudo_torpedo_gyro_angle.AsRad();
+      warm_gyro_correction_ = std::remainder(correction, 2.0f * std::numbers::pi_v<float>);
+    }
+    else {
+      warm_gyro_correction_ = std::nullopt;
+    }
+  }
+
+  return tri_solution_.version == now || pc_solution_.version == now;
+}
+
+TdcGraph::ParallaxOutput TdcGraph::ComputeParallaxOutput() {
+  if (!tri_solution_.value.has_value()) {
+    return ParallaxOutput {};
+  }
+
+  TorpedoSpec const& torpedo_spec = torpedo_spec_.value;
+  TorpedoTriangle const& triangle = triangle_.value;
+  FiringTable const* firing_table = solver_.value.firing_table;
+  float const ownship_course_rad = ownship_course_.value.AsRad();
+
+  EquivalentPointOfFireCurve const& epf_curve = epf_curve_cache_.Get(torpedo_spec);
+
+  if (firing_table != nullptr && firing_table->IsGeneratedFor(torpedo_spec)) {
+    if (std::optional<FiringTableSolution> const table_solution = firing_table->Lookup(triangle, &epf_curve); table_solution.has_value()) {
+      ParallaxCorrectionSolution pc_solution;
+      bool const result = ParallaxCorrectionSolver::ComputeSolutionAt(
+        torpedo_spec,
+        triangle,
+        table_solution->gyro_angle,
+        aiming_device_position_.value,
+        ownship_course_rad,
+        pc_solution,
+        &epf_curve
+      );
+      if (result) {
+        return ParallaxOutput { .solution = pc_solution, .from_firing_table = true };
+      }
+    }
+  }
+
+  float const pseudo_gyro_angle = tri_solution_.value->pseudo_torpedo_gyro_angle.AsRad();
+  auto solve = [&](float rho0, ParallaxCorrectionSolution& out_pc_solution) {
+    return ParallaxCorrectionSolver::Solve(
+      solver_.value.pc_method,
+      torpedo_spec,
+      triangle,
+      rho0,
+      aiming_device_position_.value,
+      ownship_course_rad,
+      out_pc_solution,
+      &epf_curve
+    );
+  };
+
+  ParallaxCorrectionSolution pc_solution;
+
+  if (solver_.value.warm_start && warm_gyro_correction_.has_value()) {
+    float const rho0 = std::remainder(pseudo_gyro_angle + warm_gyro_correction_.value(), 2.0f * std::numbers::pi_v<float>);
+    if (solve(rho0, pc_solution)) {
+      ++stats_.warm_solve_count;
+      stats_.warm_solve_iterations += pc_solution.iterations;
+      return ParallaxOutput { .solution = pc_solution };
+    }
+    // Diverged, e.g. after a jump of the inputs; the cold start below decides whether there is a solution at all.
+    ++stats_.warm_fallback_count;
+  }
+
+  if (!solve(pseudo_gyro_angle, pc_solution)) {
+    return ParallaxOutput {};
+  }
+  ++stats_.cold_solve_count;
+  stats_.cold_solve_iterations += pc_solution.iterations;
+  return ParallaxOutput { .solution = pc_solution };
+}
+
+} // namespace tdc2
@@ -0,0 +1,167 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cstdint>
+
+#include <optional>
+
+// project headers --------------------------------------
+#include "angle.h"
+#include "vec2.h"
+#include "tdc2_epf.h"
+#include "tdc2_solver.h"
+
+namespace tdc2 {
+
+class FiringTable;
+
+/// Everything the solve of a torpedo data computer depends on.
+struct TdcInputs final {
+  TorpedoSpec torpedo_spec;
+
+  Angle target_bearing = Angle::FromDeg(0.0f); // Relative; either [0, 2pi) or signed.
+  float target_range_m = 0.0f;
+  float target_speed_kn = 0.0f;
+  Angle angle_on_bow = Angle::FromDeg(0.0f);   // Signed: Positive is starboard, negative is port.
+
+  Angle ownship_course = Angle::FromDeg(0.0f);
+  Vec2 aiming_device_position = { 0.0f, 0.0f };
+
+  ParallaxSolveMethod pc_method = ParallaxSolveMethod::kGeometry;
+  /// Used for solves whose `TorpedoSpec` it was generated for, falling back to the solver outside of it. Null to always solve.
+  FiringTable const* firing_table = nullptr;
+  /// Start the parallax solver from the previous solution rather than from the pseudo gyro angle.
+  bool warm_start = true;
+};
+
+/// How often the nodes of a `TdcGraph` were recomputed.
+struct TdcGraphStats final {
+  uint64_t update_count = 0;
+  uint64_t triangle_count = 0;
+  uint64_t intermediate_count = 0;
+  uint64_t triangle_solution_count = 0;
+  uint64_t parallax_solution_count = 0;
+
+  // Parallax solutions found by the solver, as opposed to the firing table.
+  uint64_t cold_solve_count = 0;      // Started from the pseudo gyro angle.
+  uint64_t warm_solve_count = 0;      // Started from the previous solution.
+  uint64_t warm_fallback_count = 0;   // Warm starts that failed and were repeated from a cold start, which counts as cold.
+  uint64_t cold_solve_iterations = 0;
+  uint64_t warm_solve_iterations = 0;
+
+  double GetMeanColdSolveIterations() const {
+    return (cold_solve_count == 0) ? 0.0 : static_cast<double>(cold_solve_iterations) / static_cast<double>(cold_solve_count);
+  }
+  double GetMeanWarmSolveIterations() const {
+    return (warm_solve_count == 0) ? 0.0 : static_cast<double>(warm_solve_iterations) / static_cast<double>(warm_solve_count);
+  }
+};
+
+/// The solve of a torpedo data computer as a dataflow graph:
+///
+///  target ──────────┬─► triangle ─► intermediate ─► triangle solution ─► parallax solution
+///  torpedo spec ────┘                    ▲                 ▲                   ▲
+///  ownship course ───────────────────────┘                 │                   │
+///  aiming device position ─────────────────────────────────┘                   │
+///  solver (method, firing table) ──────────────────────────────────────────────┘
+///
+/// Every node carries the version at which its value last changed. `Update` assigns new versions to the inputs that
+/// differ from the previous call, and recomputes only the nodes with a dependency newer than themselves; with unchanged
+/// inputs it does no work at all. Not drawn above: The parallax solution also depends on the torpedo spec, the ownship
+/// course and the aiming device position directly.
+///
+/// With `TdcInputs::warm_start`, the parallax solver starts from the gyro angle correction of the previous solution
+/// applied to the current pseudo gyro angle. Inputs mostly change by small steps between updates, like dial drags and
+/// moving targets, so that is much closer to the solution than the pseudo gyro angle itself.
+class TdcGraph final {
+public:
+  /// Bring every node up to date with `inputs`. Returns whether the triangle or parallax solution was recomputed.
+  bool Update(TdcInputs const& inputs);
+
+  /// Only valid after the first `Update`.
+  TorpedoTriangle const& GetTriangle() const { return triangle_.value; }
+  TorpedoTriangleIntermediate const& GetIntermediate() const { return interm_.value; }
+
+  std::optional<TorpedoTriangleSolution> const& GetTriangleSolution() const { return tri_solution_.value; }
+  std::optional<ParallaxCorrectionSolution> const& GetParallaxSolution() const { return pc_solution_.value.solution; }
+  /// Whether the parallax solution was looked up in the firing table rather than solved for.
+  bool IsParallaxSolutionFromFiringTable() const { return pc_solution_.value.from_firing_table; }
+
+  /// The equivalent point of fire curve the solves used if it was built for `torpedo_spec`, otherwise null.
+  EquivalentPointOfFireCurve const* FindEquivalentPointOfFireCurve(TorpedoSpec const& torpedo_spec) const {
+    return epf_curve_cache_.Find(torpedo_spec);
+  }
+
+  TdcGraphStats const& GetStats() const { return stats_; }
+
+private:
+  template <typename T>
+  struct Node final {
+    T value {};
+    uint64_t version = 0; // 0: Never computed.
+  };
+
+  struct TargetInput final {
+    Angle bearing;
+    float range_m = 0.0f;
+    float speed_kn = 0.0f;
+    Angle angle_on_bow;
+
+    bool operator==(TargetInput const&) const = default;
+  };
+
+  struct SolverInput final {
+    ParallaxSolveMethod pc_method = ParallaxSolveMethod::kGeometry;
+    FiringTable const* firing_table = nullptr;
+    bool warm_start = true;
+
+    bool operator==(SolverInput const&) const = default;
+  };
+
+  struct ParallaxOutput final {
+    std::optional<ParallaxCorrectionSolution> solution;
+    bool from_firing_table = false;
+  };
+
+  /// Store `value` in the input node `node`, giving it the version `now` if it differs from the stored one.
+  template <typename T>
+  static void SetInput(Node<T>& node, T const& value, uint64_t now) {
+    if (node.version == 0 || !(node.value == value)) {
+      node.value = value;
+      node.version = now;
+    }
+  }
+
+  /// Whether `node` is older than any of `dependencies`.
+  template <typename T, typename... Ts>
+  static bool IsStale(Node<T> const& node, Node<Ts> const&... dependencies) {
+    return ((node.version < dependencies.version) || ...);
+  }
+
+  ParallaxOutput ComputeParallaxOutput();
+
+  uint64_t clock_ = 0; // Version of the latest `Update`.
+
+  // Inputs.
+  Node<TargetInput> target_;
+  Node<TorpedoSpec> torpedo_spec_;
+  Node<Angle> ownship_course_;
+  Node<Vec2> aiming_device_position_;
+  Node<SolverInput> solver_;
+
+  // Derived.
+  Node<TorpedoTriangle> triangle_;
+  Node<TorpedoTriangleIntermediate> interm_;
+  Node<std::optional<TorpedoTriangleSolution>> tri_solution_;
+  Node<ParallaxOutput> pc_solution_;
+
+  // Equivalent point of fire curve of `torpedo_spec_`; rebuilt whenever its geometry changes.
+  EquivalentPointOfFireCurveCache epf_curve_cache_;
+
+  // Gyro angle correction, final minus pseudo gyro angle, of the last parallax solution. Null after a failed solve.
+  std::optional<float> warm_gyro_correction_;
+
+  TdcGraphStats stats_;
+};
+
+} // namespace tdc2
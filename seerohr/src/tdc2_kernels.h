@@ -0,0 +1,123 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cmath>
+
+#include <numbers>
+
+// project headers --------------------------------------
+#include "tdc2_lane_math.h"
+#include "vec2.h"
+
+namespace tdc2 {
+
+// Scalar- and spec-generic kernels shared by the scalar and batch solvers. Their trigonometry is that of
+// `tdc2_lane_math.h`, so the batch solvers can vectorize them and still agree with the scalar ones bit for bit.
+//
+// The solvers run in float. Near AoB 0/180° or a lead angle of 90°, some outputs are ratios of two small sines, and
+// rounding of the inputs and of π dominates them in float: The torpedo run distance can be off by more than its own
+// value. Such scenarios are flagged by `Is...IllConditioned` and only those are evaluated again in double.
+
+/// `TorpedoSpec::ComputeEquivalentPointOfFireOffset` for `Spec`, either `TorpedoSpec` or a `PresetTorpedoSpec` whose
+/// constants fold.
+template <typename Spec>
+Vec2 ComputeEquivalentPointOfFireOffset(Spec const& torpedo_spec, float rho) {
+  float const abs_rho = std::abs(rho);
+  float const sin_abs_rho = lane::Sin(abs_rho);
+  float const cos_abs_rho = lane::Cos(abs_rho);
+
+  float x = torpedo_spec.distance_to_tube + torpedo_spec.reach + torpedo_spec.turn_radius * sin_abs_rho - (torpedo_spec.turn_radius * abs_rho + torpedo_spec.reach) * cos_abs_rho;
+  float y = torpedo_spec.turn_radius * (1.0f - cos_abs_rho) - (torpedo_spec.turn_radius * abs_rho + torpedo_spec.reach) * sin_abs_rho;
+
+  float sign = (rho >= 0.0f) ? 1.0f : -1.0f;
+
+  // `y` is towards the turn, and negative: The equivalent point of fire lies on the side opposite the turn, i.e. positive
+  // (starboard) rho gives negative y.
+  return { x, y * sign };
+}
+
+/// Below this magnitude, a sine of the triangle counts as ill-conditioned in float.
+inline constexpr float kIllConditionedSine = 1.0f / 32.0f;
+
+/// General branch of the torpedo triangle (AoB neither 0 nor 180°), in `T`.
+template <typename T>
+struct TorpedoTriangleCore final {
+  bool valid = false;          // False if the target is too fast; the other members are then meaningless.
+  T sin_abs_angle_on_bow = T(0);
+  T sin_lead_angle = T(0);
+  T lead_angle = T(0);
+  T intercept_angle = T(0);
+  T sin_intercept_angle = T(0);
+  T torpedo_run_distance_m = T(0);
+};
+
+/// Solve the general branch of the torpedo triangle by the law of sines. The operation order is that of
+/// `TorpedoTriangle::Solve`; keep it, as the batch solver relies on it for bit-exact results.
+template <typename T>
+TorpedoTriangleCore<T> SolveTorpedoTriangleCore(
+  T torpedo_speed_kn,
+  T target_speed_kn,
+  T target_range_m,
+  T abs_angle_on_bow
+) {
+  TorpedoTriangleCore<T> core;
+
+  core.sin_abs_angle_on_bow = lane::Sin(abs_angle_on_bow);
+  core.sin_lead_angle = target_speed_kn / torpedo_speed_kn * core.sin_abs_angle_on_bow;
+  if (T(1) < core.sin_lead_angle) {
+    return core;
+  }
+
+  core.lead_angle = lane::Asin(core.sin_lead_angle);
+  core.intercept_angle = (std::numbers::pi_v<T> - abs_angle_on_bow) - core.lead_angle;
+  core.sin_intercept_angle = lane::Sin(core.intercept_angle);
+  if (core.intercept_angle <= T(0)) {
+    return core;
+  }
+
+  core.torpedo_run_distance_m = target_range_m / core.sin_intercept_angle * core.sin_abs_angle_on_bow;
+  core.valid = true;
+  return core;
+}
+
+/// Whether the float triangle with these terms should be solved again in double: AoB or the intercept angle near 0 or
+/// 180°, or a lead angle near 90°, which also makes the "target too fast" verdict unreliable.
+inline bool IsTorpedoTriangleIllConditioned(float sin_abs_angle_on_bow, float sin_lead_angle, float sin_intercept_angle) {
+  // Not short-circuiting, for the lane loops of the batch solver.
+  return (sin_abs_angle_on_bow < kIllConditionedSine) |
+         (1.0f - kIllConditionedSine * kIllConditionedSine * 0.5f < sin_lead_angle) |
+         (std::abs(sin_intercept_angle) < kIllConditionedSine);
+}
+
+/// Torpedo run distance from the equivalent point of fire, by the law of sines in the triangle seen from there.
+///
+/// * `los2`: Target range from the equivalent point of fire.
+/// * `gamma2`, `beta2`: Signed angle on bow and lead angle, as seen from the equivalent point of fire.
+/// * `speed_ratio`: Target speed over torpedo speed, for the collinear case.
+template <typename T>
+T ComputeParallaxRunDistance(T los2, T gamma2, T beta2, T speed_ratio) {
+  // Sine of the intercept angle, pi - gamma2 - beta2, taken without subtracting from pi: Near AoB 0 its rounding would
+  // swamp both sines.
+  T const sin_alpha2 = std::sin(gamma2 + beta2);
+  if (sin_alpha2 == T(0)) {
+    // AoB exactly 0 or 180°: The target runs down the line of sight, as in the AoB 0/180° branch of
+    // `TorpedoTriangle::Solve`. Closing at AoB 0, moving away at 180°.
+    return los2 / ((std::cos(gamma2) > T(0)) ? T(1) + speed_ratio : T(1) - speed_ratio);
+  }
+  return los2 * (std::sin(gamma2) / sin_alpha2);
+}
+
+/// Whether `ComputeParallaxRunDistance<float>` is ill-conditioned for these angles, and should be evaluated in double.
+inline bool IsParallaxRunDistanceIllConditioned(float gamma2, float beta2) {
+  return std::abs(std::sin(gamma2)) < kIllConditionedSine || std::abs(std::sin(gamma2 + beta2)) < kIllConditionedSine;
+}
+
+/// `ComputeParallaxRunDistance` in float, or in double where that is ill-conditioned.
+inline float ComputeParallaxRunDistanceMixed(float los2, float gamma2, float beta2, float speed_ratio) {
+  if (IsParallaxRunDistanceIllConditioned(gamma2, beta2)) {
+    return static_cast<float>(ComputeParallaxRunDistance<double>(los2, gamma2, beta2, speed_ratio));
+  }
+  return ComputeParallaxRunDistance<float>(los2, gamma2, beta2, speed_ratio);
+}
+
+} // namespace tdc2
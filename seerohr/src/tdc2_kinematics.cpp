@@ -0,0 +1,205 @@
+// TU header --------------------------------------------
+#include "tdc2_kinematics.h"
+
+// c++ headers ------------------------------------------
+#include <cmath>
+
+#include <algorithm>
+
+namespace tdc2 {
+
+namespace {
+
+/// Advance the torpedoes [`first`, `last`) that stay in one phase for the whole step, and flag the others in `crossings`,
+/// leaving them as they are. Every operand is loaded unconditionally and selected afterwards, leaving no control flow in
+/// the way of vectorization; the arrays are passed as non-aliasing, as there are too many for the compiler to check at
+/// run time.
+void StepWithinPhases(
+  std::size_t first,
+  std::size_t last,
+  double const* __restrict step_distances_m,
+  double const* __restrict reaches_m,
+  double const* __restrict turn_ends_m,
+  double const* __restrict turn_forwards_m,
+  double const* __restrict turn_sides_m,
+  double const* __restrict turn_coss,
+  double const* __restrict turn_sins,
+  double* __restrict xs,
+  double* __restrict ys,
+  double* __restrict directions_x,
+  double* __restrict directions_y,
+  double* __restrict run_distances_m,
+  uint64_t* __restrict crossings
+) {
+  for (std::size_t i = first; i < last; ++i) {
+    double const step_distance_m = step_distances_m[i];
+    double const run_distance_m = run_distances_m[i];
+    double const next_run_distance_m = run_distance_m + step_distance_m;
+
+    // Whole step in the reach or the final run, whole step in the turn, or neither. The conditions are as wide as the
+    // state; narrower booleans keep the loop from vectorizing.
+    uint64_t const straight = uint64_t(next_run_distance_m <= reaches_m[i]) | uint64_t(run_distance_m >= turn_ends_m[i]);
+    uint64_t const turning = uint64_t(run_distance_m >= reaches_m[i]) & uint64_t(next_run_distance_m <= turn_ends_m[i]);
+    uint64_t const crossing = (straight | turning) ^ 1;
+
+    double const turn_forward_m = turn_forwards_m[i];
+    double const turn_side_m = turn_sides_m[i];
+    double const turn_cos = turn_coss[i];
+    double const turn_sin = turn_sins[i];
+
+    double const forward_m = turning ? turn_forward_m : (straight ? step_distance_m : 0.0);
+    double const side_m = turning ? turn_side_m : 0.0;
+    double const rotation_cos = turning ? turn_cos : 1.0;
+    double const rotation_sin = turning ? turn_sin : 0.0;
+
+    // Starboard of the heading (dx, dy) is (-dy, dx).
+    double const dx = directions_x[i];
+    double const dy = directions_y[i];
+    xs[i] += forward_m * dx - side_m * dy;
+    ys[i] += forward_m * dy + side_m * dx;
+    directions_x[i] = rotation_cos * dx - rotation_sin * dy;
+    directions_y[i] = rotation_cos * dy + rotation_sin * dx;
+    run_distances_m[i] = crossing ? run_distance_m : next_run_distance_m;
+    crossings[i] = crossing;
+  }
+}
+
+} // namespace
+
+std::size_t TorpedoKinematics::Launch(TorpedoSpec const& torpedo_spec, Vec2 const& tube_position, Angle launch_course, float gyro_angle) {
+  double const step_distance_m = static_cast<double>(torpedo_spec.speed_kn) * 1852.0 / 3600.0 * step_s_;
+  double const turn_radius_m = torpedo_spec.turn_radius;
+  double const turn_sign = (gyro_angle > 0.0f) ? 1.0 : -1.0;
+  double const step_turn_rad = step_distance_m / turn_radius_m;
+
+  step_distance_m_.push_back(step_distance_m);
+  reach_m_.push_back(torpedo_spec.reach);
+  turn_end_m_.push_back(static_cast<double>(torpedo_spec.reach) + turn_radius_m * std::abs(static_cast<double>(gyro_angle)));
+  turn_radius_m_.push_back(turn_radius_m);
+  turn_sign_.push_back(turn_sign);
+  turn_forward_m_.push_back(turn_radius_m * std::sin(step_turn_rad));
+  turn_side_m_.push_back(turn_sign * turn_radius_m * (1.0 - std::cos(step_turn_rad)));
+  turn_cos_.push_back(std::cos(step_turn_rad));
+  turn_sin_.push_back(turn_sign * std::sin(step_turn_rad));
+
+  double const launch_course_rad = launch_course.AsRad();
+  x_.push_back(tube_position.x);
+  y_.push_back(tube_position.y);
+  direction_x_.push_back(std::sin(launch_course_rad));
+  direction_y_.push_back(-std::cos(launch_course_rad));
+  run_distance_m_.push_back(0.0);
+
+  crossing_.push_back(0);
+
+  return x_.size() - 1;
+}
+
+void TorpedoKinematics::Clear() {
+  for (std::vector<double>* values : {
+    &step_distance_m_, &reach_m_, &turn_end_m_, &turn_radius_m_, &turn_sign_,
+    &turn_forward_m_, &turn_side_m_, &turn_cos_, &turn_sin_,
+    &x_, &y_, &direction_x_, &direction_y_, &run_distance_m_,
+  }) {
+    values->clear();
+  }
+  crossing_.clear();
+}
+
+void TorpedoKinematics::Step(std::size_t first, std::size_t count) {
+  std::size_t const last = first + count;
+
+  StepWithinPhases(
+    first,
+    last,
+    step_distance_m_.data(),
+    reach_m_.data(),
+    turn_end_m_.data(),
+    turn_forward_m_.data(),
+    turn_side_m_.data(),
+    turn_cos_.data(),
+    turn_sin_.data(),
+    x_.data(),
+    y_.data(),
+    direction_x_.data(),
+    direction_y_.data(),
+    run_distance_m_.data(),
+    crossing_.data()
+  );
+
+  for (std::size_t i = first; i < last; ++i) {
+    if (crossing_[i] != 0) {
+      this->AdvanceAcrossPhases(i, step_distance_m_[i]);
+    }
+  }
+}
+
+Vec2 TorpedoKinematics::GetPosition(std::size_t index) const {
+  return Vec2 { static_cast<float>(x_[index]), static_cast<float>(y_[index]) };
+}
+
+Angle TorpedoKinematics::GetHeading(std::size_t index) const {
+  return Angle(static_cast<float>(std::atan2(direction_x_[index], -direction_y_[index]))).WrapAround();
+}
+
+TorpedoPhase TorpedoKinematics::GetPhase(std::size_t index) const {
+  if (run_distance_m_[index] < reach_m_[index]) {
+    return TorpedoPhase::kReach;
+  }
+  if (run_distance_m_[index] < turn_end_m_[index]) {
+    return TorpedoPhase::kTurn;
+  }
+  return TorpedoPhase::kStraight;
+}
+
+Vec2 TorpedoKinematics::ComputeEquivalentPointOfFire(std::size_t index) const {
+  double const run_distance_m = run_distance_m_[index];
+  return Vec2 {
+    static_cast<float>(x_[index] - direction_x_[index] * run_distance_m),
+    static_cast<float>(y_[index] - direction_y_[index] * run_distance_m),
+  };
+}
+
+void TorpedoKinematics::AdvanceAcrossPhases(std::size_t index, double distance_m) {
+  double& x = x_[index];
+  double& y = y_[index];
+  double& dx = direction_x_[index];
+  double& dy = direction_y_[index];
+  double& run_distance_m = run_distance_m_[index];
+
+  auto advance_straight = [&](double d) {
+    x += d * dx;
+    y += d * dy;
+    run_distance_m += d;
+  };
+
+  // Reach.
+  double const reach_part_m = std::clamp(reach_m_[index] - run_distance_m, 0.0, distance_m);
+  advance_straight(reach_part_m);
+  distance_m -= reach_part_m;
+
+  // Turn.
+  double const turn_part_m = std::clamp(turn_end_m_[index] - run_distance_m, 0.0, distance_m);
+  if (turn_part_m > 0.0) {
+    double const radius_m = turn_radius_m_[index];
+    double const sign = turn_sign_[index];
+    double const turned_rad = turn_part_m / radius_m;
+    double const forward_m = radius_m * std::sin(turned_rad);
+    double const side_m = sign * radius_m * (1.0 - std::cos(turned_rad));
+    double const rotation_cos = std::cos(turned_rad);
+    double const rotation_sin = sign * std::sin(turned_rad);
+
+    double const x0 = dx;
+    double const y0 = dy;
+    x += forward_m * x0 - side_m * y0;
+    y += forward_m * y0 + side_m * x0;
+    dx = rotation_cos * x0 - rotation_sin * y0;
+    dy = rotation_cos * y0 + rotation_sin * x0;
+    run_distance_m += turn_part_m;
+    distance_m -= turn_part_m;
+  }
+
+  // Final straight run.
+  advance_straight(distance_m);
+}
+
+} // namespace tdc2
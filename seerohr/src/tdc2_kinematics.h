@@ -0,0 +1,92 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+// project headers --------------------------------------
+#include "angle.h"
+#include "vec2.h"
+#include "tdc2_solver.h"
+
+namespace tdc2 {
+
+enum class TorpedoPhase : uint8_t {
+  kReach,    // Straight ahead on the launch course.
+  kTurn,     // Turning onto the gyro angle.
+  kStraight, // Straight on the final course.
+};
+
+/// Time-steps many torpedoes at once along the track the parallax correction assumes: `TorpedoSpec::reach` straight
+/// ahead, a turn of `TorpedoSpec::turn_radius` by the gyro angle, then straight on.
+///
+/// State is kept per torpedo in SoA layout, in double so that the 10^5 and more steps of a long run do not accumulate
+/// error. A step that stays within one phase moves every torpedo by a chord and a rotation precomputed at launch, in a
+/// branch-free loop the compiler can vectorize; only steps crossing from one phase to the next take the trigonometric
+/// path.
+///
+/// Torpedoes are never removed, so that their indices stay valid; callers stop looking at those that hit or expired.
+class TorpedoKinematics final {
+public:
+  explicit TorpedoKinematics(double step_s) : step_s_(step_s) {}
+
+  /// Launch a torpedo of `torpedo_spec` from `tube_position` on `launch_course`, set to `gyro_angle` (positive is
+  /// starboard).
+  ///
+  /// ## Returns
+  /// Its index.
+  std::size_t Launch(TorpedoSpec const& torpedo_spec, Vec2 const& tube_position, Angle launch_course, float gyro_angle);
+  void Clear();
+
+  /// Advance every torpedo by one step.
+  void Step() { this->Step(0, this->GetCount()); }
+  /// Advance torpedoes [`first`, `first + count`) by one step. Disjoint ranges may be stepped concurrently.
+  void Step(std::size_t first, std::size_t count);
+
+  double GetStepS() const { return step_s_; }
+  std::size_t GetCount() const { return x_.size(); }
+
+  Vec2 GetPosition(std::size_t index) const;
+  Angle GetHeading(std::size_t index) const;
+  double GetRunDistance(std::size_t index) const { return run_distance_m_[index]; }
+  TorpedoPhase GetPhase(std::size_t index) const;
+
+  /// Where the torpedo at `index` would have started from to be where it is, had it run its whole distance on its
+  /// current heading. Once past the turn, this is its equivalent point of fire, which the parallax correction takes
+  /// from `TorpedoSpec::ComputeEquivalentPointOfFireOffset` instead.
+  Vec2 ComputeEquivalentPointOfFire(std::size_t index) const;
+
+private:
+  /// Advance the torpedo at `index` by `distance_m` through however many phases that spans.
+  void AdvanceAcrossPhases(std::size_t index, double distance_m);
+
+  double step_s_;
+
+  // Per torpedo, set at launch.
+  std::vector<double> step_distance_m_;
+  std::vector<double> reach_m_;          // Run distance at which the turn starts.
+  std::vector<double> turn_end_m_;       // Run distance at which the turn ends.
+  std::vector<double> turn_radius_m_;
+  std::vector<double> turn_sign_;        // 1 to starboard, -1 to port.
+  // A whole step of turning: Displacement along and to starboard of the heading at its start, and the rotation of the
+  // heading, signed.
+  std::vector<double> turn_forward_m_;
+  std::vector<double> turn_side_m_;
+  std::vector<double> turn_cos_;
+  std::vector<double> turn_sin_;
+
+  // Per torpedo, state. The heading is kept as a unit vector.
+  std::vector<double> x_;
+  std::vector<double> y_;
+  std::vector<double> direction_x_;
+  std::vector<double> direction_y_;
+  std::vector<double> run_distance_m_;
+
+  // Scratch for `Step`: Torpedoes whose step crosses phases, left to `AdvanceAcrossPhases`. As wide as the state, so
+  // that the step vectorizes as a whole.
+  std::vector<uint64_t> crossing_;
+};
+
+} // namespace tdc2
@@ -0,0 +1,142 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cmath>
+#include <cstdint>
+
+#include <bit>
+#include <numbers>
+
+namespace tdc2::lane {
+
+// Float math for loops over the lanes of the batch solvers.
+//
+// `std::sin` and friends are library calls, and a loop calling them is never vectorized. The functions below are the
+// Cephes polynomials, written with arithmetic and selects only, so such a loop is. The scalar solvers call them too, so
+// the batch and scalar paths agree bit for bit; `tdc2_core` is built without FMA contraction for that.
+//
+// Measured against double: `Sin` and `Cos` are off by less than 8e-8 for |x| up to 8192 rad, i.e. within 2 ULP unless the
+// result is near 0, where the solvers switch to double anyway; beyond 8192 rad the range reduction runs out of bits of
+// π. `Asin` is within 2.5 ULP, `Atan2` within 3.5 ULP. The `double` overloads forward to the standard library, for the
+// solvers templated on precision.
+
+namespace detail {
+
+/// `x` rounded to the nearest integer, ties to even, for |x| < 2²²; also the integer itself, modulo 2²², in the low
+/// bits of `bits`.
+inline float RoundToNearest(float x, uint32_t& bits) {
+  constexpr float kMagic = 12582912.0f; // 1.5 * 2^23: The sum has a unit ULP.
+  float const sum = x + kMagic;
+  bits = std::bit_cast<uint32_t>(sum);
+  return sum - kMagic;
+}
+
+/// `x` less `n` quarter turns, in three parts so that the first two products are exact.
+inline float ReduceQuarterTurns(float x, float n) {
+  constexpr float kPiOver2Hi = 1.5703125f;
+  constexpr float kPiOver2Mid = 4.837512969970703125e-4f;
+  constexpr float kPiOver2Lo = 7.54978995489188216e-8f;
+  return ((x - n * kPiOver2Hi) - n * kPiOver2Mid) - n * kPiOver2Lo;
+}
+
+/// sin(r) for r in [-π/4, π/4].
+inline float SinPolynomial(float r) {
+  float const z = r * r;
+  return ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * r + r;
+}
+
+/// cos(r) for r in [-π/4, π/4].
+inline float CosPolynomial(float r) {
+  float const z = r * r;
+  return ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z - 0.5f * z + 1.0f;
+}
+
+} // namespace detail
+
+inline float Sin(float x) {
+  uint32_t quadrant = 0;
+  float const n = detail::RoundToNearest(x * (2.0f / std::numbers::pi_v<float>), quadrant);
+  float const r = detail::ReduceQuarterTurns(x, n);
+
+  float const s = detail::SinPolynomial(r);
+  float const c = detail::CosPolynomial(r);
+  float const value = ((quadrant & 1) != 0) ? c : s;
+  return ((quadrant & 2) != 0) ? -value : value;
+}
+
+inline float Cos(float x) {
+  uint32_t quadrant = 0;
+  float const n = detail::RoundToNearest(x * (2.0f / std::numbers::pi_v<float>), quadrant);
+  float const r = detail::ReduceQuarterTurns(x, n);
+
+  float const s = detail::SinPolynomial(r);
+  float const c = detail::CosPolynomial(r);
+  float const value = ((quadrant & 1) != 0) ? s : c;
+  return (((quadrant + 1) & 2) != 0) ? -value : value;
+}
+
+/// For `x` in [-1, 1].
+inline float Asin(float x) {
+  float const a = std::abs(x);
+
+  // Near ±1, asin(a) = π/2 - 2 asin(sqrt((1 - a) / 2)).
+  bool const near_one = 0.5f < a;
+  float const z = near_one ? 0.5f * (1.0f - a) : a * a;
+  float const s = near_one ? std::sqrt(z) : a;
+
+  float const p = ((((4.2163199048e-2f * z + 2.4181311049e-2f) * z + 4.5470025998e-2f) * z + 7.4953002686e-2f) * z + 1.6666752422e-1f) * z * s + s;
+  float const value = near_one ? std::numbers::pi_v<float> / 2.0f - (p + p) : p;
+  return (x < 0.0f) ? -value : value;
+}
+
+/// For finite `y` and `x`; 0 if both are 0, with the signs of `std::atan2`.
+inline float Atan2(float y, float x) {
+  float const ax = std::abs(x);
+  float const ay = std::abs(y);
+
+  // atan of the smaller over the larger, in [0, π/4]; reduced further about tan(π/8).
+  float const lo = (ay < ax) ? ay : ax;
+  float const hi = (ay < ax) ? ax : ay;
+  float const q = (hi == 0.0f) ? 0.0f : lo / hi;
+
+  bool const above_pi_over_8 = 0.4142135623730950f < q;
+  float const t = above_pi_over_8 ? (q - 1.0f) / (q + 1.0f) : q;
+  float const z = t * t;
+  float const p = (((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f) * z * t + t;
+  float value = above_pi_over_8 ? std::numbers::pi_v<float> / 4.0f + p : p;
+
+  value = (ax < ay) ? std::numbers::pi_v<float> / 2.0f - value : value;
+  value = std::signbit(x) ? std::numbers::pi_v<float> - value : value;
+  return std::signbit(y) ? -value : value;
+}
+
+/// `angle` wrapped into [-π, π]; angles already in it are returned as they are.
+///
+/// Whole turns are taken off exactly, so this is `std::remainder(angle, 2π)` but for the sign of ±π.
+inline float WrapPi(float angle) {
+  constexpr float kTwoPi = 2.0f * std::numbers::pi_v<float>;
+  constexpr float kTwoPiHi = 6.28125f;             // Few enough bits for an exact product with the turn count.
+  constexpr float kTwoPiLo = kTwoPi - kTwoPiHi;    // Exact, and as short.
+
+  uint32_t bits = 0;
+  float const n = detail::RoundToNearest(angle * (1.0f / kTwoPi), bits);
+  float r = (angle - n * kTwoPiHi) - n * kTwoPiLo;
+
+  // `n` may be a turn off where the product rounds across a half turn.
+  r = (std::numbers::pi_v<float> < r) ? r - kTwoPi : r;
+  r = (r < -std::numbers::pi_v<float>) ? r + kTwoPi : r;
+  return r;
+}
+
+/// `condition ? if_true : if_false`, in bit operations: The compiler may turn several selects on one condition back into
+/// a branch, and then leaves the loop they are in scalar.
+inline float Select(bool condition, float if_true, float if_false) {
+  uint32_t const mask = 0u - static_cast<uint32_t>(condition);
+  return std::bit_cast<float>((std::bit_cast<uint32_t>(if_true) & mask) | (std::bit_cast<uint32_t>(if_false) & ~mask));
+}
+
+inline double Sin(double x) { return std::sin(x); }
+inline double Cos(double x) { return std::cos(x); }
+inline double Asin(double x) { return std::asin(x); }
+
+} // namespace tdc2::lane
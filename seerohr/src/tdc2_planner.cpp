@@ -0,0 +1,241 @@
+// TU header --------------------------------------------
+#include "tdc2_planner.h"
+
+// c++ headers ------------------------------------------
+#include <cmath>
+
+#include <algorithm>
+#include <numbers>
+
+// project headers --------------------------------------
+#include "tdc2_targets.h"
+
+namespace tdc2 {
+
+namespace {
+
+/// `ship` after `time_s` on its course and speed.
+SimShip PredictShip(SimShip const& ship, float time_s) {
+  SimShip predicted = ship;
+  predicted.position = ship.position + ComputeCourseDirection(ship.course) * (ship.speed_kn * 1852.0f / 3600.0f * time_s);
+  return predicted;
+}
+
+/// Call `solve_tile(tile)` for each of `tile_count` tiles, on `job_system` if given, otherwise inline.
+template <typename F>
+void SolveTiles(std::size_t tile_count, JobSystem* job_system, F&& solve_tile) {
+  if (job_system == nullptr) {
+    for (std::size_t tile = 0; tile < tile_count; ++tile) {
+      solve_tile(tile);
+    }
+    return;
+  }
+
+  job_system->ParallelFor(
+    tile_count,
+    [&](uint64_t first_tile, uint64_t chunk_tile_count) {
+      for (uint64_t tile = first_tile; tile < first_tile + chunk_tile_count; ++tile) {
+        solve_tile(static_cast<std::size_t>(tile));
+      }
+    },
+    ParallelForOptions { .chunk_size = 1, .progress = {} }
+  );
+}
+
+} // namespace
+
+void FiringPlanner::Plan(
+  TorpedoSpec const& torpedo_spec,
+  SimShip const& ownship,
+  SimShip const& target,
+  FiringPlanOptions const& options,
+  JobSystem* job_system
+) {
+  std::size_t const count = options.candidate_count;
+
+  if (count != candidates_.size()) {
+    candidates_.resize(count);
+    input_.Resize(count);
+    tri_output_.Resize(count);
+    pc_output_.Resize(count);
+    warm_start_.Resize(count);
+    warm_start_.Reset(0, count);
+  }
+  if (!(torpedo_spec == warm_torpedo_spec_)) {
+    warm_torpedo_spec_ = torpedo_spec;
+    warm_start_.Reset(0, count);
+  }
+
+  // Built here, as the cache is not safe to share between the tiles.
+  EquivalentPointOfFireCurve const* const epf_curve = &epf_curve_cache_.Get(torpedo_spec);
+  float const time_step_s = (count > 1) ? options.horizon_s / static_cast<float>(count - 1) : 0.0f;
+
+  auto solve_tile = [&](std::size_t tile) {
+    std::size_t const first = tile * kTileCandidateCount;
+    std::size_t const tile_count = std::min(kTileCandidateCount, count - first);
+
+    for (std::size_t i = first; i < first + tile_count; ++i) {
+      float const time_s = time_step_s * static_cast<float>(i);
+      Vec2 const aiming_device_position = PredictShip(ownship, time_s).GetAimingDevicePosition();
+      TargetData const observed = ComputeTargetData(
+        aiming_device_position, ownship.course, PredictShip(target, time_s).position, target.course, target.speed_kn
+      );
+
+      candidates_[i].time_s = time_s;
+      input_.target_bearing[i] = observed.target_bearing.AsRad();
+      input_.target_range_m[i] = observed.target_range_m;
+      input_.target_speed_kn[i] = observed.target_speed_kn;
+      input_.angle_on_bow[i] = observed.angle_on_bow.AsRad();
+      input_.ownship_course[i] = ownship.course.AsRad();
+      input_.aiming_device_x[i] = aiming_device_position.x;
+      input_.aiming_device_y[i] = aiming_device_position.y;
+    }
+
+    SolveTorpedoTriangleBatch(torpedo_spec.speed_kn, input_, tri_output_, first, tile_count);
+    SolveParallaxCorrectionBatchWarm(torpedo_spec, input_, tri_output_, warm_start_, pc_output_, first, tile_count, epf_curve);
+  };
+
+  SolveTiles((count + kTileCandidateCount - 1) / kTileCandidateCount, job_system, solve_tile);
+
+  // The hit window is scored against the widest of the plan, so it needs every candidate first.
+  float const max_gyro_angle = options.max_gyro_angle.AsRad();
+  float max_hit_window = 0.0f;
+  for (std::size_t i = 0; i < count; ++i) {
+    FiringPlanCandidate& candidate = candidates_[i];
+    candidate.gyro_angle = pc_output_.rho[i];
+    candidate.run_distance_m = pc_output_.torpedo_run_distance_m[i];
+    candidate.feasible = pc_output_.valid[i] != 0
+      && candidate.run_distance_m <= options.max_run_distance_m
+      && std::abs(candidate.gyro_angle) <= max_gyro_angle;
+    if (!candidate.feasible) {
+      candidate.hit_window = 0.0f;
+      continue;
+    }
+
+    float const track_angle = tri_output_.target_course[i] - (input_.ownship_course[i] + candidate.gyro_angle);
+    float const presented_length_m =
+      target.length_m * std::abs(std::sin(track_angle)) + target.beam_m * std::abs(std::cos(track_angle));
+    candidate.hit_window = 2.0f * std::atan2(0.5f * presented_length_m, candidate.run_distance_m);
+    max_hit_window = std::max(max_hit_window, candidate.hit_window);
+  }
+
+  float const weight_sum = options.gyro_angle_weight + options.run_distance_weight + options.hit_window_weight;
+  best_index_.reset();
+  for (std::size_t i = 0; i < count; ++i) {
+    FiringPlanCandidate& candidate = candidates_[i];
+    if (!candidate.feasible || !(weight_sum > 0.0f)) {
+      candidate.score = 1.0f;
+      continue;
+    }
+
+    float const gyro_angle_term = (max_gyro_angle > 0.0f) ? std::abs(candidate.gyro_angle) / max_gyro_angle : 0.0f;
+    float const run_distance_term = (options.max_run_distance_m > 0.0f) ? candidate.run_distance_m / options.max_run_distance_m : 0.0f;
+    float const hit_window_term = (max_hit_window > 0.0f) ? 1.0f - candidate.hit_window / max_hit_window : 0.0f;
+    candidate.score = (
+      options.gyro_angle_weight * gyro_angle_term +
+      options.run_distance_weight * run_distance_term +
+      options.hit_window_weight * hit_window_term
+    ) / weight_sum;
+
+    if (!best_index_.has_value() || candidate.score < candidates_[best_index_.value()].score) {
+      best_index_ = i;
+    }
+  }
+}
+
+bool CourseSweep::Sweep(
+  TorpedoSpec const& torpedo_spec,
+  SimShip const& ownship,
+  SimShip const& target,
+  uint32_t course_count,
+  JobSystem* job_system
+) {
+  std::size_t const count = course_count;
+
+  bool const ownship_changed = !swept_ownship_.has_value()
+    || !(ownship.position == swept_ownship_->position)
+    || ownship.distance_to_aiming_device != swept_ownship_->distance_to_aiming_device
+    || count != samples_.size();
+  bool const target_changed = !swept_target_.has_value()
+    || !(target.position == swept_target_->position)
+    || target.course != swept_target_->course
+    || target.speed_kn != swept_target_->speed_kn
+    || !(torpedo_spec == swept_torpedo_spec_);
+  if (!ownship_changed && !target_changed) {
+    return false;
+  }
+
+  if (count != samples_.size()) {
+    samples_.resize(count);
+    input_.Resize(count);
+    tri_output_.Resize(count);
+    pc_output_.Resize(count);
+    warm_start_.Resize(count);
+    warm_start_.Reset(0, count);
+  }
+  if (!(torpedo_spec == swept_torpedo_spec_)) {
+    warm_start_.Reset(0, count);
+  }
+  swept_torpedo_spec_ = torpedo_spec;
+  swept_target_ = target;
+
+  if (ownship_changed) {
+    swept_ownship_ = ownship;
+    float const course_step = (count > 0) ? 2.0f * std::numbers::pi_v<float> / static_cast<float>(count) : 0.0f;
+    for (std::size_t i = 0; i < count; ++i) {
+      SimShip turned = ownship;
+      turned.course = Angle(course_step * static_cast<float>(i));
+      Vec2 const aiming_device_position = turned.GetAimingDevicePosition();
+      samples_[i].course = turned.course.AsRad();
+      input_.ownship_course[i] = turned.course.AsRad();
+      input_.aiming_device_x[i] = aiming_device_position.x;
+      input_.aiming_device_y[i] = aiming_device_position.y;
+    }
+  }
+
+  // Built here, as the cache is not safe to share between the tiles.
+  EquivalentPointOfFireCurve const* const epf_curve = &epf_curve_cache_.Get(torpedo_spec);
+
+  auto solve_tile = [&](std::size_t tile) {
+    std::size_t const first = tile * kTileCourseCount;
+    std::size_t const tile_count = std::min(kTileCourseCount, count - first);
+
+    for (std::size_t i = first; i < first + tile_count; ++i) {
+      TargetData const observed = ComputeTargetData(
+        Vec2 { input_.aiming_device_x[i], input_.aiming_device_y[i] }, Angle(input_.ownship_course[i]),
+        target.position, target.course, target.speed_kn
+      );
+      input_.target_bearing[i] = observed.target_bearing.AsRad();
+      input_.target_range_m[i] = observed.target_range_m;
+      input_.target_speed_kn[i] = observed.target_speed_kn;
+      input_.angle_on_bow[i] = observed.angle_on_bow.AsRad();
+    }
+
+    SolveTorpedoTriangleBatch(torpedo_spec.speed_kn, input_, tri_output_, first, tile_count);
+    SolveParallaxCorrectionBatchWarm(torpedo_spec, input_, tri_output_, warm_start_, pc_output_, first, tile_count, epf_curve);
+  };
+  SolveTiles((count + kTileCourseCount - 1) / kTileCourseCount, job_system, solve_tile);
+
+  min_gyro_angle_index_.reset();
+  min_parallax_delta_index_.reset();
+  for (std::size_t i = 0; i < count; ++i) {
+    CourseSweepSample& sample = samples_[i];
+    sample.valid = pc_output_.valid[i] != 0;
+    sample.gyro_angle = pc_output_.rho[i];
+    sample.parallax_delta = pc_output_.delta[i];
+    sample.run_distance_m = pc_output_.torpedo_run_distance_m[i];
+    if (!sample.valid) {
+      continue;
+    }
+
+    if (!min_gyro_angle_index_.has_value() || std::abs(sample.gyro_angle) < std::abs(samples_[min_gyro_angle_index_.value()].gyro_angle)) {
+      min_gyro_angle_index_ = i;
+    }
+    if (!min_parallax_delta_index_.has_value() || std::abs(sample.parallax_delta) < std::abs(samples_[min_parallax_delta_index_.value()].parallax_delta)) {
+      min_parallax_delta_index_ = i;
+    }
+  }
+  return true;
+}
+
+} // namespace tdc2
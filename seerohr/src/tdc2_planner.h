@@ -0,0 +1,137 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cstddef>
+#include <cstdint>
+
+#include <optional>
+#include <span>
+#include <vector>
+
+// project headers --------------------------------------
+#include "angle.h"
+#include "vec2.h"
+#include "job_system.h"
+#include "tdc2_batch.h"
+#include "tdc2_epf.h"
+#include "tdc2_sim.h"
+#include "tdc2_solver.h"
+
+namespace tdc2 {
+
+struct FiringPlanOptions final {
+  /// Candidate launch times are spread evenly over [0, `horizon_s`] from now.
+  float horizon_s = 600.0f;
+  uint32_t candidate_count = 4096;
+
+  /// Solutions beyond either are not feasible.
+  float max_run_distance_m = 5000.0f; // Of both the G7a at 44 kn and the G7e.
+  Angle max_gyro_angle = Angle::FromDeg(90.0f);
+
+  /// Of the terms of the score, each in [0, 1] and lower for better solutions.
+  float gyro_angle_weight = 1.0f;
+  float run_distance_weight = 1.0f;
+  float hit_window_weight = 1.0f;
+};
+
+struct FiringPlanCandidate final {
+  float time_s = 0.0f;           // From now.
+  bool feasible = false;         // Solved, and within the limits of `FiringPlanOptions`.
+  float gyro_angle = 0.0f;       // Final, after parallax correction. Signed: Positive is starboard, negative is port.
+  float run_distance_m = 0.0f;
+  /// Spread of gyro angles that still hit: The target's waterline as presented to the torpedo track, seen from the
+  /// equivalent point of fire at the run distance.
+  float hit_window = 0.0f;
+  /// Weighted mean of the terms of `FiringPlanOptions`, in [0, 1]; lower is better. 1 if not feasible.
+  float score = 1.0f;
+};
+
+/// When to fire: The torpedo triangle and parallax correction solved for many launch times ahead, with both ships holding
+/// course and speed, and ranked.
+///
+/// Candidates are solved in tiles of `kTileCandidateCount`, which run concurrently. Each starts from the solution of the
+/// same candidate in the last plan, which for a plan made every frame is only a frame further on.
+class FiringPlanner final {
+public:
+  static constexpr std::size_t kTileCandidateCount = 128;
+
+  /// Plan against `target`, whose `length_m` and `beam_m` give the hit window, from `ownship`. Runs on `job_system` if
+  /// given, otherwise inline.
+  void Plan(
+    TorpedoSpec const& torpedo_spec,
+    SimShip const& ownship,
+    SimShip const& target,
+    FiringPlanOptions const& options,
+    JobSystem* job_system = nullptr
+  );
+
+  std::span<FiringPlanCandidate const> GetCandidates() const { return candidates_; }
+  /// The feasible candidate of lowest score, the earliest of equals; none if none is feasible.
+  std::optional<std::size_t> GetBestIndex() const { return best_index_; }
+
+private:
+  std::vector<FiringPlanCandidate> candidates_;
+  std::optional<std::size_t> best_index_;
+
+  TorpedoTriangleBatchInput input_;
+  TorpedoTriangleBatchOutput tri_output_;
+  ParallaxCorrectionBatchOutput pc_output_;
+  ParallaxWarmStartBatch warm_start_;
+  TorpedoSpec warm_torpedo_spec_; // What `warm_start_` was solved for.
+
+  EquivalentPointOfFireCurveCache epf_curve_cache_;
+};
+
+struct CourseSweepSample final {
+  float course = 0.0f;          // Of the ownship, in radians. North is 0, clockwise.
+  bool valid = false;
+  float gyro_angle = 0.0f;      // Final, after parallax correction. Signed: Positive is starboard, negative is port.
+  float parallax_delta = 0.0f;  // Parallax correction angle.
+  float run_distance_m = 0.0f;
+};
+
+/// Which way to turn: The torpedo triangle and parallax correction solved for the ownship on every course, turning in
+/// place, against a target that holds its position in the world.
+///
+/// What depends on the ownship alone, its courses and aiming device positions, is kept until the ownship moves or the
+/// course count changes. A target that has changed is solved again starting from the last sweep; one that has not is not
+/// solved at all.
+class CourseSweep final {
+public:
+  static constexpr std::size_t kTileCourseCount = 128;
+
+  /// Sweep `course_count` courses evenly over [0, 2pi) for `ownship`, whose `course` is ignored, against `target`. Runs on
+  /// `job_system` if given, otherwise inline. Returns whether anything was solved.
+  bool Sweep(
+    TorpedoSpec const& torpedo_spec,
+    SimShip const& ownship,
+    SimShip const& target,
+    uint32_t course_count,
+    JobSystem* job_system = nullptr
+  );
+
+  std::span<CourseSweepSample const> GetSamples() const { return samples_; }
+  /// The valid sample of least gyro angle magnitude, the first of equals; none if none is valid.
+  std::optional<std::size_t> GetMinGyroAngleIndex() const { return min_gyro_angle_index_; }
+  /// The valid sample of least parallax correction magnitude, the first of equals; none if none is valid.
+  std::optional<std::size_t> GetMinParallaxDeltaIndex() const { return min_parallax_delta_index_; }
+
+private:
+  std::vector<CourseSweepSample> samples_;
+  std::optional<std::size_t> min_gyro_angle_index_;
+  std::optional<std::size_t> min_parallax_delta_index_;
+
+  // What `input_` and the last solve were for.
+  std::optional<SimShip> swept_ownship_;
+  std::optional<SimShip> swept_target_;
+  TorpedoSpec swept_torpedo_spec_;
+
+  TorpedoTriangleBatchInput input_;
+  TorpedoTriangleBatchOutput tri_output_;
+  ParallaxCorrectionBatchOutput pc_output_;
+  ParallaxWarmStartBatch warm_start_;
+
+  EquivalentPointOfFireCurveCache epf_curve_cache_;
+};
+
+} // namespace tdc2
@@ -0,0 +1,274 @@
+// TU header --------------------------------------------
+#include "tdc2_sim.h"
+
+// c++ headers ------------------------------------------
+#include <cmath>
+
+#include <algorithm>
+#include <limits>
+
+// project headers --------------------------------------
+#include "tdc2_targets.h"
+
+namespace tdc2 {
+
+namespace {
+
+/// Unit vector to starboard of `course`.
+Vec2 ComputeStarboardDirection(Angle course) {
+  return Vec2 { course.Cos(), course.Sin() };
+}
+
+} // namespace
+
+Vec2 ComputeCourseDirection(Angle course) {
+  return Vec2 { course.Sin(), -course.Cos() };
+}
+
+Vec2 ComputeTorpedoTrackPosition(
+  TorpedoSpec const& torpedo_spec,
+  Vec2 const& tube_position,
+  Angle launch_course,
+  float gyro_angle,
+  float run_distance_m,
+  Angle* heading
+) {
+  Vec2 const e0 = ComputeCourseDirection(launch_course);
+  Vec2 const r0 = ComputeStarboardDirection(launch_course);
+  float const sign = (gyro_angle > 0.0f) ? 1.0f : -1.0f;
+  float const abs_gyro_angle = std::abs(gyro_angle);
+  float const turn_length_m = torpedo_spec.turn_radius * abs_gyro_angle;
+
+  // Reach.
+  if (run_distance_m <= torpedo_spec.reach) {
+    if (heading != nullptr) {
+      *heading = launch_course;
+    }
+    return tube_position + e0 * run_distance_m;
+  }
+
+  // Turn.
+  Vec2 const p1 = tube_position + e0 * torpedo_spec.reach;
+  if (run_distance_m <= torpedo_spec.reach + turn_length_m) {
+    float const turned = (run_distance_m - torpedo_spec.reach) / torpedo_spec.turn_radius;
+    if (heading != nullptr) {
+      *heading = launch_course + Angle(sign * turned);
+    }
+    return p1 + e0 * (torpedo_spec.turn_radius * std::sin(turned)) + r0 * (sign * torpedo_spec.turn_radius * (1.0f - std::cos(turned)));
+  }
+
+  // Final straight run.
+  Vec2 const p2 = p1 + e0 * (torpedo_spec.turn_radius * std::sin(abs_gyro_angle)) + r0 * (sign * torpedo_spec.turn_radius * (1.0f - std::cos(abs_gyro_angle)));
+  Angle const final_heading = launch_course + Angle(gyro_angle);
+  if (heading != nullptr) {
+    *heading = final_heading;
+  }
+  return p2 + ComputeCourseDirection(final_heading) * (run_distance_m - torpedo_spec.reach - turn_length_m);
+}
+
+//
+// SimShip
+//
+
+Vec2 SimShip::GetAimingDevicePosition() const {
+  return position + ComputeCourseDirection(course) * distance_to_aiming_device;
+}
+
+bool SimShip::Contains(Vec2 const& point) const {
+  Vec2 const local = point - position;
+  Vec2 const forward = ComputeCourseDirection(course);
+  Vec2 const starboard = ComputeStarboardDirection(course);
+  float const along = local.x * forward.x + local.y * forward.y;
+  float const across = local.x * starboard.x + local.y * starboard.y;
+  return std::abs(along) <= length_m * 0.5f && std::abs(across) <= beam_m * 0.5f;
+}
+
+//
+// Simulation
+//
+
+std::size_t Simulation::AddTarget(SimShip const& target) {
+  targets_.push_back(TrackedShip { .ship = target });
+  return targets_.size() - 1;
+}
+
+bool Simulation::HasRunningTorpedo() const {
+  return std::any_of(torpedoes_.begin(), torpedoes_.end(), [](SimTorpedo const& torpedo) {
+    return torpedo.state == SimTorpedoState::kRunning;
+  });
+}
+
+TdcInputs Simulation::ObserveTarget(std::size_t target_index) const {
+  SimShip const& ownship = ownship_.ship;
+  SimShip const& target = targets_[target_index].ship;
+
+  Vec2 const aiming_device_position = ownship.GetAimingDevicePosition();
+  TargetData const observed = ComputeTargetData(aiming_device_position, ownship.course, target.position, target.course, target.speed_kn);
+
+  TdcInputs inputs = tdc_settings_;
+  inputs.target_bearing = observed.target_bearing;
+  inputs.target_range_m = observed.target_range_m;
+  inputs.target_speed_kn = observed.target_speed_kn;
+  inputs.angle_on_bow = observed.angle_on_bow;
+  inputs.ownship_course = ownship.course;
+  inputs.aiming_device_position = aiming_device_position;
+  return inputs;
+}
+
+void Simulation::PlaceTarget(std::size_t target_index, TdcInputs const& observed) {
+  SimShip const& ownship = ownship_.ship;
+  SimShip& target = targets_[target_index].ship;
+
+  target.position = ComputeTargetPosition(
+    ownship.GetAimingDevicePosition(),
+    ownship.course,
+    observed.target_bearing,
+    observed.target_range_m
+  );
+  target.course = (ComputeAbsoluteTargetBearing(ownship.course, observed.target_bearing) + Angle::Pi() - observed.angle_on_bow).WrapAround();
+  target.speed_kn = observed.target_speed_kn;
+}
+
+bool Simulation::Fire() {
+  if (!tracked_target_index_.has_value()) {
+    return false;
+  }
+  // The TDC was last updated at the last step; the target or the settings may have changed since.
+  tdc_.Update(this->ObserveTarget(tracked_target_index_.value()));
+
+  std::optional<ParallaxCorrectionSolution> const& solution = tdc_.GetParallaxSolution();
+  if (!solution.has_value()) {
+    return false;
+  }
+  this->Launch(tdc_settings_.torpedo_spec, solution->rho);
+  return true;
+}
+
+void Simulation::Launch(TorpedoSpec const& torpedo_spec, float gyro_angle) {
+  SimShip const& ownship = ownship_.ship;
+
+  SimTorpedo& torpedo = torpedoes_.emplace_back();
+  torpedo.spec = torpedo_spec;
+  torpedo.tube_position = ownship.GetAimingDevicePosition() + ComputeCourseDirection(ownship.course) * torpedo_spec.distance_to_tube;
+  torpedo.launch_course = ownship.course;
+  torpedo.gyro_angle = gyro_angle;
+  torpedo.launch_time_s = this->GetTime();
+  torpedo.position = torpedo.tube_position;
+  torpedo.heading = ownship.course;
+  torpedo.closest_approach_m = std::numeric_limits<float>::infinity();
+  for (TrackedShip const& target : targets_) {
+    torpedo.closest_approach_m = std::min(torpedo.closest_approach_m, (target.ship.position - torpedo.position).Length());
+  }
+
+  torpedo_kinematics_.Launch(torpedo_spec, torpedo.tube_position, torpedo.launch_course, gyro_angle);
+}
+
+void Simulation::Step() {
+  double const previous_time_s = this->GetTime();
+  ++step_count_;
+  double const time_s = this->GetTime();
+
+  MoveShip(ownship_, previous_time_s, time_s);
+  for (TrackedShip& target : targets_) {
+    MoveShip(target, previous_time_s, time_s);
+  }
+
+  torpedo_kinematics_.Step();
+  if (kMinGridTargetCount <= targets_.size() && this->HasRunningTorpedo()) {
+    this->UpdateTargetGrid();
+  }
+  for (std::size_t i = 0; i < torpedoes_.size(); ++i) {
+    if (torpedoes_[i].state == SimTorpedoState::kRunning) {
+      this->UpdateTorpedo(i, time_s);
+    }
+  }
+
+  if (tracked_target_index_.has_value()) {
+    tdc_.Update(this->ObserveTarget(tracked_target_index_.value()));
+  }
+}
+
+uint32_t Simulation::Advance(double real_elapsed_s, float time_compression, uint32_t max_step_count) {
+  time_compression = std::clamp(time_compression, kMinTimeCompression, kMaxTimeCompression);
+  accumulator_s_ += std::max(real_elapsed_s, 0.0) * static_cast<double>(time_compression);
+
+  uint32_t step_count = 0;
+  while (accumulator_s_ >= kStepS && step_count < max_step_count) {
+    this->Step();
+    accumulator_s_ -= kStepS;
+    ++step_count;
+  }
+  if (accumulator_s_ >= kStepS) {
+    accumulator_s_ = 0.0;
+  }
+  return step_count;
+}
+
+void Simulation::MoveShip(TrackedShip& tracked, double previous_time_s, double time_s) {
+  SimShip& ship = tracked.ship;
+  if (ship.position != tracked.last_position || ship.course != tracked.anchor_course || ship.speed_kn != tracked.anchor_speed_kn) {
+    tracked.anchor_position = ship.position;
+    tracked.anchor_course = ship.course;
+    tracked.anchor_speed_kn = ship.speed_kn;
+    tracked.anchor_time_s = previous_time_s;
+  }
+
+  float const elapsed_s = static_cast<float>(time_s - tracked.anchor_time_s);
+  ship.position = tracked.anchor_position + ComputeCourseDirection(ship.course) * (ship.speed_kn * 1852.0f / 3600.0f * elapsed_s);
+  tracked.last_position = ship.position;
+}
+
+void Simulation::UpdateTargetGrid() {
+  target_positions_.resize(targets_.size());
+  max_target_extent_m_ = 0.0f;
+  for (std::size_t i = 0; i < targets_.size(); ++i) {
+    SimShip const& target = targets_[i].ship;
+    target_positions_[i] = target.position;
+    max_target_extent_m_ = std::max(max_target_extent_m_, 0.5f * std::hypot(target.length_m, target.beam_m));
+  }
+  target_grid_.Update(target_positions_);
+}
+
+void Simulation::UpdateTorpedo(std::size_t index, double time_s) {
+  SimTorpedo& torpedo = torpedoes_[index];
+  torpedo.run_distance_m = static_cast<float>(torpedo_kinematics_.GetRunDistance(index));
+  torpedo.position = torpedo_kinematics_.GetPosition(index);
+  torpedo.heading = torpedo_kinematics_.GetHeading(index);
+
+  // Only targets nearer than the closest approach so far can lower it, and only those within their extent can be hit;
+  // of several hit at once, the first by index is, as if all were checked in order.
+  std::optional<std::size_t> hit_target_index;
+  auto check_target = [&](std::size_t i) {
+    SimShip const& target = targets_[i].ship;
+    torpedo.closest_approach_m = std::min(torpedo.closest_approach_m, (target.position - torpedo.position).Length());
+    if (target.Contains(torpedo.position) && (!hit_target_index.has_value() || i < hit_target_index.value())) {
+      hit_target_index = i;
+    }
+  };
+  if (targets_.size() < kMinGridTargetCount) {
+    for (std::size_t i = 0; i < targets_.size(); ++i) {
+      check_target(i);
+    }
+  }
+  else {
+    float const reach_m = std::max(torpedo.closest_approach_m, max_target_extent_m_);
+    target_grid_.ForEachInBox(
+      torpedo.position - Vec2 { reach_m, reach_m },
+      torpedo.position + Vec2 { reach_m, reach_m },
+      check_target
+    );
+  }
+  if (hit_target_index.has_value()) {
+    torpedo.state = SimTorpedoState::kHit;
+    torpedo.hit_target_index = hit_target_index.value();
+    torpedo.end_time_s = time_s;
+    return;
+  }
+
+  if (torpedo.run_distance_m >= kMaxTorpedoRunDistanceM) {
+    torpedo.state = SimTorpedoState::kExpired;
+    torpedo.end_time_s = time_s;
+  }
+}
+
+} // namespace tdc2
@@ -0,0 +1,189 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cstddef>
+#include <cstdint>
+
+#include <optional>
+#include <span>
+#include <vector>
+
+// project headers --------------------------------------
+#include "angle.h"
+#include "vec2.h"
+#include "tdc2_graph.h"
+#include "tdc2_kinematics.h"
+#include "tdc2_solver.h"
+#include "tdc2_spatial.h"
+
+namespace tdc2 {
+
+/// Unit vector of `course`: North is 0, clockwise, in the y-down frame of the world.
+Vec2 ComputeCourseDirection(Angle course);
+
+/// Position along the track of a torpedo fired from `tube_position` on `launch_course`, after `run_distance_m`.
+///
+/// The track is the one the parallax correction assumes: `torpedo_spec.reach` straight ahead, a turn of radius
+/// `torpedo_spec.turn_radius` by `gyro_angle` (positive is starboard), then straight on. If `heading` is given, it
+/// receives the heading of the torpedo there.
+Vec2 ComputeTorpedoTrackPosition(
+  TorpedoSpec const& torpedo_spec,
+  Vec2 const& tube_position,
+  Angle launch_course,
+  float gyro_angle,
+  float run_distance_m,
+  Angle* heading = nullptr
+);
+
+/// A ship of a `Simulation`, moving in a straight line at constant speed between changes.
+struct SimShip final {
+  Vec2 position = { 0.0f, 0.0f };
+  Angle course = Angle::FromDeg(0.0f); // North is 0 degrees, clockwise.
+  float speed_kn = 0.0f;
+
+  float length_m = 0.0f;
+  float beam_m = 0.0f;
+  float distance_to_aiming_device = 0.0f; // Forward of `position`.
+
+  Vec2 GetAimingDevicePosition() const;
+  /// Whether `point` is within the waterline, taken as a rectangle of `length_m` by `beam_m`.
+  bool Contains(Vec2 const& point) const;
+};
+
+enum class SimTorpedoState {
+  kRunning,
+  kHit,
+  kExpired, // Ran `Simulation::kMaxTorpedoRunDistanceM` without a hit.
+};
+
+struct SimTorpedo final {
+  TorpedoSpec spec;
+  Vec2 tube_position = { 0.0f, 0.0f };
+  Angle launch_course = Angle::FromDeg(0.0f);
+  float gyro_angle = 0.0f; // Positive is starboard, negative is port.
+  double launch_time_s = 0.0;
+
+  SimTorpedoState state = SimTorpedoState::kRunning;
+  Vec2 position = { 0.0f, 0.0f };
+  Angle heading = Angle::FromDeg(0.0f);
+  float run_distance_m = 0.0f;
+  /// Closest the torpedo came to the center of any target, in meters.
+  float closest_approach_m = 0.0f;
+  /// Target index and time of the hit, for `SimTorpedoState::kHit`.
+  std::size_t hit_target_index = 0;
+  double end_time_s = 0.0;
+};
+
+/// Fixed-timestep simulation of the ownship, the targets and the torpedoes, with a TDC solving against ground truth.
+///
+/// Everything advances in steps of `kStepS` of simulated time, regardless of the frame rate: `Advance` runs as many steps
+/// as the elapsed real time times the time compression calls for. For playing engagements forward without real time,
+/// call `Step` directly.
+///
+/// Ships move in straight lines; their positions are evaluated from where they last changed course or speed, so that no
+/// error accumulates over steps. Changes to the course, speed or position of a ship take effect from the next step.
+/// Torpedoes are stepped together by `TorpedoKinematics`; among many targets, they are checked for hits only against
+/// those near them.
+///
+/// Every step, the TDC is updated with what an observer on the ownship would take from the tracked target: its relative
+/// bearing, range, speed and angle on bow, all exact.
+class Simulation final {
+public:
+  static constexpr double kStepS = 1.0 / 240.0;
+  static constexpr float kMinTimeCompression = 1.0f;
+  static constexpr float kMaxTimeCompression = 1000.0f;
+  /// Torpedoes that run this far without a hit expire. Beyond the range of the torpedoes the TDC is used with.
+  static constexpr float kMaxTorpedoRunDistanceM = 12500.0f;
+
+  SimShip& GetOwnship() { return ownship_.ship; }
+  SimShip const& GetOwnship() const { return ownship_.ship; }
+
+  std::size_t AddTarget(SimShip const& target);
+  SimShip& GetTarget(std::size_t index) { return targets_[index].ship; }
+  SimShip const& GetTarget(std::size_t index) const { return targets_[index].ship; }
+  std::size_t GetTargetCount() const { return targets_.size(); }
+
+  std::span<SimTorpedo const> GetTorpedoes() const { return torpedoes_; }
+  /// Whether any torpedo is still running.
+  bool HasRunningTorpedo() const;
+
+  /// The target the TDC solves for every step; none by default.
+  void SetTrackedTarget(std::optional<std::size_t> target_index) { tracked_target_index_ = target_index; }
+  std::optional<std::size_t> GetTrackedTarget() const { return tracked_target_index_; }
+
+  /// Torpedo, solver and firing table of the TDC. The target and ownship members of `settings` are ignored; they come
+  /// from ground truth.
+  void SetTdcSettings(TdcInputs const& settings) { tdc_settings_ = settings; }
+  /// TDC inputs as observed on the target at `target_index` at the current time, exact.
+  TdcInputs ObserveTarget(std::size_t target_index) const;
+  /// Inverse of `ObserveTarget`: move the target at `target_index` to where the target members of `observed` put it
+  /// relative to the ownship as it is now, and set its course and speed from them.
+  void PlaceTarget(std::size_t target_index, TdcInputs const& observed);
+  /// Solved for the tracked target as of the last step.
+  TdcGraph const& GetTdc() const { return tdc_; }
+
+  /// Fire a torpedo with the parallax solution of the TDC, first brought up to date with the tracked target.
+  ///
+  /// ## Returns
+  /// `false`, firing nothing, if the TDC has no solution.
+  bool Fire();
+  /// Fire a torpedo of `torpedo_spec` set to `gyro_angle` from the ownship.
+  void Launch(TorpedoSpec const& torpedo_spec, float gyro_angle);
+
+  /// Advance by one step of `kStepS`.
+  void Step();
+
+  /// Advance by `real_elapsed_s` of real time at `time_compression`, clamped to [`kMinTimeCompression`,
+  /// `kMaxTimeCompression`], in whole steps. The remainder carries over to the next call.
+  ///
+  /// At most `max_step_count` steps run; simulated time beyond that is dropped rather than caught up with later, so a
+  /// slow frame cannot snowball.
+  ///
+  /// ## Returns
+  /// The number of steps run.
+  uint32_t Advance(double real_elapsed_s, float time_compression, uint32_t max_step_count);
+
+  double GetTime() const { return static_cast<double>(step_count_) * kStepS; }
+  uint64_t GetStepCount() const { return step_count_; }
+
+private:
+  /// A ship along with where it last changed course or speed.
+  struct TrackedShip final {
+    SimShip ship;
+    Vec2 anchor_position = { 0.0f, 0.0f };
+    Angle anchor_course = Angle::FromDeg(0.0f);
+    float anchor_speed_kn = 0.0f;
+    double anchor_time_s = 0.0;
+    Vec2 last_position = { 0.0f, 0.0f }; // As of the last step; differs from `ship.position` after it was moved.
+  };
+
+  /// Move `tracked` from `previous_time_s` to `time_s`, first taking any changes made to it as its new anchor.
+  static void MoveShip(TrackedShip& tracked, double previous_time_s, double time_s);
+
+  /// Index where the targets are, as of this step.
+  void UpdateTargetGrid();
+  /// Take the torpedo at `index` from `torpedo_kinematics_` and check it for a hit.
+  void UpdateTorpedo(std::size_t index, double time_s);
+
+  TrackedShip ownship_;
+  std::vector<TrackedShip> targets_;
+  std::vector<SimTorpedo> torpedoes_;
+  TorpedoKinematics torpedo_kinematics_ { kStepS }; // Same indices as `torpedoes_`.
+
+  // Target positions, by target index, as of this step. With few targets, checking all of them is cheaper than keeping
+  // the grid up to date, and it is left empty.
+  static constexpr float kTargetGridCellM = 250.0f;
+  static constexpr std::size_t kMinGridTargetCount = 16;
+  SpatialGrid target_grid_ { kTargetGridCellM };
+  std::vector<Vec2> target_positions_;    // Scratch.
+  float max_target_extent_m_ = 0.0f;      // Farthest any point of any waterline is from its ship's position.
+
+  std::optional<std::size_t> tracked_target_index_;
+  TdcInputs tdc_settings_;
+  TdcGraph tdc_;
+
+  uint64_t step_count_ = 0;
+  double accumulator_s_ = 0.0; // Simulated time `Advance` owes, less than one step after a call.
+};
+
+} // namespace tdc2
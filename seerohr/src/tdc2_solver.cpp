@@ -0,0 +1,636 @@
+// TU header --------------------------------------------
+#include "tdc2_solver.h"
+
+// c++ headers ------------------------------------------
+#include <cassert>
+#include <cmath>
+
+#include <algorithm>
+#include <limits>
+#include <numbers>
+
+// project headers --------------------------------------
+#include "numerical.h"
+#include "tdc2_epf.h"
+#include "tdc2_kernels.h"
+#include "tdc2_lane_math.h"
+
+namespace tdc2 {
+
+Angle ComputeAbsoluteTargetBearing(
+  Angle ownship_course,
+  Angle relative_target_bearing
+) {
+  return ownship_course + relative_target_bearing;
+}
+
+Vec2 ComputeTargetPosition(
+  Vec2 const& aiming_device_position,
+  Angle ownship_course,
+  Angle relative_target_bearing,
+  float target_range_m
+) {
+  Angle const absolute_target_bearing = ComputeAbsoluteTargetBearing(
+    ownship_course,
+    relative_target_bearing
+  );
+
+  return {
+    aiming_device_position.x + target_range_m * +(-absolute_target_bearing + Angle::RightAngle()).Cos(),
+    aiming_device_position.y + target_range_m * -(-absolute_target_bearing + Angle::RightAngle()).Sin()
+  };
+}
+
+TorpedoTriangleIntermediate TorpedoTriangle::PrepareSolve(
+  Angle ownship_course
+) const {
+  Angle const absolute_target_bearing = ComputeAbsoluteTargetBearing(
+    ownship_course,
+    this->target_bearing
+  );
+
+  Angle target_course = absolute_target_bearing + Angle::Pi() - this->angle_on_bow;
+  target_course = target_course.WrapAround();
+
+  return TorpedoTriangleIntermediate {
+    .ownship_course = ownship_course,
+    .absolute_target_bearing = absolute_target_bearing,
+    .target_course = target_course,
+  };
+}
+
+std::optional<TorpedoTriangleSolution> TorpedoTriangle::Solve(
+  TorpedoTriangleIntermediate const& interm,
+  Vec2 const& aiming_device_position
+) const {
+  assert(this->torpedo_speed_kn > 0.0f);
+
+  // No solution using torpedo triangle; target course line is identical to ownship line.
+  if (this->angle_on_bow.AsRad() == 0.0f || std::abs(this->angle_on_bow.AsRad()) == std::numbers::pi_v<float>) {
+    {
+      float target_speed_seen_from_torpedo_kn = ((this->angle_on_bow.AsRad() == 0.0f) ? -this->target_speed_kn : this->target_speed_kn) - this->torpedo_speed_kn;
+
+      if (target_speed_seen_from_torpedo_kn >= 0.0f){
+        // No solution; the target is too fast for the torpedo to ever catch up.
+        return std::nullopt;
+      }
+    }
+
+    // Closing: Positive
+    // Moving away: Negative
+    float signed_target_speed_kn = (this->angle_on_bow.AsRad() == 0.0f) ? this->target_speed_kn : -this->target_speed_kn;
+
+    float torpedo_time_to_target_s = this->target_range_m / ((this->torpedo_speed_kn + signed_target_speed_kn) * 1852.0f / 3600.0f);
+    float torpedo_run_distance_m = (this->torpedo_speed_kn * 1852.0f / 3600.0f) * torpedo_time_to_target_s;
+
+    float const impact_angle = (interm.absolute_target_bearing - Angle::RightAngle()).AsRad();
+    Vec2 const impact_position = aiming_device_position + Vec2 {
+      torpedo_run_distance_m * lane::Cos(impact_angle),
+      torpedo_run_distance_m * lane::Sin(impact_angle)
+    };
+
+    Angle const pseudo_torpedo_gyro_angle = this->target_bearing;
+
+    return TorpedoTriangleSolution {
+      .target_course = interm.target_course,
+      .lead_angle = Angle(0.0f),
+      .intercept_angle = signed_target_speed_kn >= 0.0f ? Angle::Pi() : Angle(0.0f),
+      .torpedo_time_to_target_s = torpedo_time_to_target_s,
+      .pseudo_torpedo_gyro_angle = pseudo_torpedo_gyro_angle,
+      .impact_position = impact_position,
+    };
+  }
+
+  // Try to solve using torpedo triangle.
+
+  float const abs_angle_on_bow = this->angle_on_bow.Abs().AsRad();
+
+  TorpedoTriangleCore<float> core = SolveTorpedoTriangleCore<float>(
+    this->torpedo_speed_kn, this->target_speed_kn, this->target_range_m, abs_angle_on_bow
+  );
+  if (IsTorpedoTriangleIllConditioned(core.sin_abs_angle_on_bow, core.sin_lead_angle, core.sin_intercept_angle)) {
+    // Float rounding dominates this triangle; solve it again in double.
+    TorpedoTriangleCore<double> const refined = SolveTorpedoTriangleCore<double>(
+      this->torpedo_speed_kn, this->target_speed_kn, this->target_range_m, abs_angle_on_bow
+    );
+    core = TorpedoTriangleCore<float> {
+      .valid = refined.valid,
+      .sin_abs_angle_on_bow = static_cast<float>(refined.sin_abs_angle_on_bow),
+      .sin_lead_angle = static_cast<float>(refined.sin_lead_angle),
+      .lead_angle = static_cast<float>(refined.lead_angle),
+      .intercept_angle = static_cast<float>(refined.intercept_angle),
+      .sin_intercept_angle = static_cast<float>(refined.sin_intercept_angle),
+      .torpedo_run_distance_m = static_cast<float>(refined.torpedo_run_distance_m),
+    };
+  }
+  if (!core.valid) {
+    // No solution; target is too fast leaving no valid lead angle for given torpedo speed and target course.
+    // NOTE: sin_lead_angle == 0.0f is only possible when `this->target_speed_kn` or `this->angle_on_bow` is zero.
+    return std::nullopt;
+  }
+
+  assert(0.0f <= core.sin_lead_angle && core.sin_lead_angle <= 1.0f);
+
+  Angle const lead_angle = Angle(core.lead_angle);
+  Angle const intercept_angle = Angle(core.intercept_angle);
+  float const torpedo_run_distance_m = core.torpedo_run_distance_m;
+
+  float torpedo_time_to_target_s = 0.0f;
+  {
+    float torpedo_speed_mps = this->torpedo_speed_kn * 1852.0f / 3600.0f;
+
+    torpedo_time_to_target_s = torpedo_run_distance_m / torpedo_speed_mps;
+  }
+
+  Angle const torpedo_course = interm.absolute_target_bearing + (this->angle_on_bow.Sign() * lead_angle);
+  Angle const pseudo_torpedo_gyro_angle = torpedo_course - interm.ownship_course;
+
+  // `- Angle::RightAngle()` corrects for coordinate space difference.
+  float const impact_angle = (torpedo_course - Angle::RightAngle()).AsRad();
+  Vec2 const impact_position = aiming_device_position + Vec2 {
+    torpedo_run_distance_m * lane::Cos(impact_angle),
+    torpedo_run_distance_m * lane::Sin(impact_angle)
+  };
+
+  return TorpedoTriangleSolution {
+    .target_course = interm.target_course,
+    .lead_angle = lead_angle,
+    .intercept_angle = intercept_angle,
+    .torpedo_time_to_target_s = torpedo_time_to_target_s,
+    .pseudo_torpedo_gyro_angle = pseudo_torpedo_gyro_angle,
+    .impact_position = impact_position,
+  };
+}
+
+namespace {
+
+using lane::WrapPi;
+
+/// Fill in `out_pc_solution` from the converged state of a parallax correction iteration.
+///
+/// `e_to_t` and `epf_offset` are evaluated at the rho for which the iteration declared convergence; `rho` is the final gyro angle.
+template <typename Spec>
+void WriteParallaxCorrectionSolution(
+  Spec const& torpedo_spec,
+  Vec2 const& aiming_device_position,
+  float ownship_course_rad,
+  Vec2 const& epf_offset,
+  Vec2 const& e_to_t,
+  float delta,
+  float rho,
+  float gamma2,
+  float beta2,
+  float speed_ratio,
+  uint32_t iterations,
+  ParallaxCorrectionSolution& out_pc_solution
+) {
+  float const los2 = e_to_t.Length();
+  float const torpedo_run_distance_m = ComputeParallaxRunDistanceMixed(los2, gamma2, beta2, speed_ratio);
+
+  float const torpedo_speed_mps = torpedo_spec.speed_kn * 1852.0f / 3600.0f;
+  float const torpedo_time_to_target_s = torpedo_run_distance_m / torpedo_speed_mps;
+
+  Vec2 const e = aiming_device_position + epf_offset.Rotate(ownship_course_rad - std::numbers::pi_v<float> / 2.0f);
+  Vec2 const impact_position = e + Vec2 {
+    torpedo_run_distance_m * std::cos(ownship_course_rad - std::numbers::pi_v<float> / 2.0f + rho),
+    torpedo_run_distance_m * std::sin(ownship_course_rad - std::numbers::pi_v<float> / 2.0f + rho)
+  };
+
+  out_pc_solution.delta = delta;
+  out_pc_solution.rho = rho;
+  out_pc_solution.gamma = gamma2;
+  out_pc_solution.beta = beta2;
+  out_pc_solution.epf_offset = epf_offset;
+  out_pc_solution.torpedo_run_distance_m = torpedo_run_distance_m;
+  out_pc_solution.torpedo_time_to_target_s = torpedo_time_to_target_s;
+  out_pc_solution.impact_position = impact_position;
+  out_pc_solution.iterations = iterations;
+}
+
+} // namespace
+
+bool ParallaxCorrectionSolver::Solve(
+  ParallaxSolveMethod method,
+  TorpedoSpec const& torpedo_spec,
+  TorpedoTriangle const& triangle,
+  float rho0,
+  Vec2 const& aiming_device_position,
+  float ownship_course_rad,
+  ParallaxCorrectionSolution& out_pc_solution,
+  EquivalentPointOfFireCurve const* epf_curve
+) {
+  switch (method) {
+  case ParallaxSolveMethod::kGeometry:
+    return SolveByGeometry(torpedo_spec, triangle, rho0, aiming_device_position, ownship_course_rad, out_pc_solution, epf_curve);
+  case ParallaxSolveMethod::kNewton:
+    return SolveByNewton(torpedo_spec, triangle, rho0, aiming_device_position, ownship_course_rad, out_pc_solution, epf_curve);
+  case ParallaxSolveMethod::kSiemens:
+    return SolveSiemens(torpedo_spec, triangle, rho0, aiming_device_position, ownship_course_rad, out_pc_solution, epf_curve);
+  }
+  return false;
+}
+
+bool ParallaxCorrectionSolver::SolveByGeometry(
+  TorpedoSpec const& torpedo_spec,
+  TorpedoTriangle const& triangle,
+  float rho0,
+  Vec2 const& aiming_device_position,
+  float ownship_course_rad,
+  ParallaxCorrectionSolution& out_pc_solution,
+  EquivalentPointOfFireCurve const* epf_curve
+) {
+  return VisitTorpedoSpec(torpedo_spec, [&](auto const& spec) {
+    return SolveByGeometryWith(spec, triangle, rho0, aiming_device_position, ownship_course_rad, out_pc_solution, epf_curve);
+  });
+}
+
+template <typename Spec>
+bool ParallaxCorrectionSolver::SolveByGeometryWith(
+  Spec const& torpedo_spec,
+  TorpedoTriangle const& triangle,
+  float rho0,
+  Vec2 const& aiming_device_position,
+  float ownship_course_rad,
+  ParallaxCorrectionSolution& out_pc_solution,
+  EquivalentPointOfFireCurve const* epf_curve
+) {
+  // Target range, as observed from the aiming device.
+  float const los = triangle.target_range_m;
+
+  // Signed target bearing.
+  float const omega1 = triangle.target_bearing.AsRad();
+
+  // Signed angle on bow.
+  float const gamma1 = triangle.angle_on_bow.AsRad();
+
+  // Target position, as observed from the aiming device.
+  Vec2 const T { los * lane::Cos(omega1), los * lane::Sin(omega1) };
+
+  auto compute_epf_offset = [&torpedo_spec, epf_curve](float rho) -> Vec2 {
+    return (epf_curve != nullptr) ? epf_curve->Evaluate(rho) : ComputeEquivalentPointOfFireOffset(torpedo_spec, rho);
+  };
+
+  float rho = rho0; // Initialize with initial guess for rho.
+
+  float min_step = std::numeric_limits<float>::infinity();
+  uint32_t stall_iterations = 0;
+
+  for (uint32_t i = 0; i < kIters; ++i) {
+    // Relative to ownship course.
+    Vec2 const epf_offset = compute_epf_offset(rho);
+
+    Vec2 const e_to_t = T - epf_offset;
+
+    // Target bearing, as observed from this equivalent point of fire.
+    float const omega2 = lane::Atan2(e_to_t.y, e_to_t.x);
+
+    // Parallax correction delta.
+    float const delta = WrapPi(omega1 - omega2);
+
+    // Signed angle on bow, as observed from the equivalent point of fire.
+    float const gamma2 = WrapPi(gamma1 - delta);
+
+    // Lead angle as seen from the equivalent point of fire.
+    float beta2 = 0.0f;
+    {
+      float sin_beta = (triangle.target_speed_kn / torpedo_spec.speed_kn) * lane::Sin(gamma2);
+
+      if (sin_beta < -1.0f || 1.0f < sin_beta) {
+        // No solution; target is too fast leaving no valid lead angle for given torpedo speed and target course.
+        return false;
+      }
+
+      beta2 = lane::Asin(sin_beta);
+    }
+
+    // Desired rho.
+    float const rho_target = WrapPi(omega2 + beta2);
+
+    // Relaxed update on the circle.
+    float const step = WrapPi(rho_target - rho);
+    rho = WrapPi(rho + kLambda * step);
+
+    if (std::abs(step) < kTolerance) {
+      // Converged.
+      WriteParallaxCorrectionSolution(
+        torpedo_spec, aiming_device_position, ownship_course_rad,
+        epf_offset, e_to_t, delta, rho, gamma2, beta2, triangle.target_speed_kn / torpedo_spec.speed_kn, i + 1,
+        out_pc_solution
+      );
+      return true;
+    }
+
+    // Cycling instead of contracting; see `kStallIters`.
+    stall_iterations = (std::abs(step) < min_step) ? 0 : stall_iterations + 1;
+    min_step = std::min(min_step, std::abs(step));
+    if (kStallIters <= stall_iterations) {
+      return false;
+    }
+  }
+
+  // No convergence.
+  return false;
+}
+
+template bool ParallaxCorrectionSolver::SolveByGeometryWith(
+  TorpedoSpec const&, TorpedoTriangle const&, float, Vec2 const&, float, ParallaxCorrectionSolution&, EquivalentPointOfFireCurve const*
+);
+template bool ParallaxCorrectionSolver::SolveByGeometryWith(
+  PresetTorpedoSpec<TorpedoPreset::kG7a> const&, TorpedoTriangle const&, float, Vec2 const&, float, ParallaxCorrectionSolution&, EquivalentPointOfFireCurve const*
+);
+template bool ParallaxCorrectionSolver::SolveByGeometryWith(
+  PresetTorpedoSpec<TorpedoPreset::kG7e> const&, TorpedoTriangle const&, float, Vec2 const&, float, ParallaxCorrectionSolution&, EquivalentPointOfFireCurve const*
+);
+
+bool ParallaxCorrectionSolver::SolveByNewton(
+  TorpedoSpec const& torpedo_spec,
+  TorpedoTriangle const& triangle,
+  float rho0,
+  Vec2 const& aiming_device_position,
+  float ownship_course_rad,
+  ParallaxCorrectionSolution& out_pc_solution,
+  EquivalentPointOfFireCurve const* epf_curve
+) {
+  // Largest Newton step, in radians. Keeps the first steps from a poor initial guess on the same branch of the solution.
+  constexpr float kMaxStep = 0.5f;
+  // Below this |H'(rho)| the Newton step is unreliable and the relaxed fixed-point step is taken instead.
+  constexpr float kMinSlope = 0.05f;
+
+  float const los = triangle.target_range_m;
+  float const omega1 = triangle.target_bearing.AsRad();
+  float const gamma1 = triangle.angle_on_bow.AsRad();
+  float const speed_ratio = triangle.target_speed_kn / torpedo_spec.speed_kn;
+
+  Vec2 const T { los * std::cos(omega1), los * std::sin(omega1) };
+
+  auto compute_epf_offset = [&torpedo_spec, epf_curve](float rho) -> Vec2 {
+    return (epf_curve != nullptr) ? epf_curve->Evaluate(rho) : torpedo_spec.ComputeEquivalentPointOfFireOffset(rho);
+  };
+  auto compute_epf_offset_derivative = [&torpedo_spec, epf_curve](float rho) -> Vec2 {
+    return (epf_curve != nullptr) ? epf_curve->EvaluateDerivative(rho) : torpedo_spec.ComputeEquivalentPointOfFireOffsetDerivative(rho);
+  };
+
+  float rho = rho0;
+
+  // Solve H(rho) = rho_target(rho) - rho = 0, where rho_target is the gyro angle the torpedo triangle asks for
+  // when fired from the equivalent point of fire belonging to rho.
+  for (uint32_t i = 0; i < kIters; ++i) {
+    Vec2 const epf_offset = compute_epf_offset(rho);
+    Vec2 const d_epf_offset = compute_epf_offset_derivative(rho);
+
+    Vec2 const e_to_t = T - epf_offset;
+
+    float const omega2 = std::atan2(e_to_t.y, e_to_t.x);
+    float const delta = WrapPi(omega1 - omega2);
+    float const gamma2 = WrapPi(gamma1 - delta);
+
+    float const sin_gamma2 = std::sin(gamma2);
+    float const sin_beta = speed_ratio * sin_gamma2;
+    if (sin_beta < -1.0f || 1.0f < sin_beta) {
+      // No solution; target is too fast leaving no valid lead angle for given torpedo speed and target course.
+      return false;
+    }
+    float const beta2 = std::asin(sin_beta);
+
+    float const h = WrapPi(WrapPi(omega2 + beta2) - rho);
+
+    if (std::abs(h) < kTolerance) {
+      // Converged.
+      WriteParallaxCorrectionSolution(
+        torpedo_spec, aiming_device_position, ownship_course_rad,
+        epf_offset, e_to_t, delta, rho, gamma2, beta2, triangle.target_speed_kn / torpedo_spec.speed_kn, i + 1,
+        out_pc_solution
+      );
+      return true;
+    }
+
+    // dω2/dρ: The line of sight from the equivalent point of fire turns as the equivalent point of fire moves.
+    float const los2_sq = e_to_t.x * e_to_t.x + e_to_t.y * e_to_t.y;
+    float const d_omega2 = (e_to_t.y * d_epf_offset.x - e_to_t.x * d_epf_offset.y) / los2_sq;
+
+    // dβ2/dρ, with dγ2/dρ = dω2/dρ.
+    float d_beta2 = 0.0f;
+    {
+      float const cos_beta_sq = 1.0f - sin_beta * sin_beta;
+      if (0.0f < cos_beta_sq) {
+        d_beta2 = speed_ratio * std::cos(gamma2) * d_omega2 / std::sqrt(cos_beta_sq);
+      }
+    }
+
+    float const dh = d_omega2 + d_beta2 - 1.0f;
+
+    float step = 0.0f;
+    if (std::abs(dh) < kMinSlope || !std::isfinite(dh)) {
+      step = kLambda * h;
+    }
+    else {
+      step = std::clamp(-h / dh, -kMaxStep, kMaxStep);
+    }
+
+    rho = WrapPi(rho + step);
+  }
+
+  // No convergence.
+  return false;
+}
+
+bool ParallaxCorrectionSolver::ComputeSolutionAt(
+  TorpedoSpec const& torpedo_spec,
+  TorpedoTriangle const& triangle,
+  float rho,
+  Vec2 const& aiming_device_position,
+  float ownship_course_rad,
+  ParallaxCorrectionSolution& out_pc_solution,
+  EquivalentPointOfFireCurve const* epf_curve
+) {
+  float const los = triangle.target_range_m;
+  float const omega1 = triangle.target_bearing.AsRad();
+  float const gamma1 = triangle.angle_on_bow.AsRad();
+
+  Vec2 const T { los * std::cos(omega1), los * std::sin(omega1) };
+
+  Vec2 const epf_offset = (epf_curve != nullptr) ? epf_curve->Evaluate(rho) : torpedo_spec.ComputeEquivalentPointOfFireOffset(rho);
+  Vec2 const e_to_t = T - epf_offset;
+
+  float const omega2 = std::atan2(e_to_t.y, e_to_t.x);
+  float const delta = WrapPi(omega1 - omega2);
+  float const gamma2 = WrapPi(gamma1 - delta);
+
+  float const sin_beta = (triangle.target_speed_kn / torpedo_spec.speed_kn) * std::sin(gamma2);
+  if (sin_beta < -1.0f || 1.0f < sin_beta) {
+    return false;
+  }
+  float const beta2 = std::asin(sin_beta);
+
+  WriteParallaxCorrectionSolution(
+    torpedo_spec, aiming_device_position, ownship_course_rad,
+    epf_offset, e_to_t, delta, rho, gamma2, beta2, triangle.target_speed_kn / torpedo_spec.speed_kn, 0,
+    out_pc_solution
+  );
+  return true;
+}
+
+bool ParallaxCorrectionSolver::SolveSiemens(
+  TorpedoSpec const& torpedo_spec,
+  TorpedoTriangle const& triangle,
+  float rho0,
+  Vec2 const& aiming_device_position,
+  float ownship_course_rad,
+  ParallaxCorrectionSolution& out_pc_solution,
+  EquivalentPointOfFireCurve const* epf_curve
+) {
+  // Initial half width of the bracket search around the starting point, in radians (~1.8°); doubled every step.
+  constexpr float kInitialStep = 1.0f / 32.0f;
+  // Largest |H| accepted at a root; rejects the jump of H where ρ crosses ±π and the turn direction flips.
+  constexpr float kMaxResidual = 1e-4f;
+
+  constexpr float kPi = std::numbers::pi_v<float>;
+  constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+
+  // e: Target range, as observed from the aiming device.
+  float const e = triangle.target_range_m;
+  // ω: Signed target bearing.
+  float const omega1 = triangle.target_bearing.AsRad();
+  // Signed angle on bow.
+  float const gamma1 = triangle.angle_on_bow.AsRad();
+  float const speed_ratio = triangle.target_speed_kn / torpedo_spec.speed_kn;
+
+  Vec2 const T { e * std::cos(omega1), e * std::sin(omega1) };
+
+  auto compute_epf_offset = [&torpedo_spec, epf_curve](float rho) -> Vec2 {
+    return (epf_curve != nullptr) ? epf_curve->Evaluate(rho) : torpedo_spec.ComputeEquivalentPointOfFireOffset(rho);
+  };
+
+  // ρ(Δ), or NaN if the target is too fast as seen from the equivalent point of fire.
+  auto compute_rho = [&](float delta) -> float {
+    float const sin_beta = speed_ratio * std::sin(gamma1 - delta);
+    if (sin_beta < -1.0f || 1.0f < sin_beta) {
+      return kNaN;
+    }
+    return WrapPi(omega1 - delta + std::asin(sin_beta));
+  };
+
+  uint32_t evaluation_count = 0;
+  auto evaluate = [&](float delta) -> float {
+    ++evaluation_count;
+
+    float const rho = compute_rho(delta);
+    if (std::isnan(rho)) {
+      return kNaN;
+    }
+    Vec2 const epf_offset = compute_epf_offset(rho);
+
+    float const f = epf_offset.Length() / e;
+    float const g = std::atan2(epf_offset.y, epf_offset.x) - omega1;
+    return std::sin(delta) - f * std::sin(delta + g);
+  };
+
+  // Whether the root `delta` is a solution: The target must be ahead on the line of sight from the equivalent point of
+  // fire, rather than behind it, and H must not merely jump across zero.
+  auto is_valid_root = [&](float delta) -> bool {
+    float const rho = compute_rho(delta);
+    if (std::isnan(rho)) {
+      return false;
+    }
+    Vec2 const e_to_t = T - compute_epf_offset(rho);
+    float const omega2 = omega1 - delta;
+    if (e_to_t.x * std::cos(omega2) + e_to_t.y * std::sin(omega2) <= 0.0f) {
+      return false;
+    }
+    return std::abs(evaluate(delta)) <= kMaxResidual;
+  };
+
+  RootFindingOptions const root_finding_options {
+    .method = RootFindingMethod::kBrent,
+    .tolerance = kTolerance,
+    .max_iterations = kIters,
+  };
+
+  // Start from the parallax correction for which ρ(Δ) = `rho0`, i.e. zero for the pseudo gyro angle.
+  float delta0 = 0.0f;
+  {
+    float const sin_beta = speed_ratio * std::sin(gamma1);
+    if (-1.0f <= sin_beta && sin_beta <= 1.0f) {
+      delta0 = WrapPi(omega1 + std::asin(sin_beta) - rho0);
+    }
+  }
+
+  std::optional<float> root;
+
+  // Step outwards on both sides until H changes sign, then refine; the first valid root is the one closest to `delta0`.
+  {
+    float const f0 = evaluate(delta0);
+    float lo = delta0;
+    float hi = delta0;
+    float flo = f0;
+    float fhi = f0;
+    if (f0 == 0.0f && is_valid_root(delta0)) {
+      root = delta0;
+    }
+
+    for (float step = kInitialStep; !root.has_value() && (-kPi < lo || hi < kPi); step *= 2.0f) {
+      if (hi < kPi) {
+        float const next = std::min(delta0 + step, kPi);
+        float const fnext = evaluate(next);
+        if (std::isfinite(fhi) && std::isfinite(fnext) && fhi * fnext <= 0.0f) {
+          std::optional<float> const candidate = FindRootInBracket(evaluate, hi, next, fhi, fnext, root_finding_options);
+          if (candidate.has_value() && is_valid_root(candidate.value())) {
+            root = candidate;
+          }
+        }
+        hi = next;
+        fhi = fnext;
+      }
+      if (!root.has_value() && -kPi < lo) {
+        float const next = std::max(delta0 - step, -kPi);
+        float const fnext = evaluate(next);
+        if (std::isfinite(flo) && std::isfinite(fnext) && flo * fnext <= 0.0f) {
+          std::optional<float> const candidate = FindRootInBracket(evaluate, next, lo, fnext, flo, root_finding_options);
+          if (candidate.has_value() && is_valid_root(candidate.value())) {
+            root = candidate;
+          }
+        }
+        lo = next;
+        flo = fnext;
+      }
+    }
+  }
+
+  // The doubling steps can straddle a pair of roots; fall back to a full scan.
+  if (!root.has_value()) {
+    RootSet<8> const roots = FindRoots<8>(evaluate, -kPi, kPi, root_finding_options);
+    for (float candidate : roots) {
+      if (!is_valid_root(candidate)) {
+        continue;
+      }
+      if (!root.has_value() || std::abs(WrapPi(compute_rho(candidate) - rho0)) < std::abs(WrapPi(compute_rho(root.value()) - rho0))) {
+        root = candidate;
+      }
+    }
+  }
+
+  if (!root.has_value()) {
+    return false;
+  }
+
+  if (!ComputeSolutionAt(torpedo_spec, triangle, compute_rho(root.value()), aiming_device_position, ownship_course_rad, out_pc_solution, epf_curve)) {
+    return false;
+  }
+  out_pc_solution.iterations = evaluation_count;
+  return true;
+}
+
+Vec2 TorpedoSpec::ComputeEquivalentPointOfFireOffset(float rho) const {
+  return tdc2::ComputeEquivalentPointOfFireOffset(*this, rho);
+}
+
+Vec2 TorpedoSpec::ComputeEquivalentPointOfFireOffsetDerivative(float rho) const {
+  // With a = |rho| and L(a) = turn_radius * a + reach, the curve above has dx/da = L * sin(a) and dy/da = -L * cos(a).
+  // Folding in d|rho|/drho and the port sign flip gives the same expression on both sides of rho = 0.
+  float const abs_rho = std::abs(rho);
+  float const arm = this->turn_radius * abs_rho + this->reach;
+
+  return { arm * std::sin(rho), -arm * std::cos(rho) };
+}
+
+} // namespace tdc2
@@ -0,0 +1,272 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cstdint>
+
+#include <optional>
+
+// project headers --------------------------------------
+#include "angle.h"
+#include "vec2.h"
+
+namespace tdc2 {
+
+struct TorpedoSpec final {
+  /// Distance in meters from the aiming device to the torpedo tube.
+  float distance_to_tube = 27.0f;
+  /// Initial straight run in meters; distance the torpedo runs straight ahead before starting to turn.
+  float reach = 9.5f;
+  /// Turn radius of the torpedo in meters.
+  float turn_radius = 95.0f;
+  /// Speed of the torpedo in knots.
+  float speed_kn = 30.0f;
+
+  /// Compute the offset to the equivalent point of fire, or ideeller Torpedoeintrittsort as it is called in German.
+  ///
+  /// * `rho`: Gyro angle, or Schusswinkel, for which to compute the equivalent point of fire offset. Positive is starboard, negative is port.
+  ///
+  /// ## Returns
+  /// Positive X is forward along the torpedo's initial course, positive Y is to starboard. The point lies on the side
+  /// opposite the turn.
+  Vec2 ComputeEquivalentPointOfFireOffset(float rho) const;
+
+  /// Derivative of `ComputeEquivalentPointOfFireOffset` with respect to `rho`, in meters per radian.
+  Vec2 ComputeEquivalentPointOfFireOffsetDerivative(float rho) const;
+
+  bool operator==(TorpedoSpec const&) const = default;
+};
+
+enum class TorpedoPreset {
+  /// G7a (T I): Steam-driven torpedo, at its 44 kn setting.
+  kG7a,
+  /// G7e (T II, T III): Electric torpedo, 30 kn.
+  kG7e,
+};
+
+/// `TorpedoSpec` of `preset` fired from a bow tube. The presets share the gyro steering geometry and differ in speed.
+constexpr TorpedoSpec GetTorpedoPresetSpec(TorpedoPreset preset) {
+  TorpedoSpec spec;
+  switch (preset) {
+  case TorpedoPreset::kG7a:
+    spec.speed_kn = 44.0f;
+    break;
+  case TorpedoPreset::kG7e:
+    spec.speed_kn = 30.0f;
+    break;
+  }
+  return spec;
+}
+
+/// `TorpedoSpec` of `kPreset` as compile-time constants, for the solvers that take the spec as a template parameter.
+/// Members have the names of those of `TorpedoSpec`, so the same code reads either; with this one, they fold.
+template <TorpedoPreset kPreset>
+struct PresetTorpedoSpec final {
+  static constexpr TorpedoSpec kSpec = GetTorpedoPresetSpec(kPreset);
+
+  static constexpr float distance_to_tube = kSpec.distance_to_tube;
+  static constexpr float reach = kSpec.reach;
+  static constexpr float turn_radius = kSpec.turn_radius;
+  static constexpr float speed_kn = kSpec.speed_kn;
+};
+
+/// Call `visitor` with the `PresetTorpedoSpec` equal to `torpedo_spec`, or with `torpedo_spec` itself if it is not a preset.
+template <typename Visitor>
+decltype(auto) VisitTorpedoSpec(TorpedoSpec const& torpedo_spec, Visitor&& visitor) {
+  if (torpedo_spec == GetTorpedoPresetSpec(TorpedoPreset::kG7e)) {
+    return visitor(PresetTorpedoSpec<TorpedoPreset::kG7e> {});
+  }
+  if (torpedo_spec == GetTorpedoPresetSpec(TorpedoPreset::kG7a)) {
+    return visitor(PresetTorpedoSpec<TorpedoPreset::kG7a> {});
+  }
+  return visitor(torpedo_spec);
+}
+
+class EquivalentPointOfFireCurve;
+
+struct TorpedoTriangleIntermediate final {
+  Angle ownship_course = Angle(0.0f);
+  Angle absolute_target_bearing = Angle(0.0f);
+  Angle target_course = Angle(0.0f);
+};
+
+struct TorpedoTriangleSolution final {
+  Angle target_course = Angle::FromDeg(0.0f);
+  Angle lead_angle = Angle::FromDeg(0.0f);
+  Angle intercept_angle = Angle::FromDeg(0.0f);
+  float torpedo_time_to_target_s = 0.0f;
+  Angle pseudo_torpedo_gyro_angle = Angle::FromDeg(0.0f); // Signed: Positive is starboard, negative is port.
+  Vec2 impact_position = { 0.0f, 0.0f }; // Note no parallax correction applied.
+};
+
+struct ParallaxCorrectionSolution final {
+  float delta = 0.0f; // Parallax correction angle, or Winkelparallaxverbesserung.
+  float rho = 0.0f;   // Final torpedo gyro angle, or Schusswinkel.
+  float gamma = 0.0f; // γ = θ1 - Δ: Angle on bow as seen from the equivalent point of fire.
+  float beta = 0.0f;  // β: Lead angle as seen from the equivalent point of fire.
+  Vec2 epf_offset {};
+
+  float torpedo_run_distance_m = 0.0f;
+  float torpedo_time_to_target_s = 0.0f;
+
+  Vec2 impact_position = { 0.0f, 0.0f };
+
+  uint32_t iterations = 0; // Iterations the solver needed to converge.
+};
+
+enum class ParallaxSolveMethod {
+  /// Relaxed fixed-point iteration on the geometry; converges linearly.
+  kGeometry,
+  /// Newton's method using the analytic derivative of the equivalent point of fire offset; converges quadratically.
+  kNewton,
+  /// Bracketed root of the Siemens formulation H(Δ) using Brent's method; converges superlinearly.
+  kSiemens,
+};
+
+Angle ComputeAbsoluteTargetBearing(
+  Angle ownship_course,
+  Angle relative_target_bearing
+);
+
+Vec2 ComputeTargetPosition(
+  Vec2 const& aiming_device_position,
+  Angle ownship_course,
+  Angle relative_target_bearing,
+  float target_range_m
+);
+
+struct TorpedoTriangle final {
+  float torpedo_speed_kn = 0.0f;
+  Angle target_bearing = Angle::FromDeg(0.0f);
+  float target_range_m = 0.0f;
+  float target_speed_kn = 0.0f;
+
+  Angle angle_on_bow = Angle::FromDeg(0.0f); // Signed: Positive is starboard, negative is port.
+
+  TorpedoTriangleIntermediate PrepareSolve(
+    Angle ownship_course
+  ) const;
+
+  std::optional<TorpedoTriangleSolution> Solve(
+    TorpedoTriangleIntermediate const& interm,
+    Vec2 const& aiming_device_position
+  ) const;
+};
+
+struct ParallaxCorrectionSolver final {
+  static constexpr uint32_t kIters = 64;      // Maximum number of fixed-point iterations.
+  static constexpr float kTolerance = 1e-6f;  // Convergence threshold on the unrelaxed step, in radians.
+  static constexpr float kLambda = 0.6f;      // Relaxation factor of the fixed-point update.
+  static constexpr uint32_t kStallIters = 16; // Geometric iteration: Iterations without a new smallest step before giving up.
+
+  /// Solve for the parallax correction using `method`. See the individual methods for the parameters.
+  static bool Solve(
+    ParallaxSolveMethod method,
+    TorpedoSpec const& torpedo_spec,
+    TorpedoTriangle const& triangle,
+    float rho0,
+    Vec2 const& aiming_device_position,
+    float ownship_course_rad,
+    ParallaxCorrectionSolution& out_pc_solution,
+    EquivalentPointOfFireCurve const* epf_curve = nullptr
+  );
+
+  /// Solve for the parallax correction using geometric iteration.
+  ///
+  /// This method iteratively refines the parallax correction angle (delta) using geometric relationships.
+  /// It uses the initial guess (`rho0`) and the observed target position to compute the correction.
+  ///
+  /// Gives up once the step has not reached a new low in `kStallIters` iterations: Where the relaxed update does not
+  /// contract, it settles into a cycle instead, and would only run out of iterations.
+  ///
+  /// ## Parameters
+  /// - `rho0`: Initial guess for the torpedo gyro angle (Schusswinkel) in radians.
+  /// - `aiming_device_position`: For computing the parallax-corrected impact position.
+  /// - `ownship_course_rad`: The course of the ownship in radians.
+  /// - `epf_curve`: If given, the precomputed equivalent point of fire curve of `torpedo_spec` to evaluate instead of the closed form.
+  ///
+  /// Specs equal to a preset take the `PresetTorpedoSpec` instantiation of `SolveByGeometryWith`.
+  static bool SolveByGeometry(
+    TorpedoSpec const& torpedo_spec,
+    TorpedoTriangle const& triangle,
+    float rho0,
+    Vec2 const& aiming_device_position,
+    float ownship_course_rad,
+    ParallaxCorrectionSolution& out_pc_solution,
+    EquivalentPointOfFireCurve const* epf_curve = nullptr
+  );
+
+  /// `SolveByGeometry` for `Spec`, either `TorpedoSpec` or a `PresetTorpedoSpec`. Results are bit-identical for equal specs.
+  /// Instantiated for those types in tdc2_solver.cpp.
+  template <typename Spec>
+  static bool SolveByGeometryWith(
+    Spec const& torpedo_spec,
+    TorpedoTriangle const& triangle,
+    float rho0,
+    Vec2 const& aiming_device_position,
+    float ownship_course_rad,
+    ParallaxCorrectionSolution& out_pc_solution,
+    EquivalentPointOfFireCurve const* epf_curve = nullptr
+  );
+
+  /// Solve for the parallax correction using Newton's method.
+  ///
+  /// Finds the root of H(ρ) = ρ_target(ρ) - ρ, the residual of the fixed point `SolveByGeometry` iterates towards, using the
+  /// analytic derivative of the equivalent point of fire offset. Converges to the same solution within the same tolerance,
+  /// typically in a handful of iterations. Parameters are the same as for `SolveByGeometry`.
+  ///
+  /// Near |ρ| = 180°, where both a port and a starboard turn reach the target, it may settle on the other turn direction.
+  static bool SolveByNewton(
+    TorpedoSpec const& torpedo_spec,
+    TorpedoTriangle const& triangle,
+    float rho0,
+    Vec2 const& aiming_device_position,
+    float ownship_course_rad,
+    ParallaxCorrectionSolution& out_pc_solution,
+    EquivalentPointOfFireCurve const* epf_curve = nullptr
+  );
+
+  /// Fill in the parallax correction solution for a known final gyro angle `rho`, e.g. one taken from a firing table,
+  /// without iterating. `out_pc_solution.iterations` is zero. Other parameters are the same as for `SolveByGeometry`.
+  ///
+  /// ## Returns
+  /// `false` if the target is too fast to be reached from the equivalent point of fire belonging to `rho`.
+  static bool ComputeSolutionAt(
+    TorpedoSpec const& torpedo_spec,
+    TorpedoTriangle const& triangle,
+    float rho,
+    Vec2 const& aiming_device_position,
+    float ownship_course_rad,
+    ParallaxCorrectionSolution& out_pc_solution,
+    EquivalentPointOfFireCurve const* epf_curve = nullptr
+  );
+
+  /// Solve for the parallax correction as in the Siemens patent of 1944, finding the root of
+  ///
+  ///  H(Δ) = sin Δ - F(Δ) * sin(Δ + G(Δ))
+  ///
+  /// where:
+  ///  F(Δ) = X(ρ) / e
+  ///  G(Δ) = θ(ρ) - ω
+  ///  X(ρ), θ(ρ): Distance and direction of the equivalent point of fire from the aiming device.
+  ///  ρ = ω - Δ + β(Δ)
+  ///
+  /// H(Δ) = 0 states that the target lies on the line of sight from the equivalent point of fire. The patent writes Δ for
+  /// sin Δ, which is its small angle approximation; the exact form converges to the same solution as `SolveByGeometry`.
+  ///
+  /// The root is bracketed by stepping outwards from the parallax correction that belongs to `rho0`, and refined with
+  /// Brent's method; if that finds no valid root, all of [-π, π] is scanned and the root closest to `rho0` is taken.
+  /// Near ρ = ±π, where both turn directions can solve the triangle, this may settle on the other solution than
+  /// `SolveByGeometry`.
+  /// `out_pc_solution.iterations` counts evaluations of H. Parameters are the same as for `SolveByGeometry`.
+  static bool SolveSiemens(
+    TorpedoSpec const& torpedo_spec,
+    TorpedoTriangle const& triangle,
+    float rho0,
+    Vec2 const& aiming_device_position,
+    float ownship_course_rad,
+    ParallaxCorrectionSolution& out_pc_solution,
+    EquivalentPointOfFireCurve const* epf_curve = nullptr
+  );
+};
+
+} // namespace tdc2
@@ -0,0 +1,158 @@
+// TU header --------------------------------------------
+#include "tdc2_spatial.h"
+
+// c++ headers ------------------------------------------
+#include <cassert>
+#include <cmath>
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace tdc2 {
+
+namespace {
+
+/// Cell coordinates are clamped to this, so that ranges of them can be counted without overflow.
+constexpr float kMaxCellCoordinate = static_cast<float>(1 << 30);
+/// Buckets per point, at least; keeps the lists short without a hash table's worth of memory.
+constexpr std::size_t kBucketsPerPoint = 2;
+constexpr std::size_t kMinBucketCount = 64;
+
+} // namespace
+
+SpatialGrid::SpatialGrid(float cell_size_m)
+  : cell_size_m_(cell_size_m)
+  , inverse_cell_size_(1.0f / cell_size_m) {
+  assert(cell_size_m > 0.0f);
+  heads_.assign(kMinBucketCount, kNone);
+}
+
+void SpatialGrid::Update(std::span<Vec2 const> positions) {
+  if (positions.size() != positions_.size()) {
+    positions_.assign(positions.begin(), positions.end());
+    this->Rebuild();
+    return;
+  }
+
+  for (uint32_t i = 0; i < positions_.size(); ++i) {
+    positions_[i] = positions[i];
+    uint64_t const cell_key = this->ComputeCellKey(positions_[i]);
+    if (cell_key == cell_keys_[i]) {
+      continue;
+    }
+    this->Unlink(i);
+    cell_keys_[i] = cell_key;
+    this->Link(i);
+  }
+}
+
+void SpatialGrid::Clear() {
+  this->Update({});
+}
+
+std::optional<uint32_t> SpatialGrid::FindNearest(Vec2 const& center, float radius) const {
+  std::optional<uint32_t> nearest;
+  float nearest_distance_sq = std::numeric_limits<float>::infinity();
+  this->ForEachInRadius(center, radius, [&](uint32_t i) {
+    Vec2 const offset = positions_[i] - center;
+    float const distance_sq = offset.x * offset.x + offset.y * offset.y;
+    if (!nearest.has_value() || distance_sq < nearest_distance_sq || (distance_sq == nearest_distance_sq && i < nearest.value())) {
+      nearest = i;
+      nearest_distance_sq = distance_sq;
+    }
+  });
+  return nearest;
+}
+
+int32_t SpatialGrid::ToCellCoordinate(float value) const {
+  // Written so that NaN clamps too.
+  float const cell = std::floor(value * inverse_cell_size_);
+  if (!(cell > -kMaxCellCoordinate)) {
+    return -static_cast<int32_t>(kMaxCellCoordinate);
+  }
+  if (!(cell < kMaxCellCoordinate)) {
+    return static_cast<int32_t>(kMaxCellCoordinate);
+  }
+  return static_cast<int32_t>(cell);
+}
+
+uint64_t SpatialGrid::ToCellKey(int32_t x, int32_t y) {
+  return (uint64_t(uint32_t(x)) << 32) | uint32_t(y);
+}
+
+uint64_t SpatialGrid::ComputeCellKey(Vec2 const& position) const {
+  if (!std::isfinite(position.x) || !std::isfinite(position.y)) {
+    return kNoCell;
+  }
+  return ToCellKey(this->ToCellCoordinate(position.x), this->ToCellCoordinate(position.y));
+}
+
+uint32_t SpatialGrid::GetBucket(uint64_t cell_key) const {
+  // Fibonacci hashing: The high bits of the product mix both coordinates.
+  int const shift = 64 - std::countr_zero(heads_.size());
+  return static_cast<uint32_t>((cell_key * 0x9E3779B97F4A7C15ull) >> shift);
+}
+
+void SpatialGrid::Link(uint32_t index) {
+  if (cell_keys_[index] == kNoCell) {
+    return;
+  }
+  uint32_t& head = heads_[this->GetBucket(cell_keys_[index])];
+  previous_[index] = kNone;
+  next_[index] = head;
+  if (head != kNone) {
+    previous_[head] = index;
+  }
+  head = index;
+}
+
+void SpatialGrid::Unlink(uint32_t index) {
+  if (cell_keys_[index] == kNoCell) {
+    return;
+  }
+  uint32_t const next = next_[index];
+  uint32_t const previous = previous_[index];
+  if (previous != kNone) {
+    next_[previous] = next;
+  }
+  else {
+    heads_[this->GetBucket(cell_keys_[index])] = next;
+  }
+  if (next != kNone) {
+    previous_[next] = previous;
+  }
+}
+
+void SpatialGrid::Rebuild() {
+  std::size_t const count = positions_.size();
+  assert(count < kNone);
+
+  heads_.assign(std::bit_ceil(std::max(count * kBucketsPerPoint, kMinBucketCount)), kNone);
+  cell_keys_.resize(count);
+  next_.resize(count);
+  previous_.resize(count);
+
+  // In reverse, so that each list runs in increasing index.
+  for (std::size_t i = count; i-- > 0;) {
+    cell_keys_[i] = this->ComputeCellKey(positions_[i]);
+    this->Link(static_cast<uint32_t>(i));
+  }
+}
+
+SpatialGrid::CellRange SpatialGrid::GetCellRange(Vec2 const& min, Vec2 const& max) const {
+  return CellRange {
+    .min_x = this->ToCellCoordinate(min.x),
+    .min_y = this->ToCellCoordinate(min.y),
+    .max_x = this->ToCellCoordinate(max.x),
+    .max_y = this->ToCellCoordinate(max.y),
+  };
+}
+
+bool SpatialGrid::ShouldScan(CellRange const& range) const {
+  uint64_t const cell_count =
+    uint64_t(int64_t(range.max_x) - range.min_x + 1) * uint64_t(int64_t(range.max_y) - range.min_y + 1);
+  return cell_count > positions_.size();
+}
+
+} // namespace tdc2
@@ -0,0 +1,141 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <vector>
+
+// project headers --------------------------------------
+#include "vec2.h"
+
+namespace tdc2 {
+
+/// Uniform grid over points in the world frame, so that finding the points in a region costs in proportion to what is
+/// there rather than to the number of points.
+///
+/// Points are identified by their index into the span last passed to `Update`. Cells are hashed into a table of buckets,
+/// so the grid covers the whole plane; each bucket keeps its points in a doubly linked list threaded through arrays
+/// indexed by point, so that moving a point from one cell to another costs the same however crowded they are. Points
+/// that are not finite are in no cell, and are never found.
+///
+/// A query whose region spans more cells than there are points scans the points instead.
+class SpatialGrid final {
+public:
+  explicit SpatialGrid(float cell_size_m);
+
+  /// Take `positions` as the points. If their number is that of the last call, only points that left their cell are
+  /// moved; otherwise the grid is rebuilt.
+  void Update(std::span<Vec2 const> positions);
+  void Clear();
+
+  std::size_t GetCount() const { return positions_.size(); }
+  float GetCellSize() const { return cell_size_m_; }
+  /// As of the last `Update`.
+  Vec2 const& GetPosition(uint32_t index) const { return positions_[index]; }
+
+  /// Call `f(index)` for every point within the axis-aligned box from `min` to `max`, in no particular order.
+  template <typename F>
+  void ForEachInBox(Vec2 const& min, Vec2 const& max, F&& f) const;
+  /// Call `f(index)` for every point within `radius` of `center`, in no particular order.
+  template <typename F>
+  void ForEachInRadius(Vec2 const& center, float radius, F&& f) const;
+  /// The point nearest to `center` within `radius`, the one of lowest index among equally near ones.
+  std::optional<uint32_t> FindNearest(Vec2 const& center, float radius) const;
+
+private:
+  static constexpr uint32_t kNone = UINT32_MAX;
+  /// Cell (`INT32_MIN`, `INT32_MIN`), beyond where coordinates are clamped.
+  static constexpr uint64_t kNoCell = 0x8000000080000000ull;
+
+  struct CellRange final {
+    int32_t min_x;
+    int32_t min_y;
+    int32_t max_x;
+    int32_t max_y;
+  };
+
+  int32_t ToCellCoordinate(float value) const;
+  static uint64_t ToCellKey(int32_t x, int32_t y);
+  uint64_t ComputeCellKey(Vec2 const& position) const;
+  uint32_t GetBucket(uint64_t cell_key) const;
+
+  void Link(uint32_t index);
+  void Unlink(uint32_t index);
+  void Rebuild();
+
+  /// Call `f(index)` for every point in the cells of the box from `min` to `max`, or for every point if that is cheaper.
+  template <typename F>
+  void ForEachInCells(Vec2 const& min, Vec2 const& max, F&& f) const;
+  CellRange GetCellRange(Vec2 const& min, Vec2 const& max) const;
+  /// Whether scanning every point is cheaper than visiting the cells of `range`, which is not empty.
+  bool ShouldScan(CellRange const& range) const;
+
+  float cell_size_m_;
+  float inverse_cell_size_;
+
+  std::vector<Vec2> positions_;
+  std::vector<uint64_t> cell_keys_; // Per point; `kNoCell` for points in no cell.
+  std::vector<uint32_t> next_;      // Per point, within its bucket.
+  std::vector<uint32_t> previous_;  // Per point, within its bucket; `kNone` for the first.
+  std::vector<uint32_t> heads_;     // Per bucket; a power of two of them.
+};
+
+template <typename F>
+void SpatialGrid::ForEachInCells(Vec2 const& min, Vec2 const& max, F&& f) const {
+  CellRange const range = this->GetCellRange(min, max);
+  if (range.max_x < range.min_x || range.max_y < range.min_y) {
+    return;
+  }
+  if (this->ShouldScan(range)) {
+    for (uint32_t i = 0; i < positions_.size(); ++i) {
+      f(i);
+    }
+    return;
+  }
+
+  // Several cells may share a bucket; each point is taken only in its own cell.
+  for (int32_t y = range.min_y; y <= range.max_y; ++y) {
+    for (int32_t x = range.min_x; x <= range.max_x; ++x) {
+      uint64_t const cell_key = ToCellKey(x, y);
+      for (uint32_t i = heads_[this->GetBucket(cell_key)]; i != kNone; i = next_[i]) {
+        if (cell_keys_[i] == cell_key) {
+          f(i);
+        }
+      }
+    }
+  }
+}
+
+template <typename F>
+void SpatialGrid::ForEachInBox(Vec2 const& min, Vec2 const& max, F&& f) const {
+  this->ForEachInCells(min, max, [&](uint32_t i) {
+    Vec2 const& position = positions_[i];
+    if (min.x <= position.x && position.x <= max.x && min.y <= position.y && position.y <= max.y) {
+      f(i);
+    }
+  });
+}
+
+template <typename F>
+void SpatialGrid::ForEachInRadius(Vec2 const& center, float radius, F&& f) const {
+  // The cells of a slightly larger box, as its corners round; points are then taken by distance alone.
+  float const reach = radius * (1.0f + 0x1p-16f) + std::max(std::abs(center.x), std::abs(center.y)) * 0x1p-20f;
+  float const radius_sq = radius * radius;
+  this->ForEachInCells(
+    Vec2 { center.x - reach, center.y - reach },
+    Vec2 { center.x + reach, center.y + reach },
+    [&](uint32_t i) {
+      Vec2 const offset = positions_[i] - center;
+      if (offset.x * offset.x + offset.y * offset.y <= radius_sq) {
+        f(i);
+      }
+    }
+  );
+}
+
+} // namespace tdc2
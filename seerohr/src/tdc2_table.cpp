@@ -0,0 +1,397 @@
+// TU header --------------------------------------------
+#include "tdc2_table.h"
+
+// c++ headers ------------------------------------------
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <numbers>
+
+// project headers --------------------------------------
+#include "tdc2_epf.h"
+#include "tdc2_lane_math.h"
+
+static_assert(std::endian::native == std::endian::little, "Firing table files are little-endian and mapped as they are.");
+
+namespace tdc2 {
+
+namespace {
+
+using lane::WrapPi;
+
+/// Lower sample index and interpolation weight of the upper sample for `value` on `axis`, if within the axis.
+struct AxisPosition final {
+  uint32_t index = 0;
+  float t = 0.0f;
+};
+
+/// `inverse_step` is `1 / axis.GetStep()`, or zero for an axis with a single sample.
+std::optional<AxisPosition> LocateOnAxis(FiringTableAxis const& axis, float inverse_step, float value) {
+  if (!(axis.min <= value && value <= axis.max)) {
+    return std::nullopt;
+  }
+  if (axis.count <= 1) {
+    return AxisPosition {};
+  }
+
+  float const u = (value - axis.min) * inverse_step;
+  uint32_t const index = std::min(static_cast<uint32_t>(u), axis.count - 2);
+  return AxisPosition {
+    .index = index,
+    .t = std::clamp(u - static_cast<float>(index), 0.0f, 1.0f),
+  };
+}
+
+} // namespace
+
+float FiringTableAxis::GetValue(uint32_t index) const {
+  assert(index < this->count);
+  if (this->count <= 1) {
+    return this->min;
+  }
+  // Hit `max` exactly at the last sample.
+  float const t = static_cast<float>(index) / static_cast<float>(this->count - 1);
+  return this->min + (this->max - this->min) * t;
+}
+
+float FiringTableAxis::GetStep() const {
+  if (this->count <= 1) {
+    return 0.0f;
+  }
+  return (this->max - this->min) / static_cast<float>(this->count - 1);
+}
+
+std::optional<uint64_t> FiringTableGrid::GetCellCount() const {
+  uint64_t cell_count = 1;
+  for (uint32_t const count : { this->target_bearing.count, this->target_range_m.count, this->target_speed_kn.count, this->angle_on_bow.count }) {
+    if (count != 0 && UINT64_MAX / count < cell_count) {
+      return std::nullopt;
+    }
+    cell_count *= count;
+  }
+  return cell_count;
+}
+
+uint64_t FiringTableGrid::GetCellIndex(uint32_t bearing_index, uint32_t range_index, uint32_t speed_index, uint32_t aob_index) const {
+  uint64_t index = bearing_index;
+  index = index * this->target_range_m.count + range_index;
+  index = index * this->target_speed_kn.count + speed_index;
+  index = index * this->angle_on_bow.count + aob_index;
+  return index;
+}
+
+TorpedoTriangle FiringTableGrid::GetTriangle(float torpedo_speed_kn, uint64_t cell_index) const {
+  uint32_t const aob_index = static_cast<uint32_t>(cell_index % this->angle_on_bow.count);
+  cell_index /= this->angle_on_bow.count;
+  uint32_t const speed_index = static_cast<uint32_t>(cell_index % this->target_speed_kn.count);
+  cell_index /= this->target_speed_kn.count;
+  uint32_t const range_index = static_cast<uint32_t>(cell_index % this->target_range_m.count);
+  cell_index /= this->target_range_m.count;
+  uint32_t const bearing_index = static_cast<uint32_t>(cell_index);
+
+  return TorpedoTriangle {
+    .torpedo_speed_kn = torpedo_speed_kn,
+    .target_bearing = Angle(this->target_bearing.GetValue(bearing_index)),
+    .target_range_m = this->target_range_m.GetValue(range_index),
+    .target_speed_kn = this->target_speed_kn.GetValue(speed_index),
+    .angle_on_bow = Angle(this->angle_on_bow.GetValue(aob_index)),
+  };
+}
+
+FiringTableFileHeader FiringTableFileHeader::Make(TorpedoSpec const& torpedo_spec, ParallaxSolveMethod method, FiringTableGrid const& grid) {
+  FiringTableFileHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.header_size = sizeof(FiringTableFileHeader);
+
+  header.distance_to_tube = torpedo_spec.distance_to_tube;
+  header.reach = torpedo_spec.reach;
+  header.turn_radius = torpedo_spec.turn_radius;
+  header.torpedo_speed_kn = torpedo_spec.speed_kn;
+
+  header.solve_method = static_cast<uint32_t>(method);
+
+  FiringTableAxis const* axes[] = { &grid.target_bearing, &grid.target_range_m, &grid.target_speed_kn, &grid.angle_on_bow };
+  for (uint32_t i = 0; i < 4; ++i) {
+    header.axes[i] = Axis { .min = axes[i]->min, .max = axes[i]->max, .count = axes[i]->count };
+  }
+
+  header.entry_count = grid.GetCellCount().value_or(0);
+  header.entry_offset = (sizeof(FiringTableFileHeader) + kEntryAlignment - 1) / kEntryAlignment * kEntryAlignment;
+  return header;
+}
+
+bool FiringTableFileHeader::IsValid() const {
+  if (std::memcmp(this->magic, kMagic, sizeof(kMagic)) != 0) {
+    return false;
+  }
+  if (this->version != kVersion || this->header_size != sizeof(FiringTableFileHeader)) {
+    return false;
+  }
+  if (this->entry_offset < sizeof(FiringTableFileHeader) || this->entry_offset % kEntryAlignment != 0) {
+    return false;
+  }
+  for (Axis const& axis : this->axes) {
+    if (axis.count == 0) {
+      return false;
+    }
+  }
+  // Checked, so that a product that wraps around cannot pass for a small table and have lookups read past the entries.
+  std::optional<uint64_t> const cell_count = this->GetGrid().GetCellCount();
+  return cell_count.has_value() && this->entry_count == cell_count.value();
+}
+
+TorpedoSpec FiringTableFileHeader::GetTorpedoSpec() const {
+  return TorpedoSpec {
+    .distance_to_tube = this->distance_to_tube,
+    .reach = this->reach,
+    .turn_radius = this->turn_radius,
+    .speed_kn = this->torpedo_speed_kn,
+  };
+}
+
+FiringTableGrid FiringTableFileHeader::GetGrid() const {
+  auto to_axis = [](Axis const& axis) {
+    return FiringTableAxis { .min = axis.min, .max = axis.max, .count = axis.count };
+  };
+  return FiringTableGrid {
+    .target_bearing = to_axis(this->axes[0]),
+    .target_range_m = to_axis(this->axes[1]),
+    .target_speed_kn = to_axis(this->axes[2]),
+    .angle_on_bow = to_axis(this->axes[3]),
+  };
+}
+
+void GenerateFiringTableEntries(
+  TorpedoSpec const& torpedo_spec,
+  ParallaxSolveMethod method,
+  FiringTableGrid const& grid,
+  std::span<FiringTableEntry> entries,
+  uint64_t first,
+  uint64_t count
+) {
+  assert(first + count <= entries.size());
+
+  EquivalentPointOfFireCurveCache epf_curve_cache;
+  EquivalentPointOfFireCurve const& epf_curve = epf_curve_cache.Get(torpedo_spec);
+
+  // The solution is relative to the ownship; solve with the ownship at the origin heading north.
+  Angle const ownship_course = Angle(0.0f);
+  Vec2 const aiming_device_position = { 0.0f, 0.0f };
+
+  for (uint64_t cell_index = first; cell_index < first + count; ++cell_index) {
+    FiringTableEntry& entry = entries[cell_index];
+    entry = FiringTableEntry {};
+
+    TorpedoTriangle const triangle = grid.GetTriangle(torpedo_spec.speed_kn, cell_index);
+
+    TorpedoTriangleIntermediate const interm = triangle.PrepareSolve(ownship_course);
+    std::optional<TorpedoTriangleSolution> const tri_solution = triangle.Solve(interm, aiming_device_position);
+    if (!tri_solution) {
+      continue;
+    }
+    entry.flags |= kFiringTableEntryTriangleSolved;
+
+    ParallaxCorrectionSolution pc_solution;
+    bool const solved = ParallaxCorrectionSolver::Solve(
+      method,
+      torpedo_spec,
+      triangle,
+      tri_solution->pseudo_torpedo_gyro_angle.AsRad(),
+      aiming_device_position,
+      ownship_course.AsRad(),
+      pc_solution,
+      &epf_curve
+    );
+    if (!solved) {
+      continue;
+    }
+
+    if (!std::isfinite(pc_solution.torpedo_time_to_target_s)) {
+      // The target is barely slower than the torpedo; nothing to interpolate.
+      continue;
+    }
+
+    entry.gyro_angle = pc_solution.rho;
+    entry.parallax_delta = pc_solution.delta;
+    entry.run_time_s = pc_solution.torpedo_time_to_target_s;
+    entry.flags |= kFiringTableEntryParallaxSolved;
+  }
+}
+
+bool WriteFiringTable(
+  std::filesystem::path const& path,
+  TorpedoSpec const& torpedo_spec,
+  ParallaxSolveMethod method,
+  FiringTableGrid const& grid,
+  std::span<FiringTableEntry const> entries
+) {
+  FiringTableFileHeader const header = FiringTableFileHeader::Make(torpedo_spec, method, grid);
+  if (!header.IsValid() || entries.size() != header.entry_count) {
+    return false;
+  }
+
+  std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    return false;
+  }
+
+  file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+
+  char const padding[FiringTableFileHeader::kEntryAlignment] = {};
+  file.write(padding, static_cast<std::streamsize>(header.entry_offset - sizeof(header)));
+
+  file.write(reinterpret_cast<char const*>(entries.data()), static_cast<std::streamsize>(entries.size_bytes()));
+
+  return file.good();
+}
+
+std::optional<FiringTable> FiringTable::Open(std::filesystem::path const& path) {
+  std::optional<MappedFile> file = MappedFile::Open(path);
+  if (!file) {
+    return std::nullopt;
+  }
+
+  std::span<std::byte const> const data = file->GetData();
+  if (data.size() < sizeof(FiringTableFileHeader)) {
+    return std::nullopt;
+  }
+
+  // Mappings are page aligned, so the header and the entries at `entry_offset` are suitably aligned.
+  auto const* header = reinterpret_cast<FiringTableFileHeader const*>(data.data());
+  if (!header->IsValid()) {
+    return std::nullopt;
+  }
+  if (data.size() < header->entry_offset || header->entry_count > (data.size() - header->entry_offset) / sizeof(FiringTableEntry)) {
+    return std::nullopt;
+  }
+
+  std::span<FiringTableEntry const> const entries {
+    reinterpret_cast<FiringTableEntry const*>(data.data() + header->entry_offset),
+    static_cast<std::size_t>(header->entry_count)
+  };
+
+  return FiringTable(std::move(file.value()), header, entries);
+}
+
+FiringTable::FiringTable(MappedFile file, FiringTableFileHeader const* header, std::span<FiringTableEntry const> entries)
+  : file_(std::move(file)),
+    header_(header),
+    entries_(entries),
+    grid_(header->GetGrid())
+{
+  strides_[3] = 1;
+  strides_[2] = strides_[3] * grid_.angle_on_bow.count;
+  strides_[1] = strides_[2] * grid_.target_speed_kn.count;
+  strides_[0] = strides_[1] * grid_.target_range_m.count;
+
+  FiringTableAxis const* const axes[4] = { &grid_.target_bearing, &grid_.target_range_m, &grid_.target_speed_kn, &grid_.angle_on_bow };
+  for (uint32_t axis = 0; axis < 4; ++axis) {
+    float const step = axes[axis]->GetStep();
+    inverse_steps_[axis] = (step > 0.0f) ? 1.0f / step : 0.0f;
+  }
+}
+
+bool FiringTable::IsGeneratedFor(TorpedoSpec const& torpedo_spec) const {
+  return header_->distance_to_tube == torpedo_spec.distance_to_tube &&
+         header_->reach == torpedo_spec.reach &&
+         header_->turn_radius == torpedo_spec.turn_radius &&
+         header_->torpedo_speed_kn == torpedo_spec.speed_kn;
+}
+
+std::optional<FiringTableSolution> FiringTable::Lookup(
+  TorpedoTriangle const& triangle,
+  EquivalentPointOfFireCurve const* epf_curve
+) const {
+  FiringTableAxis const* const axes[4] = { &grid_.target_bearing, &grid_.target_range_m, &grid_.target_speed_kn, &grid_.angle_on_bow };
+  float const values[4] = { triangle.target_bearing.AsRad(), triangle.target_range_m, triangle.target_speed_kn, triangle.angle_on_bow.AsRad() };
+
+  // Weights and cell indices of the 16 corners of the surrounding cell, expanded one axis at a time.
+  float weights[16] = { 1.0f };
+  uint64_t cell_indices[16] = { 0 };
+  uint32_t corner_count = 1;
+  for (uint32_t axis = 0; axis < 4; ++axis) {
+    std::optional<AxisPosition> const position = LocateOnAxis(*axes[axis], inverse_steps_[axis], values[axis]);
+    if (!position) {
+      return std::nullopt;
+    }
+    for (uint32_t i = 0; i < corner_count; ++i) {
+      weights[corner_count + i] = weights[i] * position->t;
+      weights[i] *= 1.0f - position->t;
+      cell_indices[i] += position->index * strides_[axis];
+      cell_indices[corner_count + i] = cell_indices[i] + strides_[axis];
+    }
+    corner_count *= 2;
+  }
+
+  // Accumulate the corners, skipping those that do not contribute so that queries on a grid line or at the edge of the
+  // grid do not depend on cells beyond it.
+  // Gyro angles are accumulated as offsets from the first contributing corner, so that interpolation across ±π
+  // does not average a port and a starboard angle into a bogus one.
+  std::optional<float> reference_gyro_angle;
+  float gyro_angle_offset = 0.0f;
+
+  for (uint32_t corner = 0; corner < 16; ++corner) {
+    float const weight = weights[corner];
+    if (weight == 0.0f) {
+      continue;
+    }
+
+    FiringTableEntry const& entry = entries_[cell_indices[corner]];
+    if (!entry.IsFeasible()) {
+      return std::nullopt;
+    }
+
+    if (!reference_gyro_angle) {
+      reference_gyro_angle = entry.gyro_angle;
+    }
+    // Both angles are in [-π, π], so at most one turn needs to be removed.
+    float offset = entry.gyro_angle - reference_gyro_angle.value();
+    offset += (offset < -std::numbers::pi_v<float>) ? 2.0f * std::numbers::pi_v<float> : 0.0f;
+    offset -= (std::numbers::pi_v<float> < offset) ? 2.0f * std::numbers::pi_v<float> : 0.0f;
+    if (kMaxGyroAngleSpread < std::abs(offset)) {
+      // The cells straddle a jump between two branches of the solution.
+      return std::nullopt;
+    }
+    gyro_angle_offset += weight * offset;
+  }
+
+  // At least one corner always has a positive weight.
+  assert(reference_gyro_angle.has_value());
+
+  float const gyro_angle = WrapPi(reference_gyro_angle.value() + gyro_angle_offset);
+
+  // Evaluate the rest of the solution at the interpolated gyro angle rather than interpolating it too: This is exact for the
+  // gyro angle, and the run time, unlike the gyro angle, grows without bound as the target speed nears the torpedo speed.
+  ParallaxCorrectionSolution pc_solution;
+  bool const result = ParallaxCorrectionSolver::ComputeSolutionAt(
+    header_->GetTorpedoSpec(),
+    triangle,
+    gyro_angle,
+    { 0.0f, 0.0f },
+    0.0f,
+    pc_solution,
+    epf_curve
+  );
+  if (!result) {
+    return std::nullopt;
+  }
+
+  // The residual of the fixed point, ρ_target(ρ) - ρ with ρ_target = ω2 + β2 and ω2 = ω1 - Δ.
+  float const residual = WrapPi(triangle.target_bearing.AsRad() - pc_solution.delta + pc_solution.beta - gyro_angle);
+  if (!(std::abs(residual) <= kMaxGyroAngleResidual)) {
+    return std::nullopt;
+  }
+
+  return FiringTableSolution {
+    .gyro_angle = gyro_angle,
+    .parallax_delta = pc_solution.delta,
+    .run_time_s = pc_solution.torpedo_time_to_target_s,
+  };
+}
+
+} // namespace tdc2
@@ -0,0 +1,198 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cstddef>
+#include <cstdint>
+
+#include <filesystem>
+#include <optional>
+#include <span>
+
+// project headers --------------------------------------
+#include "mapped_file.h"
+#include "tdc2_solver.h"
+
+namespace tdc2 {
+
+/// One axis of a firing table: `count` samples evenly spaced over [`min`, `max`], both inclusive.
+struct FiringTableAxis final {
+  float min = 0.0f;
+  float max = 0.0f;
+  uint32_t count = 1;
+
+  /// Sample `index` of the axis. An axis with a single sample only has `min`.
+  float GetValue(uint32_t index) const;
+  /// Distance between adjacent samples; zero for an axis with a single sample.
+  float GetStep() const;
+};
+
+/// The scenarios a firing table covers: the cartesian product of its four axes.
+///
+/// Bearing and angle on bow are signed, in radians: Positive is starboard, negative is port.
+/// Cells are stored in row-major order with the angle on bow varying fastest and the target bearing slowest.
+struct FiringTableGrid final {
+  FiringTableAxis target_bearing;
+  FiringTableAxis target_range_m;
+  FiringTableAxis target_speed_kn;
+  FiringTableAxis angle_on_bow;
+
+  /// None if the product of the axis counts does not fit in 64 bits.
+  std::optional<uint64_t> GetCellCount() const;
+  uint64_t GetCellIndex(uint32_t bearing_index, uint32_t range_index, uint32_t speed_index, uint32_t aob_index) const;
+  /// The triangle of cell `cell_index`.
+  TorpedoTriangle GetTriangle(float torpedo_speed_kn, uint64_t cell_index) const;
+};
+
+enum FiringTableEntryFlags : uint32_t {
+  /// The torpedo triangle has a solution, i.e. the torpedo can catch up with the target.
+  kFiringTableEntryTriangleSolved = 1u << 0,
+  /// The parallax correction converged. Implies `kFiringTableEntryTriangleSolved`.
+  kFiringTableEntryParallaxSolved = 1u << 1,
+
+  kFiringTableEntryFeasible = kFiringTableEntryTriangleSolved | kFiringTableEntryParallaxSolved,
+};
+
+/// Firing solution of one grid cell. Entries that are not feasible are zero except for `flags`.
+///
+/// The solution is relative to the ownship, so it does not depend on the ownship course or on where the aiming device is.
+struct FiringTableEntry final {
+  float gyro_angle = 0.0f;     // ρ: Final torpedo gyro angle in radians. Positive is starboard, negative is port.
+  float parallax_delta = 0.0f; // Δ: Parallax correction angle in radians.
+  float run_time_s = 0.0f;     // Torpedo run time to the impact, parallax corrected.
+  uint32_t flags = 0;          // `FiringTableEntryFlags`.
+
+  bool IsFeasible() const { return (flags & kFiringTableEntryFeasible) == kFiringTableEntryFeasible; }
+};
+static_assert(sizeof(FiringTableEntry) == 16);
+
+/// Header at the start of a firing table file.
+///
+/// ## File format
+/// All values are little-endian. The header is followed by padding up to `entry_offset`, which is a multiple of
+/// `kEntryAlignment`, and `entry_count` tightly packed `FiringTableEntry` in the order of `FiringTableGrid`.
+/// Files are meant to be mapped into memory as they are, so the layout of these structures is the file format;
+/// bump `kVersion` on any change.
+struct FiringTableFileHeader final {
+  static constexpr char kMagic[8] = { 'S', 'R', 'F', 'T', 'A', 'B', 'L', '\0' };
+  static constexpr uint32_t kVersion = 2; // 2: Equivalent point of fire moved to the side opposite the turn.
+  static constexpr uint64_t kEntryAlignment = 64;
+
+  /// An axis as stored in the file.
+  struct Axis final {
+    float min = 0.0f;
+    float max = 0.0f;
+    uint32_t count = 0;
+    uint32_t reserved = 0;
+  };
+
+  char magic[8] = {};
+  uint32_t version = 0;
+  uint32_t header_size = 0; // sizeof(FiringTableFileHeader)
+
+  // `TorpedoSpec` the table was generated for.
+  float distance_to_tube = 0.0f;
+  float reach = 0.0f;
+  float turn_radius = 0.0f;
+  float torpedo_speed_kn = 0.0f;
+
+  uint32_t solve_method = 0; // `ParallaxSolveMethod`.
+  uint32_t reserved = 0;
+
+  // In the order target bearing (rad), target range (m), target speed (kn), angle on bow (rad).
+  Axis axes[4] = {};
+
+  uint64_t entry_count = 0;
+  uint64_t entry_offset = 0; // In bytes from the start of the file.
+
+  static FiringTableFileHeader Make(TorpedoSpec const& torpedo_spec, ParallaxSolveMethod method, FiringTableGrid const& grid);
+
+  /// Whether the magic, version and sizes are consistent. Does not check against the file size.
+  bool IsValid() const;
+
+  TorpedoSpec GetTorpedoSpec() const;
+  FiringTableGrid GetGrid() const;
+};
+static_assert(sizeof(FiringTableFileHeader) == 120);
+
+/// Solve cells [`first`, `first + count`) of `grid` into `entries`, which is indexed by cell index.
+///
+/// Disjoint ranges can be generated concurrently.
+void GenerateFiringTableEntries(
+  TorpedoSpec const& torpedo_spec,
+  ParallaxSolveMethod method,
+  FiringTableGrid const& grid,
+  std::span<FiringTableEntry> entries,
+  uint64_t first,
+  uint64_t count
+);
+
+/// Write a firing table file. `entries` must hold `grid.GetCellCount()` entries.
+///
+/// ## Returns
+/// `false` if the file could not be written.
+bool WriteFiringTable(
+  std::filesystem::path const& path,
+  TorpedoSpec const& torpedo_spec,
+  ParallaxSolveMethod method,
+  FiringTableGrid const& grid,
+  std::span<FiringTableEntry const> entries
+);
+
+/// Firing solution looked up from a `FiringTable`.
+struct FiringTableSolution final {
+  float gyro_angle = 0.0f;     // ρ: Final torpedo gyro angle in radians. Positive is starboard, negative is port.
+  float parallax_delta = 0.0f; // Δ: Parallax correction angle in radians.
+  float run_time_s = 0.0f;
+};
+
+/// A firing table file mapped into memory.
+///
+/// Opening validates the header and the file size only; entries are read from the mapping as they are, so opening takes
+/// constant time regardless of the table size, and only the pages around queried cells are ever loaded.
+class FiringTable final {
+public:
+  /// Largest residual |ρ_target(ρ) - ρ| of an interpolated gyro angle that `Lookup` accepts, in radians (0.25°).
+  static constexpr float kMaxGyroAngleResidual = 0.0044f;
+  /// Largest difference between the gyro angles of the interpolated cells that `Lookup` accepts, in radians (30°).
+  static constexpr float kMaxGyroAngleSpread = 0.52f;
+
+  static std::optional<FiringTable> Open(std::filesystem::path const& path);
+
+  FiringTableFileHeader const& GetHeader() const { return *header_; }
+  FiringTableGrid const& GetGrid() const { return grid_; }
+  std::span<FiringTableEntry const> GetEntries() const { return entries_; }
+
+  /// Whether the table was generated for `torpedo_spec`, including its speed.
+  bool IsGeneratedFor(TorpedoSpec const& torpedo_spec) const;
+
+  /// Quadrilinear interpolation of the gyro angle between the grid cells surrounding `triangle`.
+  ///
+  /// The parallax correction and the run time are then evaluated at the interpolated gyro angle with
+  /// `ParallaxCorrectionSolver::ComputeSolutionAt`, using `epf_curve` if given. This also yields the residual of the fixed
+  /// point, which rejects interpolation across discontinuities of the solution the grid cannot resolve, e.g. between a
+  /// port and a starboard turn or close to the ownship.
+  /// `triangle.torpedo_speed_kn` is ignored; see `IsGeneratedFor`.
+  ///
+  /// ## Returns
+  /// `std::nullopt` if `triangle` is outside the grid, any cell that contributes to the interpolation is infeasible, or
+  /// the solution is not smooth enough there; see `kMaxGyroAngleResidual` and `kMaxGyroAngleSpread`.
+  /// Callers are expected to fall back to `ParallaxCorrectionSolver` then.
+  std::optional<FiringTableSolution> Lookup(
+    TorpedoTriangle const& triangle,
+    EquivalentPointOfFireCurve const* epf_curve = nullptr
+  ) const;
+
+private:
+  FiringTable(MappedFile file, FiringTableFileHeader const* header, std::span<FiringTableEntry const> entries);
+
+  MappedFile file_;
+  FiringTableFileHeader const* header_ = nullptr; // Into `file_`.
+  std::span<FiringTableEntry const> entries_;     // Into `file_`.
+  FiringTableGrid grid_;
+
+  // Per axis, in the order of `FiringTableFileHeader::axes`.
+  uint64_t strides_[4] = {};    // Cell index step.
+  float inverse_steps_[4] = {}; // 1 / `FiringTableAxis::GetStep`, or zero for an axis with a single sample.
+};
+
+} // namespace tdc2
@@ -0,0 +1,226 @@
+// TU header --------------------------------------------
+#include "tdc2_targets.h"
+
+// c++ headers ------------------------------------------
+#include <cassert>
+#include <cmath>
+
+#include <algorithm>
+#include <numbers>
+
+// project headers --------------------------------------
+#include "tdc2_lane_math.h"
+
+namespace tdc2 {
+
+namespace {
+
+using lane::WrapPi;
+
+template <typename T>
+std::size_t GetCapacityBytes(std::vector<T> const& values) {
+  return values.capacity() * sizeof(T);
+}
+
+} // namespace
+
+TargetData ComputeTargetData(
+  Vec2 const& aiming_device_position,
+  Angle ownship_course,
+  Vec2 const& target_position,
+  Angle target_course,
+  float target_speed_kn
+) {
+  Vec2 const to_target = target_position - aiming_device_position;
+  float const absolute_target_bearing = std::atan2(to_target.x, -to_target.y);
+
+  // Inverse of `TorpedoTriangle::PrepareSolve`: target course = absolute bearing + π - AoB.
+  return TargetData {
+    .target_bearing = Angle(WrapPi(absolute_target_bearing - ownship_course.AsRad())),
+    .target_range_m = to_target.Length(),
+    .target_speed_kn = target_speed_kn,
+    .angle_on_bow = Angle(WrapPi(absolute_target_bearing + std::numbers::pi_v<float> - target_course.AsRad())),
+  };
+}
+
+TargetId TargetTable::Add(TargetData const& target) {
+  TargetId const id = next_id_++;
+  std::size_t const index = ids_.size();
+
+  ids_.push_back(id);
+  indices_.emplace(id, index);
+  input_.Resize(index + 1);
+  warm_start_.Resize(index + 1);
+  this->SetTarget(index, target);
+  return id;
+}
+
+bool TargetTable::Remove(TargetId id) {
+  auto const it = indices_.find(id);
+  if (it == indices_.end()) {
+    return false;
+  }
+  std::size_t const index = it->second;
+  std::size_t const last = ids_.size() - 1;
+  indices_.erase(it);
+
+  // Move the last target into the hole.
+  if (index != last) {
+    ids_[index] = ids_[last];
+    indices_[ids_[index]] = index;
+    for (std::vector<float>* values : {
+      &input_.target_bearing, &input_.target_range_m, &input_.target_speed_kn, &input_.angle_on_bow,
+      &input_.ownship_course, &input_.aiming_device_x, &input_.aiming_device_y,
+    }) {
+      (*values)[index] = (*values)[last];
+    }
+    warm_start_.Move(last, index);
+  }
+  ids_.pop_back();
+  input_.Resize(last);
+  warm_start_.Resize(last);
+
+  solved_count_ = std::min(solved_count_, index);
+  return true;
+}
+
+void TargetTable::Clear() {
+  ids_.clear();
+  indices_.clear();
+  input_.Resize(0);
+  warm_start_.Resize(0);
+  solved_count_ = 0;
+}
+
+std::optional<std::size_t> TargetTable::FindIndex(TargetId id) const {
+  auto const it = indices_.find(id);
+  if (it == indices_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+TargetData TargetTable::GetTarget(std::size_t index) const {
+  assert(index < this->GetCount());
+
+  return TargetData {
+    .target_bearing = Angle(input_.target_bearing[index]),
+    .target_range_m = input_.target_range_m[index],
+    .target_speed_kn = input_.target_speed_kn[index],
+    .angle_on_bow = Angle(input_.angle_on_bow[index]),
+  };
+}
+
+void TargetTable::SetTarget(std::size_t index, TargetData const& target) {
+  assert(index < this->GetCount());
+
+  input_.target_bearing[index] = target.target_bearing.AsRad();
+  input_.target_range_m[index] = target.target_range_m;
+  input_.target_speed_kn[index] = target.target_speed_kn;
+  input_.angle_on_bow[index] = target.angle_on_bow.AsRad();
+}
+
+void TargetTable::Solve(
+  TorpedoSpec const& torpedo_spec,
+  Angle ownship_course,
+  Vec2 const& aiming_device_position,
+  EquivalentPointOfFireCurve const* epf_curve,
+  JobSystem* job_system
+) {
+  std::size_t const count = this->GetCount();
+
+  std::fill(input_.ownship_course.begin(), input_.ownship_course.end(), ownship_course.AsRad());
+  std::fill(input_.aiming_device_x.begin(), input_.aiming_device_x.end(), aiming_device_position.x);
+  std::fill(input_.aiming_device_y.begin(), input_.aiming_device_y.end(), aiming_device_position.y);
+
+  tri_output_.Resize(count);
+  pc_output_.Resize(count);
+  positions_.resize(count);
+
+  auto solve_range = [&](std::size_t first, std::size_t range_count) {
+    SolveTorpedoTriangleBatch(torpedo_spec.speed_kn, input_, tri_output_, first, range_count);
+    SolveParallaxCorrectionBatchWarm(torpedo_spec, input_, tri_output_, warm_start_, pc_output_, first, range_count, epf_curve);
+
+    for (std::size_t i = first; i < first + range_count; ++i) {
+      positions_[i] = ComputeTargetPosition(
+        aiming_device_position,
+        ownship_course,
+        Angle(input_.target_bearing[i]),
+        input_.target_range_m[i]
+      );
+    }
+  };
+
+  // Inline, in a single range: Every range ends with its slowest lanes stepping on alone, which tiles only pay for where
+  // they run concurrently.
+  if (job_system == nullptr) {
+    solve_range(0, count);
+  }
+  else {
+    auto solve_tile = [&](std::size_t tile) {
+      std::size_t const first = tile * kTileTargetCount;
+      solve_range(first, std::min(kTileTargetCount, count - first));
+    };
+
+    std::size_t const tile_count = (count + kTileTargetCount - 1) / kTileTargetCount;
+    job_system->ParallelFor(
+      tile_count,
+      [&](uint64_t first, uint64_t count) {
+        for (uint64_t tile = first; tile < first + count; ++tile) {
+          solve_tile(static_cast<std::size_t>(tile));
+        }
+      },
+      ParallelForOptions { .chunk_size = 1, .progress = {} }
+    );
+  }
+
+  solved_count_ = count;
+}
+
+std::size_t TargetTable::GetMemoryUsage() const {
+  std::size_t bytes = GetCapacityBytes(ids_) + GetCapacityBytes(positions_);
+  // A node per entry and a pointer per bucket.
+  bytes += indices_.size() * (sizeof(std::pair<TargetId const, std::size_t>) + 2 * sizeof(void*));
+  bytes += indices_.bucket_count() * sizeof(void*);
+
+  for (std::vector<float> const* values : {
+    &input_.target_bearing, &input_.target_range_m, &input_.target_speed_kn, &input_.angle_on_bow,
+    &input_.ownship_course, &input_.aiming_device_x, &input_.aiming_device_y,
+    &tri_output_.target_course, &tri_output_.lead_angle, &tri_output_.intercept_angle,
+    &tri_output_.torpedo_time_to_target_s, &tri_output_.pseudo_torpedo_gyro_angle,
+    &tri_output_.impact_x, &tri_output_.impact_y,
+    &pc_output_.delta, &pc_output_.rho, &pc_output_.gamma, &pc_output_.beta,
+    &pc_output_.epf_offset_x, &pc_output_.epf_offset_y, &pc_output_.torpedo_run_distance_m,
+    &pc_output_.torpedo_time_to_target_s, &pc_output_.impact_x, &pc_output_.impact_y,
+    &warm_start_.gyro_correction, &warm_start_.gyro_correction_rate, &warm_start_.start_gyro_angle,
+  }) {
+    bytes += GetCapacityBytes(*values);
+  }
+  for (std::vector<uint8_t> const* values : { &tri_output_.valid, &pc_output_.valid, &pc_output_.iterations }) {
+    bytes += GetCapacityBytes(*values);
+  }
+  return bytes;
+}
+
+std::optional<TorpedoTriangleSolution> TargetTable::GetTriangleSolution(std::size_t index) const {
+  if (index >= solved_count_) {
+    return std::nullopt;
+  }
+  return tri_output_.Get(index);
+}
+
+std::optional<ParallaxCorrectionSolution> TargetTable::GetParallaxSolution(std::size_t index) const {
+  if (index >= solved_count_) {
+    return std::nullopt;
+  }
+  return pc_output_.Get(index);
+}
+
+std::optional<Vec2> TargetTable::GetPosition(std::size_t index) const {
+  if (index >= solved_count_) {
+    return std::nullopt;
+  }
+  return positions_[index];
+}
+
+} // namespace tdc2
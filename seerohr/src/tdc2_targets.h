@@ -0,0 +1,122 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cstddef>
+#include <cstdint>
+
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+// project headers --------------------------------------
+#include "angle.h"
+#include "vec2.h"
+#include "job_system.h"
+#include "tdc2_batch.h"
+#include "tdc2_solver.h"
+
+namespace tdc2 {
+
+/// Identifies a target of a `TargetTable` for as long as it is in it. Never reused within a table.
+using TargetId = uint32_t;
+
+/// TDC inputs of one target.
+struct TargetData final {
+  Angle target_bearing = Angle::FromDeg(0.0f); // Relative; either [0, 2pi) or signed.
+  float target_range_m = 0.0f;
+  float target_speed_kn = 0.0f;
+  Angle angle_on_bow = Angle::FromDeg(0.0f);   // Signed: Positive is starboard, negative is port.
+};
+
+/// `TargetData` of a target at `target_position` on `target_course`, as seen from an aiming device at
+/// `aiming_device_position` on `ownship_course`. Inverse of `ComputeTargetPosition`.
+TargetData ComputeTargetData(
+  Vec2 const& aiming_device_position,
+  Angle ownship_course,
+  Vec2 const& target_position,
+  Angle target_course,
+  float target_speed_kn
+);
+
+/// The targets tracked by the TDC, in structure-of-arrays form so that they are solved together in one batched pass.
+///
+/// Targets are stored densely; removing one moves the last into its place. Indices are therefore only stable until the
+/// next removal, while IDs are stable for as long as the target is in the table.
+class TargetTable final {
+public:
+  /// Targets per tile of `Solve` on a job system; see `EngagementMatrix::kTileTargetCount`.
+  static constexpr std::size_t kTileTargetCount = 128;
+
+  /// ## Returns
+  /// The ID of the new target, which is at index `GetCount() - 1`.
+  TargetId Add(TargetData const& target);
+  /// ## Returns
+  /// `false` if there is no target `id`.
+  bool Remove(TargetId id);
+  void Clear();
+
+  std::size_t GetCount() const { return ids_.size(); }
+  TargetId GetId(std::size_t index) const { return ids_[index]; }
+  std::optional<std::size_t> FindIndex(TargetId id) const;
+
+  TargetData GetTarget(std::size_t index) const;
+  void SetTarget(std::size_t index, TargetData const& target);
+
+  /// Solve the torpedo triangle and the parallax correction of every target, as seen from the ownship on
+  /// `ownship_course` with its aiming device at `aiming_device_position`. Linear in the number of targets.
+  ///
+  /// If `epf_curve` is given, it is evaluated instead of the closed-form equivalent point of fire offset.
+  ///
+  /// The parallax correction of every target starts from its last solution; see `SolveParallaxCorrectionBatchWarm`.
+  /// Targets are solved in tiles of up to `kTileTargetCount`, concurrently on `job_system` if given, otherwise inline in a
+  /// single pass.
+  ///
+  /// On one core at -O2, a tick of 1000 targets takes 0.15 to 0.55 ms on average (`tdc_targets_solve` of
+  /// `seerohr_bench`). It takes longest with large gyro angles, where more targets never converge; those iterate until
+  /// they stall, see `ParallaxCorrectionSolver::kStallIters`. Single ticks are slower: The 99th percentile reaches 1.5 ms
+  /// on a shared core, 0.75 ms built for the host CPU.
+  void Solve(
+    TorpedoSpec const& torpedo_spec,
+    Angle ownship_course,
+    Vec2 const& aiming_device_position,
+    EquivalentPointOfFireCurve const* epf_curve = nullptr,
+    JobSystem* job_system = nullptr
+  );
+
+  //
+  // Solutions as of the last `Solve`, by index. Targets added or moved by a removal since have none.
+  //
+
+  std::optional<TorpedoTriangleSolution> GetTriangleSolution(std::size_t index) const;
+  std::optional<ParallaxCorrectionSolution> GetParallaxSolution(std::size_t index) const;
+
+  /// Target position as of the last `Solve`.
+  std::optional<Vec2> GetPosition(std::size_t index) const;
+  /// Positions of the targets solved by the last `Solve`, by index.
+  std::span<Vec2 const> GetPositions() const { return { positions_.data(), solved_count_ }; }
+
+  /// Bytes held for the targets, their solutions and scratch. The ID lookup is estimated.
+  std::size_t GetMemoryUsage() const;
+
+  TorpedoTriangleBatchInput const& GetInputs() const { return input_; }
+  TorpedoTriangleBatchOutput const& GetTriangleOutputs() const { return tri_output_; }
+  ParallaxCorrectionBatchOutput const& GetParallaxOutputs() const { return pc_output_; }
+
+private:
+  TargetId next_id_ = 1;
+  std::vector<TargetId> ids_;
+  std::unordered_map<TargetId, std::size_t> indices_;
+
+  // Per target. The ownship members of `input_` are filled in by `Solve`.
+  TorpedoTriangleBatchInput input_;
+
+  ParallaxWarmStartBatch warm_start_;
+
+  std::size_t solved_count_ = 0; // Targets [0, `solved_count_`) have outputs.
+  std::vector<Vec2> positions_;
+  TorpedoTriangleBatchOutput tri_output_;
+  ParallaxCorrectionBatchOutput pc_output_;
+};
+
+} // namespace tdc2
@@ -57,6 +57,44 @@ std::unordered_map<TextId, std::array<const char*, kLanguageCount>> const kTextM
   MAKE_TEXT(kGyroAngle,                  "Schußwinkel",       "Gyro Angle",                "ジャイロ角"),
   MAKE_TEXT(kAfterParallaxCorrection,    "Nach der Winkelparallaxverbesserung", "After Parallax Correction", "視差補正後"),
   MAKE_TEXT(kNoSolution,                 "Keine Lösung",      "No solution",               "解なし"),
+  MAKE_TEXT(kParallaxSolver,             "Parallaxlöser",     "Parallax Solver",           "視差ソルバー"),
+  MAKE_TEXT(kSolverGeometry,             "Geometrisch",       "Geometric",                 "幾何反復"),
+  MAKE_TEXT(kSolverNewton,               "Newton",            "Newton",                    "ニュートン法"),
+  MAKE_TEXT(kSolverSiemens,              "Siemens",           "Siemens",                   "シーメンス法"),
+  MAKE_TEXT(kIterations,                 "Iterationen",       "Iterations",                "反復回数"),
+  MAKE_TEXT(kUseFiringTable,             "Schußtafel verwenden", "Use Firing Table",      "射表を使用"),
+  MAKE_TEXT(kFromFiringTable,            "Aus Schußtafel",    "From Firing Table",         "射表から"),
+  MAKE_TEXT(kSolutionAge,                "Alter der Lösung",  "Solution Age",              "解の経過時間"),
+  MAKE_TEXT(kSpeed,                      "Fahrt",             "Speed",                     "速力"),
+  MAKE_TEXT(kSimulation,                 "Simulation",        "Simulation",                "シミュレーション"),
+  MAKE_TEXT(kRun,                        "Start",             "Run",                       "開始"),
+  MAKE_TEXT(kPause,                      "Halt",              "Pause",                     "一時停止"),
+  MAKE_TEXT(kFire,                       "Los!",              "Fire",                      "発射"),
+  MAKE_TEXT(kTimeCompression,            "Zeitraffer",        "Time Compression",          "時間加速"),
+  MAKE_TEXT(kSimulationTime,             "Simulationszeit",   "Simulation Time",           "シミュレーション時間"),
+  MAKE_TEXT(kHits,                       "Treffer",           "Hits",                      "命中"),
+  MAKE_TEXT(kTarget,                     "Ziel",              "Target",                    "目標"),
+  MAKE_TEXT(kAddTarget,                  "Ziel hinzufügen",   "Add Target",                "目標追加"),
+  MAKE_TEXT(kRemoveTarget,               "Ziel entfernen",    "Remove Target",             "目標削除"),
+  MAKE_TEXT(kFleet,                      "Rudel",             "Wolfpack",                  "群狼"),
+  MAKE_TEXT(kWingmen,                    "Weitere Boote",     "Other Boats",               "僚艦"),
+  MAKE_TEXT(kEngagements,                "Lösungen",          "Solutions",                 "解"),
+  MAKE_TEXT(kConvoy,                     "Geleitzug",         "Convoy",                    "船団"),
+  MAKE_TEXT(kShips,                      "Schiffe",           "Ships",                     "隻数"),
+  MAKE_TEXT(kSeed,                       "Startwert",         "Seed",                      "シード"),
+  MAKE_TEXT(kGenerate,                   "Erzeugen",          "Generate",                  "生成"),
+  MAKE_TEXT(kScalingBenchmark,           "Skalierungstest",   "Scaling Benchmark",         "規模計測"),
+  MAKE_TEXT(kContacts,                   "Kontakte",          "Contacts",                  "目標数"),
+  MAKE_TEXT(kSolveMs,                    "Lösen (ms)",        "Solve (ms)",                "解算 (ms)"),
+  MAKE_TEXT(kDrawMs,                     "Zeichnen (ms)",     "Draw (ms)",                 "描画 (ms)"),
+  MAKE_TEXT(kBytesPerContact,            "Bytes/Kontakt",     "Bytes/Contact",             "バイト/目標"),
+  MAKE_TEXT(kFiringPlanner,              "Schusszeitplanung", "Firing Planner",            "発射時機計画"),
+  MAKE_TEXT(kHorizon,                    "Vorausschau",       "Horizon",                   "予測時間"),
+  MAKE_TEXT(kCandidates,                 "Zeitpunkte",        "Candidates",                "候補数"),
+  MAKE_TEXT(kBestTime,                   "Bester Zeitpunkt",  "Best Time",                 "最適時機"),
+  MAKE_TEXT(kCourseSweep,                "Kursabtastung",     "Course Sweep",              "針路走査"),
+  MAKE_TEXT(kMinGyroAngle,               "Kleinster Schusswinkel", "Least Gyro Angle",     "最小射角"),
+  MAKE_TEXT(kMinParallax,                "Kleinste Parallaxe", "Least Parallax",           "最小視差"),
 };
 
 Language current_language = Language::kGerman;
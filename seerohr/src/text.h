@@ -27,6 +27,44 @@ enum class TextId {
   kGyroAngle,
   kAfterParallaxCorrection,
   kNoSolution,
+  kParallaxSolver,
+  kSolverGeometry,
+  kSolverNewton,
+  kSolverSiemens,
+  kIterations,
+  kUseFiringTable,
+  kFromFiringTable,
+  kSolutionAge,
+  kSpeed,
+  kSimulation,
+  kRun,
+  kPause,
+  kFire,
+  kTimeCompression,
+  kSimulationTime,
+  kHits,
+  kTarget,
+  kAddTarget,
+  kRemoveTarget,
+  kFleet,
+  kWingmen,
+  kEngagements,
+  kConvoy,
+  kShips,
+  kSeed,
+  kGenerate,
+  kScalingBenchmark,
+  kContacts,
+  kSolveMs,
+  kDrawMs,
+  kBytesPerContact,
+  kFiringPlanner,
+  kHorizon,
+  kCandidates,
+  kBestTime,
+  kCourseSweep,
+  kMinGyroAngle,
+  kMinParallax,
 };
 
 Language GetSystemLanguageOrEnglish();
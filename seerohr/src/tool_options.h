@@ -0,0 +1,71 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cstdint>
+
+#include <charconv>
+#include <optional>
+#include <string_view>
+
+// project headers --------------------------------------
+#include "tdc2_solver.h"
+
+/// Parsing of the option values shared by the command line tools.
+namespace tool_options {
+
+/// Decimal or scientific notation, with an optional leading '+'. Surrounding blanks and a trailing '\r' are ignored.
+inline std::optional<float> ParseFloat(std::string_view str) {
+  while (!str.empty() && (str.front() == ' ' || str.front() == '\t')) {
+    str.remove_prefix(1);
+  }
+  while (!str.empty() && (str.back() == ' ' || str.back() == '\t' || str.back() == '\r')) {
+    str.remove_suffix(1);
+  }
+  if (!str.empty() && str.front() == '+') {
+    str.remove_prefix(1);
+  }
+
+  float value = 0.0f;
+  auto const [end, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+  if (ec != std::errc() || end != str.data() + str.size()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+/// Decimal digits only. Fails for signs, fractions, exponents and values that do not fit.
+inline std::optional<uint32_t> ParseUInt32(std::string_view str) {
+  uint32_t value = 0;
+  auto const [end, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+  if (ec != std::errc() || end != str.data() + str.size()) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+/// "g7a" or "g7e".
+inline std::optional<tdc2::TorpedoSpec> ParseTorpedoPreset(std::string_view str) {
+  if (str == "g7a") {
+    return tdc2::GetTorpedoPresetSpec(tdc2::TorpedoPreset::kG7a);
+  }
+  if (str == "g7e") {
+    return tdc2::GetTorpedoPresetSpec(tdc2::TorpedoPreset::kG7e);
+  }
+  return std::nullopt;
+}
+
+/// "geometry", "newton" or "siemens".
+inline std::optional<tdc2::ParallaxSolveMethod> ParseSolveMethod(std::string_view str) {
+  if (str == "geometry") {
+    return tdc2::ParallaxSolveMethod::kGeometry;
+  }
+  if (str == "newton") {
+    return tdc2::ParallaxSolveMethod::kNewton;
+  }
+  if (str == "siemens") {
+    return tdc2::ParallaxSolveMethod::kSiemens;
+  }
+  return std::nullopt;
+}
+
+} // namespace tool_options
@@ -0,0 +1,50 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+
+/// Lock-free single-producer, single-consumer handoff of the latest value.
+///
+/// The writer fills its slot and publishes it; the reader takes the latest published slot. Neither ever waits for the
+/// other: The third slot holds the latest published value between the two, and is swapped with the writer or the
+/// reader slot by a single atomic exchange. Values published in between reads are dropped.
+template <typename T>
+class TripleBuffer final {
+public:
+  /// Writer only: The slot to fill before `Publish`. Holds an older value, not necessarily the last one published.
+  T& GetWriteSlot() { return slots_[write_index_]; }
+
+  /// Writer only: Make the write slot the latest value.
+  void Publish() {
+    uint8_t const previous = middle_.exchange(write_index_ | kFreshBit, std::memory_order_acq_rel);
+    write_index_ = previous & kIndexMask;
+  }
+
+  /// Reader only: Take the latest value into the read slot if one was published since the last call.
+  ///
+  /// ## Returns
+  /// Whether the read slot changed.
+  bool Acquire() {
+    if ((middle_.load(std::memory_order_relaxed) & kFreshBit) == 0) {
+      return false;
+    }
+    uint8_t const previous = middle_.exchange(read_index_, std::memory_order_acq_rel);
+    read_index_ = previous & kIndexMask;
+    return true;
+  }
+
+  /// Reader only: The value taken by the last successful `Acquire`; value-initialized before that.
+  T const& GetReadSlot() const { return slots_[read_index_]; }
+
+private:
+  static constexpr uint8_t kIndexMask = 0x3;
+  static constexpr uint8_t kFreshBit = 0x4; // The middle slot was published and not acquired yet.
+
+  std::array<T, 3> slots_ {};
+  uint8_t write_index_ = 0;        // Writer only.
+  std::atomic<uint8_t> middle_ = 1;
+  uint8_t read_index_ = 2;         // Reader only.
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+// c++ headers ------------------------------------------
+#include <cmath>
+
+#include <type_traits>
+
+/// 2D vector of the solver, in meters unless noted otherwise.
+///
+/// A plain aggregate with the layout of `::Vector2`, so the solver does not depend on raylib. Operations evaluate the
+/// same expressions as their raymath counterparts, so results match the raylib types bit for bit.
+struct Vec2 final {
+  float x;
+  float y;
+
+  constexpr Vec2 operator+(Vec2 const& other) const { return Vec2 { x + other.x, y + other.y }; }
+  constexpr Vec2 operator-(Vec2 const& other) const { return Vec2 { x - other.x, y - other.y }; }
+  constexpr Vec2 operator*(float scalar) const { return Vec2 { x * scalar, y * scalar }; }
+  constexpr Vec2 operator/(float scalar) const { return Vec2 { x / scalar, y / scalar }; }
+  constexpr Vec2 operator-() const { return Vec2 { -x, -y }; }
+  constexpr Vec2& operator+=(Vec2 const& other) { x += other.x; y += other.y; return *this; }
+  constexpr Vec2& operator-=(Vec2 const& other) { x -= other.x; y -= other.y; return *this; }
+  constexpr bool operator==(Vec2 const& other) const = default;
+
+  friend constexpr Vec2 operator*(float scalar, Vec2 const& v) { return v * scalar; }
+
+  float Length() const { return std::sqrt(x * x + y * y); }
+
+  /// Rotate counterclockwise by `angle_rad` in a y-up frame.
+  Vec2 Rotate(float angle_rad) const {
+    float const cos_a = std::cos(angle_rad);
+    float const sin_a = std::sin(angle_rad);
+    return Vec2 { x * cos_a - y * sin_a, x * sin_a + y * cos_a };
+  }
+};
+static_assert(std::is_trivial_v<Vec2> && std::is_standard_layout_v<Vec2>);
+static_assert(sizeof(Vec2) == 2 * sizeof(float));
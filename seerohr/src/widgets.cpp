@@ -77,6 +77,42 @@ bool SliderFloatWithIdV(
   return ImGui::SliderFloat(label.c_str(), v, v_min, v_max, value_format, flags);
 }
 
+bool SliderAngleDeg(
+  char const* label,
+  Angle* angle,
+  float min_deg,
+  float max_deg,
+  char const* format
+) {
+  float deg = angle->ToDeg();
+  if (ImGui::SliderFloat(label, &deg, min_deg, max_deg, format)) {
+    *angle = Angle::FromDeg(deg);
+    return true;
+  }
+  return false;
+}
+
+bool SliderAngleDegWithId(
+  char const* str_id,
+  Angle* angle,
+  float min_deg,
+  float max_deg,
+  char const* value_format,
+  char const* label_format,
+  ...
+) {
+  va_list args;
+  va_start(args, label_format);
+
+  float deg = angle->ToDeg();
+  bool changed = SliderFloatWithIdV(str_id, &deg, min_deg, max_deg, value_format, ImGuiSliderFlags_None, label_format, args);
+  if (changed) {
+    *angle = Angle::FromDeg(deg);
+  }
+  va_end(args);
+  return changed;
+}
+
 namespace {
 
 ImVec2 operator+(const ImVec2& lhs, const ImVec2& rhs) {
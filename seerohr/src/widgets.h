@@ -3,6 +3,9 @@
 // external headers -------------------------------------
 #include "imgui.h"
 
+// project headers --------------------------------------
+#include "angle.h"
+
 /// Open a URL in the default browser.
 void OpenUrl(char const* url);
 
@@ -28,6 +31,26 @@ bool SliderFloatWithIdV(
   va_list args
 );
 
+/// `ImGui::SliderFloat` over `angle` in degrees.
+bool SliderAngleDeg(
+  char const* label,
+  Angle* angle,
+  float min_deg,
+  float max_deg,
+  char const* format = "%.3f"
+);
+
+/// `SliderFloatWithId` over `angle` in degrees.
+bool SliderAngleDegWithId(
+  char const* str_id,
+  Angle* angle,
+  float min_deg,
+  float max_deg,
+  char const* value_format,
+  char const* label_format,
+  ...
+);
+
 struct AoBDialStyle
 {
   ImU32 col_face      = IM_COL32(10,10,10,255);